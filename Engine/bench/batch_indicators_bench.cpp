@@ -0,0 +1,304 @@
+#include "BatchIndicators.hpp"
+#include "MultiSymbolRunner.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Cross-symbol batching: N scalar indicator sets vs one SoA batch per
+// indicator, then MultiSymbolRunner::run vs run_batched on synthetic
+// symbols. Batched values and per-symbol results must match exactly.
+//
+// Usage: BatchIndicatorsBench [lanes] [bars] [symbols] [symbol_bars]
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+double ms_since(clock_type::time_point start) {
+  return std::chrono::duration<double, std::milli>(clock_type::now() - start)
+      .count();
+}
+
+// Cross-sections [t][lane] of a random walk per lane.
+struct Panel {
+  size_t lanes = 0;
+  size_t bars = 0;
+  std::vector<double> high, low, close;
+
+  double at(const std::vector<double> &col, size_t t, size_t l) const {
+    return col[t * lanes + l];
+  }
+};
+
+Panel make_panel(size_t lanes, size_t bars, uint32_t seed) {
+  std::mt19937_64 rng(seed);
+  std::normal_distribution<double> ret(0.0, 0.0012);
+  std::normal_distribution<double> wick(0.0, 0.0005);
+
+  Panel p;
+  p.lanes = lanes;
+  p.bars = bars;
+  p.high.resize(lanes * bars);
+  p.low.resize(lanes * bars);
+  p.close.resize(lanes * bars);
+  std::vector<double> price(lanes);
+  for (size_t l = 0; l < lanes; ++l)
+    price[l] = 100.0 + l;
+  for (size_t t = 0; t < bars; ++t) {
+    for (size_t l = 0; l < lanes; ++l) {
+      double open = price[l];
+      double close = std::max(1.0, open * (1.0 + ret(rng)));
+      size_t i = t * lanes + l;
+      p.high[i] = std::max(open, close) * (1.0 + std::abs(wick(rng)));
+      p.low[i] = std::min(open, close) * (1.0 - std::abs(wick(rng)));
+      p.close[i] = close;
+      price[l] = close;
+    }
+  }
+  return p;
+}
+
+struct Outputs {
+  std::vector<double> ema, rsi, atr, zscore;
+  double ms = 0.0;
+};
+
+Outputs run_scalar(const Panel &p) {
+  Outputs out;
+  out.ema.resize(p.lanes);
+  out.rsi.resize(p.lanes);
+  out.atr.resize(p.lanes);
+  out.zscore.resize(p.lanes);
+  auto start = clock_type::now();
+  for (size_t l = 0; l < p.lanes; ++l) {
+    quant::ExponentialMovingAverage ema(26);
+    quant::RSI rsi(14);
+    quant::ATR atr(14);
+    quant::RollingStats stats(100);
+    for (size_t t = 0; t < p.bars; ++t) {
+      double c = p.at(p.close, t, l);
+      ema.update(c);
+      rsi.update(c);
+      atr.update(p.at(p.high, t, l), p.at(p.low, t, l), c);
+      stats.update(c);
+    }
+    out.ema[l] = ema.value();
+    out.rsi[l] = rsi.value();
+    out.atr[l] = atr.value();
+    out.zscore[l] = stats.zscore();
+  }
+  out.ms = ms_since(start);
+  return out;
+}
+
+Outputs run_batch(const Panel &p) {
+  Outputs out;
+  quant::BatchEMA ema(p.lanes, 26);
+  quant::BatchRSI rsi(p.lanes, 14);
+  quant::BatchATR atr(p.lanes, 14);
+  quant::BatchRollingStats stats(p.lanes, 100);
+  auto start = clock_type::now();
+  for (size_t t = 0; t < p.bars; ++t) {
+    const double *c = &p.close[t * p.lanes];
+    ema.update(c);
+    rsi.update(c);
+    atr.update(&p.high[t * p.lanes], &p.low[t * p.lanes], c);
+    stats.update(c);
+  }
+  out.ms = ms_since(start);
+  for (size_t l = 0; l < p.lanes; ++l) {
+    out.ema.push_back(ema.value(l));
+    out.rsi.push_back(rsi.value(l));
+    out.atr.push_back(atr.value(l));
+    out.zscore.push_back(stats.zscore(l));
+  }
+  return out;
+}
+
+size_t mismatches(const Outputs &a, const Outputs &b) {
+  size_t bad = 0;
+  for (size_t l = 0; l < a.ema.size(); ++l) {
+    bad += a.ema[l] != b.ema[l];
+    bad += a.rsi[l] != b.rsi[l];
+    bad += a.atr[l] != b.atr[l];
+    bad += a.zscore[l] != b.zscore[l];
+  }
+  return bad;
+}
+
+// Every indicator the default strategy stack registers, for N symbols:
+// N IndicatorRegistry instances vs one BatchIndicatorRegistry.
+template <typename Registry>
+void register_default_stack(Registry &registry) {
+  quant::StrategyParams params;
+  quant::BasicRegimeStrategy<Registry> regime(registry, params);
+  quant::BasicMomentumStrategy<Registry> momentum(registry, params);
+  quant::BasicMeanReversionStrategy<Registry> mean_reversion(registry, params);
+}
+
+double time_registries(const Panel &p, std::vector<double> &vol_out) {
+  std::vector<quant::IndicatorRegistry> registries(p.lanes);
+  quant::IndicatorHandle<quant::RollingStats> vol;
+  for (auto &r : registries) {
+    register_default_stack(r);
+    vol = r.rolling_stats(quant::IndicatorInput::LogReturn, 200);
+  }
+  auto start = clock_type::now();
+  for (size_t l = 0; l < p.lanes; ++l) {
+    for (size_t t = 0; t < p.bars; ++t) {
+      double c = p.at(p.close, t, l);
+      registries[l].update(quant::Bar(0, c, p.at(p.high, t, l),
+                                      p.at(p.low, t, l), c, 1000.0));
+    }
+  }
+  double ms = ms_since(start);
+  for (size_t l = 0; l < p.lanes; ++l)
+    vol_out.push_back(registries[l].get(vol).std_dev());
+  return ms;
+}
+
+double time_batch_registry(const Panel &p, std::vector<double> &vol_out) {
+  quant::BatchIndicatorRegistry registry(p.lanes);
+  quant::BatchRegistryLane lane = registry.lane(0); // Handles are shared
+  register_default_stack(lane);
+  auto vol = registry.rolling_stats(quant::IndicatorInput::LogReturn, 200);
+  std::vector<double> volume(p.lanes, 1000.0);
+  auto start = clock_type::now();
+  for (size_t t = 0; t < p.bars; ++t) {
+    size_t row = t * p.lanes;
+    registry.update(&p.high[row], &p.low[row], &p.close[row], volume.data());
+  }
+  double ms = ms_since(start);
+  for (size_t l = 0; l < p.lanes; ++l)
+    vol_out.push_back(registry.get(vol, l).std_dev());
+  return ms;
+}
+
+// Symbols on one minute grid. When ragged, every 7th symbol starts late and
+// skips bars, so the batched driver also sees sparse cross-sections.
+std::vector<quant::Bar> make_symbol(size_t n, size_t index, bool ragged) {
+  std::mt19937_64 rng(1000 + index);
+  std::normal_distribution<double> ret(0.0, 0.0012);
+  std::normal_distribution<double> wick(0.0, 0.0005);
+  std::uniform_real_distribution<double> vol(1000.0, 50000.0);
+  std::uniform_int_distribution<int> gap(0, 99);
+  ragged = ragged && index % 7 == 3;
+
+  std::vector<quant::Bar> bars;
+  bars.reserve(n);
+  double price = 50.0 + 10.0 * index;
+  int64_t ts = 1514778300 + (ragged ? 60 * 500 : 0);
+  for (size_t i = 0; i < n; ++i, ts += 60) {
+    if (ragged && gap(rng) < 5)
+      continue;
+    double open = price;
+    double close = std::max(1.0, open * (1.0 + ret(rng)));
+    double high = std::max(open, close) * (1.0 + std::abs(wick(rng)));
+    double low = std::min(open, close) * (1.0 - std::abs(wick(rng)));
+    bars.push_back({ts, open, high, low, close, vol(rng)});
+    price = close;
+  }
+  return bars;
+}
+
+bool same_result(const quant::BacktestResult &a,
+                 const quant::BacktestResult &b) {
+  if (a.bars_processed != b.bars_processed ||
+      a.trades.size() != b.trades.size() ||
+      a.report.final_equity != b.report.final_equity)
+    return false;
+  for (size_t i = 0; i < a.trades.size(); ++i) {
+    if (a.trades[i].entry_time != b.trades[i].entry_time ||
+        a.trades[i].exit_time != b.trades[i].exit_time ||
+        a.trades[i].pnl != b.trades[i].pnl)
+      return false;
+  }
+  return true;
+}
+
+// run vs run_batched on one thread; returns the number of differing symbols.
+size_t compare_engines(size_t symbols, size_t symbol_bars, bool ragged) {
+  auto market_data = std::make_shared<quant::MarketDataManager>();
+  std::vector<std::string> names;
+  for (size_t i = 0; i < symbols; ++i) {
+    names.push_back("SYN" + std::to_string(i));
+    market_data->add_bars(names.back(), make_symbol(symbol_bars, i, ragged));
+  }
+  quant::MultiSymbolRunner runner(market_data, names);
+  quant::MultiSymbolResult plain = runner.run(1);
+  quant::MultiSymbolResult batched = runner.run_batched(1);
+
+  size_t differing = 0;
+  for (size_t i = 0; i < symbols; ++i)
+    differing += !same_result(plain.per_symbol[i], batched.per_symbol[i]);
+
+  std::cout << "\n[BATCH] engine, " << symbols << " symbols"
+            << (ragged ? " (ragged)" : " (aligned)") << ", "
+            << plain.total_bars << " bars, 1 thread\n";
+  std::cout << std::setprecision(1) << "[BATCH] run         " << std::setw(9)
+            << plain.wall_ms << " ms " << std::setprecision(0)
+            << std::setw(12) << plain.bars_per_sec << " bars/sec\n";
+  std::cout << std::setprecision(1) << "[BATCH] run_batched " << std::setw(9)
+            << batched.wall_ms << " ms " << std::setprecision(0)
+            << std::setw(12) << batched.bars_per_sec << " bars/sec\n";
+  std::cout << "[BATCH] " << differing << " of " << symbols
+            << " symbols differ from run()\n";
+  return differing;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t lanes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+  size_t bars = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+  size_t symbols = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 64;
+  size_t symbol_bars = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 20000;
+
+  // 1. Indicator kernels: EMA(26), RSI(14), ATR(14), RollingStats(100)
+  Panel panel = make_panel(lanes, bars, 7);
+  Outputs scalar = run_scalar(panel);
+  Outputs batch = run_batch(panel);
+  double updates = static_cast<double>(lanes) * bars;
+
+  std::cout << std::fixed << "[BATCH] " << lanes << " lanes x " << bars
+            << " bars, EMA+RSI+ATR+RollingStats\n";
+  std::cout << std::setprecision(2) << "[BATCH] scalar  " << std::setw(9)
+            << scalar.ms << " ms " << std::setprecision(1) << std::setw(8)
+            << updates / scalar.ms / 1000.0 << " M lane-updates/s\n";
+  std::cout << std::setprecision(2) << "[BATCH] batched " << std::setw(9)
+            << batch.ms << " ms " << std::setprecision(1) << std::setw(8)
+            << updates / batch.ms / 1000.0 << " M lane-updates/s\n";
+  std::cout << std::setprecision(2) << "[BATCH] speedup " << std::setw(9)
+            << (batch.ms > 0 ? scalar.ms / batch.ms : 0.0) << "x, "
+            << mismatches(scalar, batch) << " mismatching values\n";
+
+  // 2. Registry: all indicators of the default strategy stack
+  std::vector<double> vol_scalar, vol_batch;
+  double reg_ms = time_registries(panel, vol_scalar);
+  double batch_reg_ms = time_batch_registry(panel, vol_batch);
+  size_t reg_bad = 0;
+  for (size_t l = 0; l < lanes; ++l)
+    reg_bad += vol_scalar[l] != vol_batch[l];
+
+  std::cout << "\n[BATCH] registry, default stack indicators\n";
+  std::cout << std::setprecision(2) << "[BATCH] " << lanes
+            << " x IndicatorRegistry " << std::setw(9) << reg_ms << " ms\n";
+  std::cout << "[BATCH] BatchIndicatorRegistry " << std::setw(9)
+            << batch_reg_ms << " ms (" << std::setprecision(2)
+            << (batch_reg_ms > 0 ? reg_ms / batch_reg_ms : 0.0) << "x), "
+            << reg_bad << " mismatching values\n";
+
+  // 3. Full engine over a synthetic universe
+  size_t differing = compare_engines(symbols, symbol_bars, false) +
+                     compare_engines(symbols, symbol_bars, true);
+
+  return mismatches(scalar, batch) == 0 && reg_bad == 0 && differing == 0
+             ? 0
+             : 1;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Bar.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+// Fixtures shared by the bench executables.
+namespace bench {
+
+/**
+ * @brief n synthetic 1-minute bars: a random walk from 500 with 0.12%
+ * per-bar moves, small wicks and uniform volume, starting at the NSE open.
+ * Same seed, same bars, so every bench (and every run) sees the same data.
+ */
+inline std::vector<quant::Bar> make_bars(size_t n, uint32_t seed) {
+  std::mt19937_64 rng(seed);
+  std::normal_distribution<double> ret(0.0, 0.0012);
+  std::normal_distribution<double> wick(0.0, 0.0005);
+  std::uniform_real_distribution<double> vol(1000.0, 50000.0);
+
+  std::vector<quant::Bar> bars;
+  bars.reserve(n);
+  double price = 500.0;
+  int64_t ts = 1514778300; // 2018-01-01 03:45 UTC (09:15 IST)
+  for (size_t i = 0; i < n; ++i) {
+    double open = price;
+    double close = std::max(1.0, open * (1.0 + ret(rng)));
+    double high = std::max(open, close) * (1.0 + std::abs(wick(rng)));
+    double low = std::min(open, close) * (1.0 - std::abs(wick(rng)));
+    bars.push_back({ts, open, high, low, close, vol(rng)});
+    price = close;
+    ts += 60;
+  }
+  return bars;
+}
+
+/**
+ * @brief A temp path "<stem>-<random hex>" that no other run uses, so two
+ * benches running at once never write over or remove each other's files.
+ */
+inline std::filesystem::path unique_temp_path(const std::string &stem) {
+  std::random_device device;
+  std::uniform_int_distribution<uint64_t> pick;
+  const auto dir = std::filesystem::temp_directory_path();
+  std::filesystem::path path;
+  do {
+    char suffix[17];
+    std::snprintf(suffix, sizeof(suffix), "%016llx",
+                  static_cast<unsigned long long>(pick(device)));
+    path = dir / (stem + "-" + suffix);
+  } while (std::filesystem::exists(path));
+  return path;
+}
+
+} // namespace bench
@@ -0,0 +1,153 @@
+#include "CircularBuffer.hpp"
+#include "Indicators.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rolling-window access pattern used by the indicators (push the new value,
+// read the oldest) for each CircularBuffer flavour, then whole indicators
+// built on each.
+//
+// Usage: CircularBufferBench [values] [repeats]
+namespace {
+
+constexpr size_t WINDOW = 100; // BB_PERIOD / MOMENTUM_PERIOD
+
+template <typename Fn> double best_ms(int repeats, Fn &&fn) {
+  double best = 0.0;
+  for (int r = 0; r < repeats; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    double ms =
+        std::chrono::duration<double, std::milli>(end - start).count();
+    if (r == 0 || ms < best)
+      best = ms;
+  }
+  return best;
+}
+
+template <typename Buffer>
+double window_sum(Buffer &buffer, const std::vector<double> &values,
+                  bool checked) {
+  double sum = 0.0;
+  for (double v : values) {
+    if (buffer.is_full())
+      sum -= checked ? buffer.get(WINDOW - 1) : buffer[WINDOW - 1];
+    buffer.push(v);
+    sum += v;
+  }
+  return sum;
+}
+
+template <typename Indicator>
+double run_indicator(const std::vector<double> &values) {
+  Indicator ind(static_cast<int>(WINDOW));
+  double acc = 0.0;
+  for (double v : values)
+    acc += ind.update(v);
+  return acc;
+}
+
+void report(const std::string &name, double ms, size_t n, double base_ms) {
+  std::cout << "[BUFFER] " << std::left << std::setw(42) << name << std::right
+            << std::fixed << std::setprecision(2) << std::setw(9) << ms
+            << " ms " << std::setprecision(1) << std::setw(8)
+            << (ms > 0 ? n / ms / 1000.0 : 0.0) << " M/s "
+            << std::setprecision(2) << std::setw(6)
+            << (ms > 0 ? base_ms / ms : 0.0) << "x\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+  int repeats = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+  std::mt19937_64 rng(7);
+  std::normal_distribution<double> dist(500.0, 5.0);
+  std::vector<double> values(n);
+  for (auto &v : values)
+    v = dist(rng);
+
+  volatile double sink = 0.0;
+  std::cout << "[BUFFER] " << n << " updates, window " << WINDOW
+            << ", best of " << repeats << "\n";
+
+  double base = best_ms(repeats, [&] {
+    quant::CircularBuffer<double> b(WINDOW);
+    sink = window_sum(b, values, true);
+  });
+  report("CircularBuffer<double> get()", base, n, base);
+
+  report("CircularBuffer<double> operator[]",
+         best_ms(repeats,
+                 [&] {
+                   quant::CircularBuffer<double> b(WINDOW);
+                   sink = window_sum(b, values, false);
+                 }),
+         n, base);
+  report("MaskedCircularBuffer<double>",
+         best_ms(repeats,
+                 [&] {
+                   quant::MaskedCircularBuffer<double> b(WINDOW);
+                   sink = window_sum(b, values, false);
+                 }),
+         n, base);
+  report("CircularBuffer<double, 100>",
+         best_ms(repeats,
+                 [&] {
+                   quant::CircularBuffer<double, WINDOW> b;
+                   sink = window_sum(b, values, false);
+                 }),
+         n, base);
+
+  using quant::BasicRollingStats;
+  using quant::BasicSimpleMovingAverage;
+  double sma_base = best_ms(repeats, [&] {
+    sink = run_indicator<
+        BasicSimpleMovingAverage<quant::CircularBuffer<double>>>(values);
+  });
+  report("SMA<CircularBuffer<double>>", sma_base, n, sma_base);
+  report("SMA<MaskedCircularBuffer<double>>",
+         best_ms(repeats,
+                 [&] {
+                   sink = run_indicator<BasicSimpleMovingAverage<
+                       quant::MaskedCircularBuffer<double>>>(values);
+                 }),
+         n, sma_base);
+  report("SMA<CircularBuffer<double, 100>>",
+         best_ms(repeats,
+                 [&] {
+                   sink = run_indicator<BasicSimpleMovingAverage<
+                       quant::CircularBuffer<double, WINDOW>>>(values);
+                 }),
+         n, sma_base);
+
+  double rs_base = best_ms(repeats, [&] {
+    sink = run_indicator<BasicRollingStats<quant::CircularBuffer<double>>>(
+        values);
+  });
+  report("RollingStats<CircularBuffer<double>>", rs_base, n, rs_base);
+  report("RollingStats<MaskedCircularBuffer>",
+         best_ms(repeats,
+                 [&] {
+                   sink = run_indicator<BasicRollingStats<
+                       quant::MaskedCircularBuffer<double>>>(values);
+                 }),
+         n, rs_base);
+  report("RollingStats<CircularBuffer<double, 100>>",
+         best_ms(repeats,
+                 [&] {
+                   sink = run_indicator<BasicRollingStats<
+                       quant::CircularBuffer<double, WINDOW>>>(values);
+                 }),
+         n, rs_base);
+
+  (void)sink;
+  return 0;
+}
@@ -0,0 +1,111 @@
+#include "Engine.hpp"
+#include "EquityTracker.hpp"
+#include "bench_data.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Per-bar cost of EquityTracker (stats only, and stats + columnar curve),
+// checked against a two-pass reference, plus full-engine bars/sec with the
+// curve recorded vs not.
+//
+// Usage: EquityTrackerBench [bars] [repeats]
+namespace {
+
+template <typename F> double best_ms(int repeats, F &&fn) {
+  double best = 1e300;
+  for (int r = 0; r < repeats; ++r) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto t1 = std::chrono::steady_clock::now();
+    best = std::min(best,
+                    std::chrono::duration<double, std::milli>(t1 - t0).count());
+  }
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+  int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  // Synthetic equity path: random walk around 100k
+  std::mt19937_64 rng(7);
+  std::normal_distribution<double> step(0.0, 0.0004);
+  std::vector<double> equity(n);
+  double e = 100000.0;
+  for (auto &x : equity) {
+    e *= 1.0 + step(rng);
+    x = e;
+  }
+
+  quant::EquityTracker stats;
+  double stats_ms = best_ms(repeats, [&] {
+    stats.reset(100000.0);
+    for (double x : equity)
+      stats.update(x);
+  });
+
+  quant::EquityTracker tracked;
+  quant::EquityCurve curve;
+  curve.reserve(n);
+  double curve_ms = best_ms(repeats, [&] {
+    curve.clear();
+    tracked.reset(100000.0);
+    for (size_t i = 0; i < n; ++i)
+      tracked.update(static_cast<int64_t>(i), equity[i], curve);
+  });
+
+  // Two-pass reference
+  double prev = 100000.0, peak = prev, mdd = 0.0, sum = 0.0;
+  std::vector<double> rets(n);
+  for (size_t i = 0; i < n; ++i) {
+    rets[i] = equity[i] / prev - 1.0;
+    prev = equity[i];
+    peak = std::max(peak, equity[i]);
+    mdd = std::max(mdd, (peak - equity[i]) / peak);
+    sum += rets[i];
+  }
+  double mean = sum / n, ss = 0.0, down = 0.0;
+  for (double r : rets) {
+    ss += (r - mean) * (r - mean);
+    down += r < 0 ? r * r : 0.0;
+  }
+  double ref_sharpe =
+      mean / std::sqrt(ss / (n - 1)) * std::sqrt(quant::BARS_PER_YEAR_1MIN);
+  double ref_sortino =
+      mean / std::sqrt(down / n) * std::sqrt(quant::BARS_PER_YEAR_1MIN);
+
+  std::cout << "EquityTracker over " << n << " bars (best of " << repeats
+            << ")\n"
+            << std::fixed << std::setprecision(2)
+            << "  stats only      " << stats_ms * 1e6 / n << " ns/bar\n"
+            << "  stats + curve   " << curve_ms * 1e6 / n << " ns/bar\n"
+            << std::scientific << std::setprecision(2)
+            << "  |sharpe - ref|  " << std::abs(stats.sharpe() - ref_sharpe)
+            << "\n  |sortino - ref| " << std::abs(stats.sortino() - ref_sortino)
+            << "\n  |max dd - ref|  " << std::abs(stats.max_drawdown() - mdd)
+            << "\n\n";
+
+  // Full engine: the tracker always runs; the curve is optional
+  auto bars = bench::make_bars(std::min<size_t>(n, 2000000), 42);
+  quant::Engine engine(nullptr);
+  double plain_ms = best_ms(repeats, [&] { engine.run_backtest(bars); });
+  engine.set_record_equity(true);
+  double rec_ms = best_ms(repeats, [&] { engine.run_backtest(bars); });
+
+  std::cout << std::fixed << std::setprecision(0) << "Engine over "
+            << bars.size() << " bars\n"
+            << "  tracker only    " << bars.size() / plain_ms * 1000.0
+            << " bars/sec\n"
+            << "  + equity curve  " << bars.size() / rec_ms * 1000.0
+            << " bars/sec (" << std::setprecision(2)
+            << (rec_ms - plain_ms) * 1e6 / bars.size() << " ns/bar)\n";
+  return 0;
+}
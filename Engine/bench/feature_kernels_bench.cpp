@@ -0,0 +1,113 @@
+#include "FeatureKernels.hpp"
+#include "features.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Times each batch feature at every SIMD level this CPU supports and
+// reports the max relative deviation from the scalar kernels.
+//
+// Usage: FeatureKernelsBench [rows] [repeats]
+namespace {
+
+using Feature = std::function<std::vector<double>()>;
+
+double max_rel_diff(const std::vector<double> &a,
+                    const std::vector<double> &ref) {
+  double worst = 0.0;
+  for (size_t i = 0; i < ref.size(); ++i) {
+    if (std::isnan(ref[i]) != std::isnan(a[i]))
+      return INFINITY;
+    if (std::isnan(ref[i]))
+      continue;
+    double denom = std::max(std::abs(ref[i]), 1e-12);
+    worst = std::max(worst, std::abs(a[i] - ref[i]) / denom);
+  }
+  return worst;
+}
+
+double best_ms(const Feature &fn, int repeats, std::vector<double> &out) {
+  double best = 0.0;
+  for (int r = 0; r < repeats; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    out = fn();
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    if (r == 0 || ms < best)
+      best = ms;
+  }
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+  int repeats = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+  std::mt19937_64 rng(3);
+  std::normal_distribution<double> ret(0.0, 0.0012);
+  std::normal_distribution<double> wick(0.0, 0.0005);
+  std::vector<double> high(n), low(n), close(n);
+  double price = 500.0;
+  for (size_t i = 0; i < n; ++i) {
+    double open = price;
+    price *= 1.0 + ret(rng);
+    close[i] = price;
+    high[i] = std::max(open, price) * (1.0 + std::abs(wick(rng)));
+    low[i] = std::min(open, price) * (1.0 - std::abs(wick(rng)));
+  }
+
+  const std::vector<std::pair<std::string, Feature>> features = {
+      {"sma(100)", [&] { return quant::sma(close, 100); }},
+      {"momentum(20)", [&] { return quant::momentum(close, 20); }},
+      {"rsi(14)", [&] { return quant::rsi(close, 14); }},
+      {"atr(14)", [&] { return quant::atr(high, low, close, 14); }},
+      {"rolling_std(20)", [&] { return quant::rolling_std(close, 20); }},
+      {"zscore(20)", [&] { return quant::zscore(close, 20); }},
+  };
+
+  std::vector<quant::SimdLevel> levels = {quant::SimdLevel::Scalar};
+  if (quant::detected_simd_level() >= quant::SimdLevel::AVX2)
+    levels.push_back(quant::SimdLevel::AVX2);
+  if (quant::detected_simd_level() >= quant::SimdLevel::AVX512)
+    levels.push_back(quant::SimdLevel::AVX512);
+
+  std::cout << "[KERNELS] " << n << " rows, best of " << repeats
+            << ", detected " << quant::simd_level_name(
+                                    quant::detected_simd_level())
+            << "\n[KERNELS] " << std::left << std::setw(17) << "feature"
+            << std::setw(8) << "level" << std::right << std::setw(10) << "ms"
+            << std::setw(10) << "Mrows/s" << std::setw(9) << "speedup"
+            << std::setw(12) << "max rel" << "\n";
+
+  for (const auto &[name, fn] : features) {
+    std::vector<double> ref, out;
+    double base_ms = 0.0;
+    for (quant::SimdLevel level : levels) {
+      quant::set_simd_level(level);
+      double ms = best_ms(fn, repeats, out);
+      if (level == quant::SimdLevel::Scalar) {
+        base_ms = ms;
+        ref = out;
+      }
+      std::cout << "[KERNELS] " << std::left << std::setw(17) << name
+                << std::setw(8) << quant::simd_level_name(level) << std::right
+                << std::fixed << std::setprecision(2) << std::setw(10) << ms
+                << std::setprecision(1) << std::setw(10)
+                << (ms > 0 ? n / ms / 1000.0 : 0.0) << std::setprecision(2)
+                << std::setw(8) << (ms > 0 ? base_ms / ms : 0.0) << "x"
+                << std::scientific << std::setprecision(1) << std::setw(12)
+                << max_rel_diff(out, ref) << std::fixed << "\n";
+    }
+  }
+  quant::set_simd_level(quant::detected_simd_level());
+  return 0;
+}
@@ -0,0 +1,179 @@
+#include "Engine.hpp"
+#include "EventJournal.hpp"
+#include "bench_data.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+// Event journal: run time with and without the journal (same trades
+// either way), then random state_at() queries against one sequential
+// replay: every queried state must equal the replayed one bit for bit,
+// every Bar record must satisfy cash + position * close == equity, and the
+// journal's trade count and final equity must be the engine's. Repeated on
+// a copy without the index (recovered by scanning).
+//
+// Usage: JournalBench [bars] [snapshot_every] [queries]
+namespace {
+
+template <typename F> double time_ms(F &&fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  fn();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+bool same_state(const quant::JournalState &a, const quant::JournalState &b) {
+  return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+struct Check {
+  bool states = true;  // state_at == sequential replay
+  bool marks = true;   // cash + position * close == equity per bar
+  size_t queries = 0;
+  double query_ms = 0.0;
+  double replay_ms = 0.0;
+};
+
+// Queries `bars` (sorted) with state_at and against one sequential pass.
+Check check_reader(const quant::JournalReader &reader,
+                   const std::vector<uint32_t> &bars) {
+  Check check;
+  std::vector<quant::JournalState> queried(bars.size());
+  check.query_ms = time_ms([&] {
+    for (size_t i = 0; i < bars.size(); ++i)
+      queried[i] = *reader.state_at(bars[i]);
+  });
+
+  std::vector<quant::JournalState> replayed;
+  replayed.reserve(bars.size());
+  check.replay_ms = time_ms([&] {
+    quant::JournalState state = reader.initial_state();
+    size_t next = 0;
+    reader.events(0, reader.bars() - 1, [&](const quant::JournalRecord &r) {
+      state.apply(r);
+      if (r.type != quant::JournalEvent::Bar)
+        return;
+      check.marks &= state.mark() == state.equity && state.position == r.c;
+      while (next < bars.size() && bars[next] == r.bar) {
+        replayed.push_back(state);
+        ++next;
+      }
+    });
+  });
+
+  check.queries = bars.size();
+  check.states = replayed.size() == queried.size();
+  for (size_t i = 0; check.states && i < queried.size(); ++i)
+    check.states = same_state(queried[i], replayed[i]);
+  return check;
+}
+
+void print_check(const char *name, const Check &c) {
+  std::cout << "  " << std::left << std::setw(18) << name << std::right
+            << std::fixed << std::setprecision(3) << std::setw(12)
+            << c.query_ms / c.queries << std::setprecision(1) << std::setw(14)
+            << c.replay_ms << std::setw(12) << (c.states ? "yes" : "NO")
+            << std::setw(12) << (c.marks ? "yes" : "NO") << "\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 300000;
+  quant::JournalConfig config;
+  if (argc > 2)
+    config.snapshot_every =
+        static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10));
+  size_t queries = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 200;
+
+  auto bars = bench::make_bars(n, 42);
+  std::span<const quant::Bar> series(bars);
+  const auto stem = bench::unique_temp_path("journal_bench").string();
+  const std::string path = stem + ".qj";
+  const std::string unindexed = stem + "_noindex.qj";
+
+  // Run overhead (best of 3 each)
+  quant::Engine engine(nullptr);
+  quant::BacktestResult plain, journalled;
+  double plain_ms = 1e300, journal_ms = 1e300;
+  for (int rep = 0; rep < 3; ++rep) {
+    engine.set_journal({});
+    plain_ms = std::min(plain_ms,
+                        time_ms([&] { plain = engine.run_backtest(series); }));
+    engine.set_journal(path, config);
+    journal_ms = std::min(
+        journal_ms, time_ms([&] { journalled = engine.run_backtest(series); }));
+  }
+  const bool same_run =
+      plain.trades.size() == journalled.trades.size() &&
+      plain.report.final_equity == journalled.report.final_equity;
+
+  quant::JournalReader reader(path);
+  std::cout << n << " bars, " << plain.trades.size() << " trades; journal "
+            << reader.records() << " records (" << std::fixed
+            << std::setprecision(1)
+            << std::filesystem::file_size(path) / (1024.0 * 1024.0) << " MB), "
+            << reader.snapshots() << " snapshots every "
+            << config.snapshot_every << " bars\n"
+            << "  run, no journal   " << std::setw(10) << plain_ms << " ms\n"
+            << "  run, journal      " << std::setw(10) << journal_ms
+            << " ms  (" << std::showpos << (journal_ms / plain_ms - 1.0) * 100
+            << std::noshowpos << "%), same trades: "
+            << (same_run ? "yes" : "NO") << "\n";
+
+  // Random bars, sorted for the sequential pass
+  std::mt19937_64 rng(7);
+  std::uniform_int_distribution<uint32_t> pick(0, reader.bars() - 1);
+  std::vector<uint32_t> targets(queries);
+  for (auto &b : targets)
+    b = pick(rng);
+  targets.push_back(reader.bars() - 1);
+  std::sort(targets.begin(), targets.end());
+
+  // A copy cut before the index, as after an interrupted run
+  {
+    std::ifstream in(path, std::ios::binary);
+    std::ofstream out(unindexed, std::ios::binary);
+    std::vector<char> bytes(sizeof(quant::JournalHeader) +
+                            reader.records() * sizeof(quant::JournalRecord));
+    in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    out.write(bytes.data(), in.gcount());
+  }
+  quant::JournalReader scanned(unindexed);
+
+  std::cout << "\n" << targets.size() << " state_at() queries\n"
+            << std::left << std::setw(20) << "  file" << std::right
+            << std::setw(12) << "ms/query" << std::setw(14) << "replay ms"
+            << std::setw(12) << "states eq" << std::setw(12) << "marks eq"
+            << "\n";
+  Check indexed = check_reader(reader, targets);
+  Check recovered = check_reader(scanned, targets);
+  print_check("indexed", indexed);
+  print_check("scanned (no index)", recovered);
+
+  const quant::JournalState last = *reader.state_at(reader.bars() - 1);
+  const bool totals = last.trades == plain.trades.size() &&
+                      last.equity == plain.report.final_equity &&
+                      reader.bars() == n && !scanned.has_trailer() &&
+                      scanned.snapshots() == reader.snapshots();
+  std::cout << "\nJournal trades " << last.trades << ", final equity "
+            << std::setprecision(2) << last.equity << " (engine "
+            << plain.trades.size() << ", " << plain.report.final_equity
+            << "): " << (totals ? "match" : "MISMATCH") << "\n";
+
+  const bool ok = same_run && totals && indexed.states && indexed.marks &&
+                  recovered.states && recovered.marks;
+  std::cout << "All checks: " << (ok ? "pass" : "FAIL") << "\n";
+  std::filesystem::remove(path);
+  std::filesystem::remove(unindexed);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+#include "LiveStream.hpp"
+#include "bench_data.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Streams bars through LiveStream (feed thread -> SPSC queue -> Engine::on_bar)
+// and reports publish -> signal latency percentiles. Trades go to a fixed
+// 1024-record TradeLog spilling to a temp file; in a QUANT_COUNT_ALLOCATIONS
+// build the engine also fails any on_bar that allocates, and the bench
+// reports the engine thread's allocations while streaming. The streamed
+// result is checked against Engine::run_backtest over the same bars.
+//
+// Usage: LiveStreamBench [bars] [interval_us]
+//   burst mode publishes every bar as fast as the queue accepts it;
+//   paced mode publishes one bar every interval_us (default 50).
+
+namespace {
+
+struct StreamRun {
+  quant::BacktestResult result;
+  quant::LatencyHistogram latency;
+  double wall_ms = 0.0;
+  size_t allocs = 0;
+  bool spilled = false;
+};
+
+StreamRun stream(const std::vector<quant::Bar> &bars, int interval_us) {
+  auto spill_path = bench::unique_temp_path("live_stream_bench.trades");
+  quant::Engine engine(nullptr);
+  engine.set_trade_log(1024, spill_path.string());
+  engine.set_fail_on_allocation(true);
+  quant::LiveStream live(engine);
+  engine.start_stream(); // stack and trade log built before the first bar
+
+  auto start = std::chrono::steady_clock::now();
+  std::thread feed([&] {
+    auto next = std::chrono::steady_clock::now();
+    for (const auto &bar : bars) {
+      if (interval_us > 0) {
+        next += std::chrono::microseconds(interval_us);
+        std::this_thread::sleep_until(next);
+      }
+      live.publish(bar);
+    }
+    live.close();
+  });
+
+  quant::AllocationScope allocations;
+  live.run();
+  size_t allocs = allocations.count();
+  feed.join();
+  auto end = std::chrono::steady_clock::now();
+
+  StreamRun r;
+  r.allocs = allocs;
+  r.wall_ms = std::chrono::duration<double, std::milli>(end - start).count();
+  r.latency = live.latency();
+  r.result = engine.finish_stream();
+  r.spilled = r.result.trades.size() > 1024;
+  std::filesystem::remove(spill_path);
+  return r;
+}
+
+void print_run(const char *label, const StreamRun &r) {
+  const auto &h = r.latency;
+  std::cout << std::left << std::setw(8) << label << std::right << std::fixed
+            << std::setprecision(0) << std::setw(10) << h.count()
+            << std::setw(10) << h.percentile(0.50) << std::setw(10)
+            << h.percentile(0.99) << std::setw(10) << h.percentile(0.999)
+            << std::setw(12) << h.max() << std::setw(14)
+            << h.count() / r.wall_ms * 1000.0 << std::setw(10);
+  if (quant::ALLOCATION_COUNTING)
+    std::cout << r.allocs << "\n";
+  else
+    std::cout << "n/a" << "\n";
+}
+
+bool same_result(const quant::BacktestResult &a,
+                 const quant::BacktestResult &b) {
+  return a.trades.size() == b.trades.size() &&
+         a.report.final_equity == b.report.final_equity &&
+         std::equal(a.trades.begin(), a.trades.end(), b.trades.begin(),
+                    [](const quant::Trade &x, const quant::Trade &y) {
+                      return x.entry_time == y.entry_time &&
+                             x.exit_time == y.exit_time && x.pnl == y.pnl;
+                    });
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 500000;
+  int interval_us = argc > 2 ? std::atoi(argv[2]) : 50;
+  size_t paced_n = std::min<size_t>(n, 20000);
+
+  auto bars = bench::make_bars(n, 42);
+  std::vector<quant::Bar> paced_bars(bars.begin(), bars.begin() + paced_n);
+
+  quant::Engine reference(nullptr);
+  auto expected = reference.run_backtest(bars);
+  auto expected_paced = reference.run_backtest(paced_bars);
+
+  std::cout << "Live stream: " << n << " bars burst, " << paced_n
+            << " bars paced at " << interval_us << " us\n"
+            << "Latency = publish -> signal, ns\n\n"
+            << std::left << std::setw(8) << "mode" << std::right
+            << std::setw(10) << "bars" << std::setw(10) << "p50"
+            << std::setw(10) << "p99" << std::setw(10) << "p999"
+            << std::setw(12) << "max" << std::setw(14) << "bars/sec"
+            << std::setw(10) << "allocs" << "\n";
+
+  StreamRun burst = stream(bars, 0);
+  print_run("burst", burst);
+  StreamRun paced = stream(paced_bars, interval_us);
+  print_run("paced", paced);
+
+  bool ok = same_result(burst.result, expected) &&
+            same_result(paced.result, expected_paced);
+  std::cout << "\nTrades (burst): " << burst.result.trades.size()
+            << (burst.spilled ? " (spilled past 1024)" : "")
+            << "\nMatches run_backtest: " << (ok ? "yes" : "NO") << "\n";
+  if (!quant::ALLOCATION_COUNTING)
+    std::cout << "allocs: build with -DQUANT_COUNT_ALLOCATIONS=ON\n";
+  return ok ? 0 : 1;
+}
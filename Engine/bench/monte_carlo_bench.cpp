@@ -0,0 +1,148 @@
+#include "Engine.hpp"
+#include "MonteCarlo.hpp"
+#include "bench_data.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <span>
+#include <vector>
+
+// Monte Carlo robustness over one synthetic run's trades and per-bar
+// returns: paths/sec for each resampling on 1 and N threads, against a
+// sequential std::mt19937_64 + std::shuffle reference for the trade
+// shuffle. Checks: Philox4x32-10 known-answer vectors, identical outputs
+// for any thread count, and shuffled paths ending at the run's own return.
+//
+// Usage: MonteCarloBench [bars] [paths] [threads]
+namespace {
+
+template <typename F> double time_ms(F &&fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  fn();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// Random123 known-answer tests for Philox4x32-10
+bool philox_known_answers() {
+  using C = quant::Philox4x32::Counter;
+  using K = quant::Philox4x32::Key;
+  const C zero = quant::Philox4x32::generate({0, 0, 0, 0}, K{0, 0});
+  const C ones = quant::Philox4x32::generate(
+      {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu},
+      K{0xffffffffu, 0xffffffffu});
+  const C pi = quant::Philox4x32::generate(
+      {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u},
+      K{0xa4093822u, 0x299f31d0u});
+  return zero == C{0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u} &&
+         ones == C{0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu} &&
+         pi == C{0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u};
+}
+
+// Sequential reference: one generator, std::shuffle per path.
+double reference_shuffle_ms(const std::vector<double> &pnl, size_t paths,
+                            double capital) {
+  std::mt19937_64 rng(42);
+  std::vector<double> deck(pnl);
+  volatile double sink = 0.0; // Keeps the loop from being optimized out
+  return time_ms([&] {
+    for (size_t p = 0; p < paths; ++p) {
+      std::shuffle(deck.begin(), deck.end(), rng);
+      double equity = capital, peak = capital, dd = 0.0;
+      for (double x : deck) {
+        equity += x;
+        peak = std::max(peak, equity);
+        dd = std::max(dd, (peak - equity) / peak);
+      }
+      sink = sink + dd;
+    }
+  });
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+  size_t paths = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+  unsigned threads = argc > 3 ? static_cast<unsigned>(std::strtoul(
+                                    argv[3], nullptr, 10))
+                              : quant::ThreadPool::default_threads();
+  threads = std::max(2u, threads); // Compared against 1 thread
+
+  auto bars = bench::make_bars(n, 42);
+  quant::Engine engine(nullptr);
+  engine.set_record_equity(true);
+  quant::BacktestResult run =
+      engine.run_backtest(std::span<const quant::Bar>(bars));
+  const double capital = engine.initial_capital();
+  const std::vector<double> pnl = quant::trade_pnls(run.trades);
+  const std::vector<double> returns =
+      quant::bar_returns(run.equity_curve.equity());
+  const double run_return = run.report.final_equity / capital - 1.0;
+
+  quant::MonteCarloConfig config;
+  config.paths = paths;
+  quant::MonteCarlo trade_mc(config);
+  config.block_length = 375; // One NSE session of 1-min bars
+  config.path_length = std::min<size_t>(returns.size(), 20000);
+  quant::MonteCarlo return_mc(config);
+
+  std::cout << n << " bars, " << pnl.size() << " trades, " << paths
+            << " paths; return bootstrap " << config.path_length
+            << " bars per path in blocks of " << config.block_length << "\n"
+            << std::left << std::setw(20) << "  method" << std::right
+            << std::setw(12) << "1 thread" << std::setw(12)
+            << (std::to_string(threads) + " threads") << std::setw(14)
+            << "paths/sec" << std::setw(12) << "identical" << "\n";
+
+  bool ok = philox_known_answers();
+  struct Case {
+    quant::Resampling method;
+    const quant::MonteCarlo *mc;
+    const std::vector<double> *input;
+  };
+  const Case cases[] = {{quant::Resampling::TradeShuffle, &trade_mc, &pnl},
+                        {quant::Resampling::TradeBootstrap, &trade_mc, &pnl},
+                        {quant::Resampling::ReturnBootstrap, &return_mc,
+                         &returns}};
+  std::vector<quant::MonteCarloResult> results;
+  for (const Case &c : cases) {
+    quant::MonteCarloResult one = c.mc->run(c.method, *c.input, capital, 1);
+    quant::MonteCarloResult many =
+        c.mc->run(c.method, *c.input, capital, threads);
+    const bool identical = one.final_return == many.final_return &&
+                           one.max_drawdown == many.max_drawdown;
+    ok &= identical;
+    std::cout << "  " << std::left << std::setw(18)
+              << quant::resampling_name(c.method) << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << one.wall_ms
+              << "ms" << std::setw(10) << many.wall_ms << "ms"
+              << std::setprecision(0) << std::setw(14) << many.paths_per_sec
+              << std::setw(12) << (identical ? "yes" : "NO") << "\n";
+    results.push_back(std::move(many));
+  }
+  std::cout << "  " << std::left << std::setw(18) << "std::shuffle ref"
+            << std::right << std::setprecision(1) << std::setw(10)
+            << reference_shuffle_ms(pnl, paths, capital) << "ms\n";
+
+  // A shuffle only reorders: every path ends at the run's return
+  double max_gap = 0.0;
+  for (double r : results[0].final_return)
+    max_gap = std::max(max_gap, std::abs(r - run_return));
+  const bool same_total = max_gap <= 1e-9;
+  ok &= same_total;
+
+  for (const auto &r : results)
+    quant::MonteCarlo::print(r);
+  std::cout << "\nRun: return " << std::setprecision(2) << run_return * 100
+            << "%, max DD " << run.report.max_drawdown_pct
+            << "%; shuffled paths end at the run's return: "
+            << (same_total ? "yes" : "NO") << "\nPhilox known answers: "
+            << (philox_known_answers() ? "pass" : "FAIL")
+            << "\nAll checks: " << (ok ? "pass" : "FAIL") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#include "Engine.hpp"
+#include "OrderBook.hpp"
+#include "bench_data.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Per-bar cost of OrderBook::match() with N limit / stop orders resting
+// away from the market (none trade: the bar only has to find that out), and
+// with a ladder the price walks through (orders fill and are replaced).
+// Then full-engine bars/sec under each fill policy.
+//
+// Usage: OrderBookBench [bars] [repeats]
+namespace {
+
+template <typename F> double best_ms(int repeats, F &&fn) {
+  double best = 1e300;
+  for (int r = 0; r < repeats; ++r) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto t1 = std::chrono::steady_clock::now();
+    best = std::min(best,
+                    std::chrono::duration<double, std::milli>(t1 - t0).count());
+  }
+  return best;
+}
+
+// Limits and stops on both sides: those triggered by a fall at least
+// `distance` (fraction of price) below `low`, the others as far above `high`.
+void rest_orders(quant::OrderBook &book, size_t n, double low, double high,
+                 double distance, uint32_t seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> offset(distance, 2.0 * distance);
+  for (size_t i = 0; i < n; ++i) {
+    int side = (i & 1) ? 1 : -1;
+    auto type = (i & 2) ? quant::OrderType::Limit : quant::OrderType::Stop;
+    bool below = (type == quant::OrderType::Limit) == (side == 1);
+    double level =
+        below ? low * (1.0 - offset(rng)) : high * (1.0 + offset(rng));
+    book.submit(type, side, 1.0, level, 0);
+  }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+  auto bars = bench::make_bars(n, 42);
+  double lo = bars[0].low, hi = bars[0].high;
+  for (const auto &b : bars) {
+    lo = std::min(lo, b.low);
+    hi = std::max(hi, b.high);
+  }
+
+  quant::FillConfig touch;
+  touch.policy = quant::FillPolicy::Touch;
+
+  std::cout << "OrderBook::match over " << n << " bars (best of " << repeats
+            << ")\n\n"
+            << std::setw(10) << "resting" << std::setw(16) << "away ns/bar"
+            << std::setw(18) << "ladder ns/bar" << std::setw(14)
+            << "ladder fills" << "\n";
+
+  for (size_t resting : {0, 10, 1000, 10000}) {
+    // Away: every level outside the series' whole range
+    quant::OrderBook away(resting);
+    rest_orders(away, resting, lo, hi, 0.05, 1);
+    size_t away_fills = 0;
+    double away_ms = best_ms(repeats, [&] {
+      for (const auto &bar : bars)
+        away.match(bar, touch, [&](const quant::Fill &) { ++away_fills; });
+    });
+
+    // Ladder: buy and sell limits in 0.1% steps around the first open; each
+    // fill is re-quoted on the other side one step away
+    size_t ladder_fills = 0;
+    double ladder_ms = 0.0;
+    if (resting > 0) {
+      ladder_ms = best_ms(repeats, [&] {
+        quant::OrderBook ladder(resting + 16);
+        for (size_t i = 0; i < resting / 2; ++i) {
+          double step = 0.001 * static_cast<double>(i / 2 + 1);
+          ladder.submit(quant::OrderType::Limit, 1, 1.0,
+                        bars[0].open * (1.0 - step), 0);
+          ladder.submit(quant::OrderType::Limit, -1, 1.0,
+                        bars[0].open * (1.0 + step), 0);
+        }
+        std::vector<quant::Fill> filled;
+        filled.reserve(resting);
+        ladder_fills = 0;
+        for (const auto &bar : bars) {
+          filled.clear();
+          ladder.match(bar, touch,
+                       [&](const quant::Fill &f) { filled.push_back(f); });
+          ladder_fills += filled.size();
+          for (const auto &f : filled) // Re-quote the other side
+            ladder.submit(quant::OrderType::Limit, -f.side, 1.0,
+                          f.price * (1.0 + 0.001 * f.side), bar.timestamp);
+        }
+      });
+    }
+
+    std::cout << std::setw(10) << resting << std::fixed << std::setprecision(2)
+              << std::setw(16) << away_ms * 1e6 / n << std::setw(18)
+              << ladder_ms * 1e6 / n << std::setw(14) << ladder_fills
+              << (away_fills ? "  (away orders filled!)" : "") << "\n";
+  }
+
+  // Full engine: market entries / exits under each policy
+  struct Policy {
+    const char *name;
+    quant::FillConfig config;
+  };
+  quant::FillConfig vwap;
+  vwap.policy = quant::FillPolicy::Vwap;
+  quant::FillConfig costs = touch;
+  costs.slippage.bps = 0.5;
+  costs.fees.rate = 0.00002;
+  costs.max_participation = 0.1;
+
+  auto engine_bars = std::vector<quant::Bar>(
+      bars.begin(), bars.begin() + std::min<size_t>(n, 1000000));
+  std::cout << "\nEngine over " << engine_bars.size() << " bars\n";
+  for (const Policy &p : {Policy{"open (default)", quant::FillConfig{}},
+                          Policy{"vwap", vwap}, Policy{"touch", touch},
+                          Policy{"touch + costs", costs}}) {
+    quant::Engine engine(nullptr);
+    engine.set_fill_config(p.config);
+    quant::BacktestResult result;
+    double ms =
+        best_ms(repeats, [&] { result = engine.run_backtest(engine_bars); });
+    std::cout << "  " << std::left << std::setw(16) << p.name << std::right
+              << std::setprecision(0) << std::setw(10)
+              << engine_bars.size() / ms * 1000.0 << " bars/sec  "
+              << std::setw(7) << result.trades.size() << " trades  equity "
+              << std::setprecision(2) << result.report.final_equity << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,78 @@
+#include "Engine.hpp"
+#include "bench_data.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Compares the compile-time composed strategy stack against the same
+// strategies driven through the virtual Strategy interface. The two modes
+// alternate run by run, so drift in clock speed or cache state hits both
+// alike, and the speedup is the median of the per-pair ratios.
+//
+// Usage: PipelineBench [bars] [repeats]
+namespace {
+
+struct Timing {
+  double best_ms = 0.0;
+  quant::BacktestResult result;
+};
+
+void time_run(quant::Engine &engine, const std::vector<quant::Bar> &bars,
+              Timing &t) {
+  quant::BacktestResult result = engine.run_backtest(bars);
+  if (t.best_ms == 0.0 || result.elapsed_ms < t.best_ms)
+    t.best_ms = result.elapsed_ms;
+  t.result = std::move(result);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+  int repeats = argc > 2 ? std::atoi(argv[2]) : 9;
+  repeats = std::max(1, repeats);
+
+  std::vector<quant::Bar> bars = bench::make_bars(n, 42);
+
+  quant::Engine static_engine(nullptr);
+  static_engine.set_dispatch_mode(quant::Engine::DispatchMode::Static);
+  quant::Engine virtual_engine(nullptr);
+  virtual_engine.set_dispatch_mode(quant::Engine::DispatchMode::Virtual);
+
+  Timing stat, virt;
+  std::vector<double> ratios;
+  for (int r = 0; r < repeats; ++r) {
+    time_run(static_engine, bars, stat);
+    time_run(virtual_engine, bars, virt);
+    if (stat.result.elapsed_ms > 0)
+      ratios.push_back(virt.result.elapsed_ms / stat.result.elapsed_ms);
+  }
+
+  auto bars_per_sec = [n](double ms) { return ms > 0 ? n / ms * 1000.0 : 0.0; };
+
+  std::cout << "[PIPELINE] " << n << " bars, best of " << repeats << "\n"
+            << std::fixed << std::setprecision(2);
+  std::cout << "[PIPELINE] static  " << std::setw(10) << stat.best_ms
+            << " ms " << std::setprecision(0) << std::setw(12)
+            << bars_per_sec(stat.best_ms) << " bars/sec\n";
+  std::cout << std::setprecision(2) << "[PIPELINE] virtual " << std::setw(10)
+            << virt.best_ms << " ms " << std::setprecision(0) << std::setw(12)
+            << bars_per_sec(virt.best_ms) << " bars/sec\n";
+  if (!ratios.empty()) {
+    std::sort(ratios.begin(), ratios.end());
+    std::cout << std::setprecision(2) << "[PIPELINE] speedup "
+              << ratios[ratios.size() / 2] << "x median of " << ratios.size()
+              << " pairs (" << ratios.front() << "x - " << ratios.back()
+              << "x)\n";
+  }
+
+  // Both paths must produce the same backtest.
+  bool same = stat.result.report.total_trades ==
+                  virt.result.report.total_trades &&
+              stat.result.report.final_equity == virt.result.report.final_equity;
+  std::cout << "[PIPELINE] results " << (same ? "match" : "DIFFER") << " ("
+            << stat.result.report.total_trades << " trades)\n";
+  return same ? 0 : 1;
+}
@@ -0,0 +1,428 @@
+#include "AllocationCounter.hpp"
+#include "Engine.hpp"
+#include "FeatureKernels.hpp"
+#include "MarketDataManager.hpp"
+#include "MultiSymbolRunner.hpp"
+#include "features.hpp"
+#include "bench_data.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Release benchmark suite: every streaming indicator, the batch feature
+// functions, CSV / .qbar loading and full-engine bars/sec, on synthetic data
+// from fixed seeds. Prints one JSON document (stdout or --out) meant to be
+// kept per release and diffed; --compare flags cases whose ns/item grew by
+// more than --threshold percent against an earlier one and exits 1.
+//
+// Usage: QuantEngineBench [--bars N] [--repeats R] [--symbols S]
+//                         [--filter substring] [--out file.json]
+//                         [--compare baseline.json] [--threshold pct]
+namespace {
+
+constexpr int SCHEMA_VERSION = 1;
+
+struct Options {
+  size_t bars = 1000000;
+  int repeats = 5;
+  size_t symbols = 8;
+  std::string filter;
+  std::string out;
+  std::string compare;
+  double threshold = 10.0;
+};
+
+struct Case {
+  std::string name;  // "group/case", stable across releases
+  std::string unit;  // What one item is: update, row or bar
+  size_t items = 0;  // Per repeat
+  double best_ms = 0.0;
+  double median_ms = 0.0;
+
+  double ns_per_item() const { return items ? best_ms * 1e6 / items : 0.0; }
+  double items_per_sec() const {
+    return best_ms > 0 ? items / best_ms * 1000.0 : 0.0;
+  }
+};
+
+// ---------------------------------------------------------
+// Synthetic data (same generator as the other benches)
+// ---------------------------------------------------------
+void write_csv(const std::string &path, const std::vector<quant::Bar> &bars) {
+  std::ofstream out(path);
+  out << "timestamp,open,high,low,close,volume\n";
+  char row[160];
+  for (const auto &b : bars) {
+    int len = std::snprintf(row, sizeof(row), "%lld,%.2f,%.2f,%.2f,%.2f,%.0f\n",
+                            static_cast<long long>(b.timestamp), b.open,
+                            b.high, b.low, b.close, b.volume);
+    out.write(row, len);
+  }
+}
+
+// Keeps results observable so the timed loops are not optimized away.
+volatile double g_sink = 0.0;
+
+// Swallows the loaders' per-file prints while they are timed.
+class NullBuffer : public std::streambuf {
+protected:
+  int overflow(int c) override { return c; }
+  std::streamsize xsputn(const char *, std::streamsize n) override {
+    return n;
+  }
+};
+
+class Suite {
+public:
+  explicit Suite(const Options &options) : options_(options) {}
+
+  bool wants(const std::string &name) const {
+    return options_.filter.empty() ||
+           name.find(options_.filter) != std::string::npos;
+  }
+
+  // Time fn() `repeats` times after one untimed run; keeps the best and the
+  // median. The warm-up also settles the allocator (glibc adapts its mmap
+  // threshold to the first large frees), so a case times the same whether
+  // it runs alone (--filter) or after the rest of the suite.
+  template <typename F>
+  void run(const std::string &name, const std::string &unit, size_t items,
+           F &&fn) {
+    if (!wants(name))
+      return;
+    fn();
+    std::vector<double> ms;
+    for (int r = 0; r < options_.repeats; ++r) {
+      auto t0 = std::chrono::steady_clock::now();
+      fn();
+      auto t1 = std::chrono::steady_clock::now();
+      ms.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    std::sort(ms.begin(), ms.end());
+    Case c{name, unit, items, ms.front(), ms[ms.size() / 2]};
+    std::cerr << "  " << std::left << std::setw(36) << name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(12)
+              << c.ns_per_item() << " ns/" << unit << "\n";
+    cases_.push_back(c);
+  }
+
+  const std::vector<Case> &cases() const { return cases_; }
+
+private:
+  const Options &options_;
+  std::vector<Case> cases_;
+};
+
+// ---------------------------------------------------------
+// Streaming indicators (Indicators.hpp): ns per update()
+// ---------------------------------------------------------
+template <typename T, typename... Args>
+void bench_indicator(Suite &suite, const std::string &name,
+                     const std::vector<double> &close, Args... args) {
+  suite.run("indicator/" + name, "update", close.size(), [&] {
+    T indicator(args...);
+    for (double x : close)
+      indicator.update(x);
+    g_sink = g_sink + indicator.value();
+  });
+}
+
+void bench_indicators(Suite &suite, const std::vector<quant::Bar> &bars,
+                      const quant::BarSeries &series) {
+  std::vector<double> close(series.close().begin(), series.close().end());
+  bench_indicator<quant::SimpleMovingAverage>(suite, "sma_20", close, 20);
+  bench_indicator<quant::ExponentialMovingAverage>(suite, "ema_20", close, 20);
+  bench_indicator<quant::RSI>(suite, "rsi_14", close, 14);
+  bench_indicator<quant::RateOfChange>(suite, "roc_100", close, 100);
+  bench_indicator<quant::RollingStats>(suite, "rolling_stats_20", close, 20);
+  suite.run("indicator/bollinger_20_2", "update", close.size(), [&] {
+    quant::BollingerBands bb(20, 2.0);
+    for (double x : close)
+      bb.update(x);
+    g_sink = g_sink + bb.value().middle;
+  });
+  suite.run("indicator/atr_14", "update", bars.size(), [&] {
+    quant::ATR atr(14);
+    for (const auto &b : bars)
+      atr.update(b.high, b.low, b.close);
+    g_sink = g_sink + atr.value();
+  });
+  // The default strategy stack's full indicator set, deduplicated
+  suite.run("indicator/registry_default_stack", "bar", bars.size(), [&] {
+    quant::StaticStrategyStack<> stack(quant::StrategyParams{});
+    for (const auto &b : bars)
+      stack.registry().update(b);
+    g_sink = g_sink + stack.registry().log_return();
+  });
+}
+
+// ---------------------------------------------------------
+// Batch features (features.hpp): ns per row, into preallocated output
+// ---------------------------------------------------------
+void bench_features(Suite &suite, const quant::BarSeries &series) {
+  const size_t n = series.size();
+  std::vector<double> out(n);
+  auto close = series.close();
+  auto row_case = [&](const std::string &name, auto &&fn) {
+    suite.run("features/" + name, "row", n, [&] {
+      fn();
+      g_sink = g_sink + out[n - 1];
+    });
+  };
+  row_case("sma_20", [&] { quant::sma(close, 20, out); });
+  row_case("ema_20", [&] { quant::ema(close, 20, out); });
+  row_case("rsi_14", [&] { quant::rsi(close, 14, out); });
+  row_case("atr_14", [&] {
+    quant::atr(series.high(), series.low(), close, 14, out);
+  });
+  row_case("momentum_10", [&] { quant::momentum(close, 10, out); });
+  row_case("rolling_std_20", [&] { quant::rolling_std(close, 20, out); });
+  row_case("zscore_20", [&] { quant::zscore(close, 20, out); });
+  suite.run("features/compute_features", "row", n, [&] {
+    quant::FeatureFrame frame = quant::compute_features(series);
+    g_sink = g_sink + frame.column(0)[n - 1];
+  });
+}
+
+// ---------------------------------------------------------
+// Loading: CSV parse and .qbar map, ns per row
+// ---------------------------------------------------------
+void bench_load(Suite &suite, const std::vector<quant::Bar> &bars,
+                const Options &options) {
+  const auto dir = bench::unique_temp_path("quant_engine_bench");
+  std::filesystem::create_directories(dir);
+  const std::string csv = (dir / "BENCH.csv").string();
+  write_csv(csv, bars);
+
+  // One universe of smaller files for the parallel loader
+  const size_t per_symbol = std::max<size_t>(1, bars.size() / options.symbols);
+  const auto universe = dir / "universe";
+  std::filesystem::create_directories(universe);
+  for (size_t s = 0; s < options.symbols; ++s)
+    write_csv((universe / ("SYM" + std::to_string(s) + ".csv")).string(),
+              bench::make_bars(per_symbol, 100 + static_cast<uint32_t>(s)));
+
+  NullBuffer null;
+  std::streambuf *saved = std::cout.rdbuf(&null);
+
+  suite.run("load/csv_parse", "row", bars.size(), [&] {
+    quant::MarketDataManager data;
+    data.set_cache_enabled(false);
+    data.load_csv("BENCH", csv);
+    g_sink = g_sink + static_cast<double>(data.get_bars("BENCH").size());
+  });
+
+  quant::MarketDataManager().load_csv("BENCH", csv); // Writes BENCH.csv.qbar
+  suite.run("load/qbar_map", "row", bars.size(), [&] {
+    quant::MarketDataManager data;
+    data.load_csv("BENCH", csv);
+    g_sink = g_sink + static_cast<double>(data.get_bars("BENCH").size());
+  });
+
+  const unsigned threads = quant::ThreadPool::default_threads();
+  suite.run("load/directory_csv_parallel", "row", per_symbol * options.symbols,
+            [&] {
+              quant::MarketDataManager data;
+              data.set_cache_enabled(false);
+              auto report = data.load_directory(universe.string(), threads);
+              g_sink = g_sink + static_cast<double>(report.loaded);
+            });
+
+  std::cout.rdbuf(saved);
+  std::filesystem::remove_all(dir);
+}
+
+// ---------------------------------------------------------
+// Full engine: bars/sec through strategies, risk and execution
+// ---------------------------------------------------------
+void bench_engine(Suite &suite, const std::vector<quant::Bar> &bars,
+                  const Options &options) {
+  suite.run("engine/backtest_static", "bar", bars.size(), [&] {
+    quant::Engine engine(nullptr);
+    g_sink = g_sink + engine.run_backtest(bars).report.final_equity;
+  });
+  suite.run("engine/backtest_virtual", "bar", bars.size(), [&] {
+    quant::Engine engine(nullptr);
+    engine.set_dispatch_mode(quant::Engine::DispatchMode::Virtual);
+    g_sink = g_sink + engine.run_backtest(bars).report.final_equity;
+  });
+  suite.run("engine/streaming_on_bar", "bar", bars.size(), [&] {
+    quant::Engine engine(nullptr);
+    engine.start_stream(bars.size());
+    for (const auto &b : bars)
+      engine.on_bar(b);
+    g_sink = g_sink + engine.finish_stream().report.final_equity;
+  });
+
+  // Universe on one thread, so the number does not depend on core count
+  auto market_data = std::make_shared<quant::MarketDataManager>();
+  std::vector<std::string> symbols;
+  const size_t per_symbol = std::max<size_t>(1, bars.size() / options.symbols);
+  for (size_t s = 0; s < options.symbols; ++s) {
+    symbols.push_back("SYM" + std::to_string(s));
+    market_data->add_bars(
+        symbols.back(),
+        bench::make_bars(per_symbol, 100 + static_cast<uint32_t>(s)));
+  }
+  quant::MultiSymbolRunner runner(market_data, symbols);
+  const size_t universe_bars = per_symbol * options.symbols;
+  suite.run("engine/multi_symbol_1_thread", "bar", universe_bars, [&] {
+    g_sink = g_sink + static_cast<double>(runner.run(1).total_bars);
+  });
+  // Fewer than MIN_BATCH_LANES symbols make run_batched time run()
+  suite.run("engine/multi_symbol_batched_1_thread", "bar", universe_bars, [&] {
+    g_sink = g_sink + static_cast<double>(runner.run_batched(1).total_bars);
+  });
+}
+
+// ---------------------------------------------------------
+// JSON
+// ---------------------------------------------------------
+std::string json_escape(const std::string &s) {
+  std::string out;
+  for (char c : s) {
+    if (c == '"' || c == '\\')
+      out += '\\';
+    out += c;
+  }
+  return out;
+}
+
+void write_json(std::ostream &out, const Options &options,
+                const std::vector<Case> &cases) {
+  out << std::setprecision(6) << std::defaultfloat;
+  out << "{\n"
+      << "  \"schema\": " << SCHEMA_VERSION << ",\n"
+      << "  \"config\": {\"bars\": " << options.bars
+      << ", \"repeats\": " << options.repeats
+      << ", \"symbols\": " << options.symbols << ", \"seed\": 42},\n"
+      << "  \"build\": {\"compiler\": \"" << json_escape(__VERSION__)
+      << "\", \"cplusplus\": " << __cplusplus << ", \"ndebug\": "
+#ifdef NDEBUG
+      << "true"
+#else
+      << "false"
+#endif
+      << ", \"count_allocations\": "
+      << (quant::ALLOCATION_COUNTING ? "true" : "false")
+      << ", \"simd\": \"" << quant::simd_level_name(quant::simd_level())
+      << "\"},\n"
+      << "  \"host\": {\"hardware_threads\": "
+      << std::thread::hardware_concurrency() << "},\n"
+      << "  \"results\": [\n";
+  for (size_t i = 0; i < cases.size(); ++i) {
+    const Case &c = cases[i];
+    out << "    {\"name\": \"" << c.name << "\", \"unit\": \"" << c.unit
+        << "\", \"items\": " << c.items << ", \"best_ms\": " << c.best_ms
+        << ", \"median_ms\": " << c.median_ms
+        << ", \"ns_per_item\": " << c.ns_per_item()
+        << ", \"items_per_sec\": " << c.items_per_sec() << "}"
+        << (i + 1 < cases.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n}\n";
+}
+
+// name -> ns_per_item from a file this program wrote (one result per line).
+std::map<std::string, double> read_baseline(const std::string &path) {
+  std::map<std::string, double> baseline;
+  std::ifstream in(path);
+  std::string line;
+  const std::string name_key = "\"name\": \"";
+  const std::string ns_key = "\"ns_per_item\": ";
+  while (std::getline(in, line)) {
+    size_t name = line.find(name_key);
+    size_t ns = line.find(ns_key);
+    if (name == std::string::npos || ns == std::string::npos)
+      continue;
+    name += name_key.size();
+    baseline[line.substr(name, line.find('"', name) - name)] =
+        std::strtod(line.c_str() + ns + ns_key.size(), nullptr);
+  }
+  return baseline;
+}
+
+// Returns the number of regressions beyond the threshold.
+int compare(const std::vector<Case> &cases, const Options &options) {
+  auto baseline = read_baseline(options.compare);
+  if (baseline.empty()) {
+    std::cerr << "No results read from " << options.compare << "\n";
+    return 1;
+  }
+  int regressions = 0;
+  std::cerr << "\nAgainst " << options.compare << " (threshold "
+            << options.threshold << "%)\n";
+  for (const Case &c : cases) {
+    auto it = baseline.find(c.name);
+    if (it == baseline.end() || it->second <= 0)
+      continue;
+    double change = (c.ns_per_item() / it->second - 1.0) * 100.0;
+    bool regressed = change > options.threshold;
+    regressions += regressed;
+    std::cerr << "  " << std::left << std::setw(36) << c.name << std::right
+              << std::showpos << std::fixed << std::setprecision(1)
+              << std::setw(8) << change << "%" << std::noshowpos
+              << (regressed ? "  REGRESSION" : "") << "\n";
+  }
+  return regressions;
+}
+
+Options parse_options(int argc, char *argv[]) {
+  Options o;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--bars" && has_value)
+      o.bars = std::strtoull(argv[++i], nullptr, 10);
+    else if (arg == "--repeats" && has_value)
+      o.repeats = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "--symbols" && has_value)
+      o.symbols = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+    else if (arg == "--filter" && has_value)
+      o.filter = argv[++i];
+    else if (arg == "--out" && has_value)
+      o.out = argv[++i];
+    else if (arg == "--compare" && has_value)
+      o.compare = argv[++i];
+    else if (arg == "--threshold" && has_value)
+      o.threshold = std::strtod(argv[++i], nullptr);
+    else
+      std::cerr << "Ignoring argument " << arg << "\n";
+  }
+  o.bars = std::max<size_t>(o.bars, 1000);
+  return o;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const Options options = parse_options(argc, argv);
+  const auto bars = bench::make_bars(options.bars, 42);
+  const auto series = quant::BarSeries::from_bars(bars);
+
+  std::cerr << "QuantEngineBench: " << options.bars << " bars, best of "
+            << options.repeats << "\n";
+  Suite suite(options);
+  bench_indicators(suite, bars, series);
+  bench_features(suite, series);
+  bench_load(suite, bars, options);
+  bench_engine(suite, bars, options);
+
+  if (options.out.empty()) {
+    write_json(std::cout, options, suite.cases());
+  } else {
+    std::ofstream out(options.out);
+    write_json(out, options, suite.cases());
+    std::cerr << "Wrote " << options.out << "\n";
+  }
+  return options.compare.empty() ? 0 : (compare(suite.cases(), options) > 0);
+}
@@ -0,0 +1,142 @@
+#include "Indicators.hpp"
+#include "features.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+// O(n) Welford rolling_std / zscore / BollingerBands vs the O(n*period)
+// two-pass reference, with the max deviation between them. Every variance
+// must be within REL_BOUND of the reference's plus a few ulps of value^2, the
+// resolution a running variance has: a window whose std is tiny next to its
+// values can't be matched relatively (BollingerBands loses about an ulp of
+// the value in upper - middle as well). Exits nonzero on a breach.
+//
+// Usage: RollingMomentsBench [values] [period]
+namespace {
+
+// Exact reference: mean then squared deviations, per window.
+std::vector<double> reference_std(const std::vector<double> &v, int period) {
+  std::vector<double> out(v.size(), std::nan(""));
+  for (size_t i = period - 1; i < v.size(); ++i) {
+    double mean = 0.0;
+    for (int j = 0; j < period; ++j)
+      mean += v[i - j];
+    mean /= period;
+    double m2 = 0.0;
+    for (int j = 0; j < period; ++j)
+      m2 += (v[i - j] - mean) * (v[i - j] - mean);
+    out[i] = std::sqrt(m2 / period);
+  }
+  return out;
+}
+
+constexpr double REL_BOUND = 1e-9;
+constexpr double ULPS = 64.0;
+
+double max_rel_error(const std::vector<double> &a,
+                     const std::vector<double> &ref) {
+  double worst = 0.0;
+  for (size_t i = 0; i < ref.size(); ++i) {
+    if (std::isnan(ref[i]))
+      continue;
+    double denom = std::max(std::abs(ref[i]), 1e-300);
+    worst = std::max(worst, std::abs(a[i] - ref[i]) / denom);
+  }
+  return worst;
+}
+
+// |a^2 - ref^2| <= REL_BOUND * ref^2 + ULPS * eps * value^2 at every point.
+bool within_bound(const std::vector<double> &a, const std::vector<double> &ref,
+                  const std::vector<double> &v) {
+  const double eps = std::numeric_limits<double>::epsilon();
+  for (size_t i = 0; i < ref.size(); ++i) {
+    if (std::isnan(ref[i]))
+      continue;
+    const double var = ref[i] * ref[i];
+    const double bound = REL_BOUND * var + ULPS * eps * v[i] * v[i];
+    if (!(std::abs(a[i] * a[i] - var) <= bound))
+      return false;
+  }
+  return true;
+}
+
+template <typename Fn> double time_ms(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Prints timings and errors; returns false if an error is out of bound.
+bool run_case(const std::string &label, const std::vector<double> &v,
+              int period) {
+  std::vector<double> ref, fast, z;
+  std::vector<double> bb_std(v.size(), std::nan(""));
+
+  double ref_ms = time_ms([&] { ref = reference_std(v, period); });
+  double std_ms = time_ms([&] { fast = quant::rolling_std(v, period); });
+  double z_ms = time_ms([&] { z = quant::zscore(v, period); });
+  double bb_ms = time_ms([&] {
+    quant::BollingerBands bb(period, 1.0);
+    for (size_t i = 0; i < v.size(); ++i) {
+      quant::BBResult r = bb.update(v[i]);
+      if (bb.is_ready())
+        bb_std[i] = r.upper - r.middle; // mult 1 => std dev
+    }
+  });
+
+  const bool std_ok = within_bound(fast, ref, v);
+  const bool bb_ok = within_bound(bb_std, ref, v);
+  std::cout << "[MOMENTS] " << label << "\n"
+            << std::fixed << std::setprecision(2)
+            << "[MOMENTS]   two-pass reference " << std::setw(10) << ref_ms
+            << " ms\n"
+            << "[MOMENTS]   rolling_std        " << std::setw(10) << std_ms
+            << " ms  max rel err " << std::scientific << std::setprecision(2)
+            << max_rel_error(fast, ref) << (std_ok ? "" : "  OUT OF BOUND")
+            << "\n"
+            << std::fixed << "[MOMENTS]   zscore             " << std::setw(10)
+            << z_ms << " ms\n"
+            << "[MOMENTS]   BollingerBands     " << std::setw(10) << bb_ms
+            << " ms  max rel err " << std::scientific
+            << max_rel_error(bb_std, ref) << (bb_ok ? "" : "  OUT OF BOUND")
+            << std::fixed << "\n";
+  return std_ok && bb_ok;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  int period = argc > 2 ? std::max(2, std::atoi(argv[2])) : 100;
+
+  std::mt19937_64 rng(11);
+  std::normal_distribution<double> ret(0.0, 0.0012);
+
+  // Price-like random walk
+  std::vector<double> prices(n);
+  double p = 500.0;
+  for (auto &x : prices) {
+    p *= 1.0 + ret(rng);
+    x = p;
+  }
+
+  // Large offset, tiny variance: where sum / sum-of-squares breaks down
+  std::vector<double> offset(n);
+  std::normal_distribution<double> noise(0.0, 0.01);
+  for (auto &x : offset)
+    x = 1e7 + noise(rng);
+
+  std::cout << "[MOMENTS] " << n << " values, period " << period << "\n";
+  bool ok = run_case("price random walk", prices, period);
+  ok &= run_case("1e7 offset, sigma 0.01", offset, period);
+  std::cout << "[MOMENTS] All checks: " << (ok ? "pass" : "FAIL") << "\n";
+  return ok ? 0 : 1;
+}
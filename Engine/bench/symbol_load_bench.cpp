@@ -0,0 +1,156 @@
+#include "MarketDataManager.hpp"
+#include "bench_data.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Bulk loading of a synthetic universe (one CSV per symbol in a temp
+// directory): load_directory() wall time per thread count with caches off
+// (every file parsed), and once more from .qbar caches. Every thread count
+// must load the same bars. Then lookup cost by name vs by SymbolId.
+//
+// Usage: SymbolLoadBench [symbols] [bars] [max_threads]
+namespace {
+
+template <typename F> double time_ms(F &&fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  fn();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+void write_symbol(const std::filesystem::path &path, size_t n, uint32_t seed) {
+  std::mt19937_64 rng(seed);
+  std::normal_distribution<double> ret(0.0, 0.0012);
+  std::normal_distribution<double> wick(0.0, 0.0005);
+  std::uniform_real_distribution<double> vol(1000.0, 50000.0);
+
+  std::ofstream out(path);
+  out << "timestamp,open,high,low,close,volume\n";
+  double price = 100.0 + seed % 900;
+  int64_t ts = 1514778300; // 2018-01-01 03:45 UTC (09:15 IST)
+  char row[160];
+  for (size_t i = 0; i < n; ++i) {
+    double open = price;
+    double close = std::max(1.0, open * (1.0 + ret(rng)));
+    double high = std::max(open, close) * (1.0 + std::abs(wick(rng)));
+    double low = std::min(open, close) * (1.0 - std::abs(wick(rng)));
+    int len = std::snprintf(row, sizeof(row), "%lld,%.2f,%.2f,%.2f,%.2f,%.0f\n",
+                            static_cast<long long>(ts), open, high, low, close,
+                            vol(rng));
+    out.write(row, len);
+    price = close;
+    ts += 60;
+  }
+}
+
+bool same_store(const quant::MarketDataManager &a,
+                const quant::MarketDataManager &b) {
+  if (a.symbol_count() != b.symbol_count())
+    return false;
+  for (quant::SymbolId id = 0; id < a.symbol_count(); ++id) {
+    const auto &x = a.get_bars(id);
+    const auto &y = b.get_bars(id);
+    if (a.symbol_name(id) != b.symbol_name(id) || x.size() != y.size() ||
+        !std::equal(x.begin(), x.end(), y.begin(),
+                    [](const quant::Bar &p, const quant::Bar &q) {
+                      return p.timestamp == q.timestamp && p.close == q.close &&
+                             p.volume == q.volume;
+                    }))
+      return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t symbols = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 500;
+  size_t bars = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+  unsigned max_threads =
+      argc > 3 ? static_cast<unsigned>(std::atoi(argv[3]))
+               : std::max(1u, std::thread::hardware_concurrency());
+
+  const auto dir = bench::unique_temp_path("quant_symbol_load_bench");
+  std::filesystem::create_directories(dir);
+  for (size_t i = 0; i < symbols; ++i) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "SYM%04zu.csv", i);
+    write_symbol(dir / name, bars, static_cast<uint32_t>(i));
+  }
+
+  struct Row {
+    unsigned threads;
+    quant::LoadReport report;
+  };
+  std::vector<Row> rows;
+  quant::MarketDataManager reference;
+  reference.set_cache_enabled(false);
+  rows.push_back({1, reference.load_directory(dir.string(), 1)});
+
+  bool ok = rows[0].report.loaded == symbols;
+  for (unsigned t = 2; t <= max_threads; t *= 2) {
+    quant::MarketDataManager data;
+    data.set_cache_enabled(false);
+    rows.push_back({t, data.load_directory(dir.string(), t)});
+    ok &= same_store(reference, data);
+  }
+
+  // Write the caches, then load from them on every thread
+  quant::MarketDataManager().load_directory(dir.string(), max_threads);
+  quant::MarketDataManager cached;
+  rows.push_back({max_threads, cached.load_directory(dir.string(), max_threads)});
+  ok &= same_store(reference, cached) && rows.back().report.from_cache == symbols;
+
+  std::cout << "\nload_directory: " << symbols << " symbols x " << bars
+            << " bars (" << std::fixed << std::setprecision(1)
+            << rows[0].report.bytes / (1024.0 * 1024.0) << " MB)\n\n"
+            << std::setw(10) << "threads" << std::setw(12) << "ms"
+            << std::setw(12) << "MB/s" << std::setw(10) << "speedup"
+            << "\n";
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const auto &r = rows[i].report;
+    bool from_cache = i + 1 == rows.size();
+    std::cout << std::setw(10) << rows[i].threads << std::setw(12)
+              << r.wall_ms << std::setw(12) << r.mb_per_sec << std::setw(9)
+              << std::setprecision(2) << rows[0].report.wall_ms / r.wall_ms
+              << "x" << std::setprecision(1)
+              << (from_cache ? "  (.qbar caches)" : "") << "\n";
+  }
+
+  // Resolve every symbol once per round, by name and by id
+  const size_t rounds = 2000;
+  std::vector<std::string> names;
+  for (quant::SymbolId id = 0; id < reference.symbol_count(); ++id)
+    names.push_back(reference.symbol_name(id));
+  size_t sink = 0;
+  double by_name = time_ms([&] {
+    for (size_t r = 0; r < rounds; ++r)
+      for (const auto &name : names)
+        sink += reference.get_bars(name).size();
+  });
+  double by_id = time_ms([&] {
+    for (size_t r = 0; r < rounds; ++r)
+      for (quant::SymbolId id = 0; id < reference.symbol_count(); ++id)
+        sink += reference.get_bars(id).size();
+  });
+  const double lookups = static_cast<double>(rounds * names.size());
+  std::cout << "\nget_bars by name " << std::setprecision(2)
+            << by_name * 1e6 / lookups << " ns, by SymbolId "
+            << by_id * 1e6 / lookups << " ns (checksum " << sink << ")\n"
+            << "Same bars on every thread count: " << (ok ? "yes" : "NO")
+            << "\n";
+
+  std::filesystem::remove_all(dir);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+#include "WalkForward.hpp"
+#include "bench_data.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Walk-forward over one synthetic series: the scheduler (one snapshot pass,
+// windows in parallel) against replaying every window's history from bar 0
+// on a fresh stack, which is what a window needs for the same indicator
+// state without snapshots. Results must match bit for bit.
+//
+// Usage: WalkForwardBench [bars] [train] [test] [threads]
+namespace {
+
+template <typename F> double time_ms(F &&fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  fn();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+bool same_result(const quant::BacktestResult &a,
+                 const quant::BacktestResult &b) {
+  return a.trades.size() == b.trades.size() &&
+         a.report.final_equity == b.report.final_equity &&
+         std::equal(a.trades.begin(), a.trades.end(), b.trades.begin(),
+                    [](const quant::Trade &x, const quant::Trade &y) {
+                      return x.entry_time == y.entry_time &&
+                             x.exit_time == y.exit_time && x.pnl == y.pnl;
+                    });
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+  quant::WalkForwardConfig config;
+  config.train_bars = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50000;
+  config.test_bars = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 25000;
+  unsigned threads = argc > 4 ? static_cast<unsigned>(std::atoi(argv[4]))
+                              : quant::ThreadPool::default_threads();
+
+  auto bars = bench::make_bars(n, 42);
+  std::span<const quant::Bar> series(bars);
+  quant::WalkForward walk(series, config);
+  const auto windows = walk.windows();
+
+  quant::WalkForwardReport one, many;
+  double one_ms = time_ms([&] { one = walk.run({}, 1); });
+  double many_ms = time_ms([&] { many = walk.run({}, threads); });
+
+  // Reference: replay [0, train_begin) into a fresh stack per window
+  std::vector<quant::WalkForwardResult> replay(windows.size());
+  double replay_ms = time_ms([&] {
+    for (size_t w = 0; w < windows.size(); ++w) {
+      const auto &win = windows[w];
+      quant::StaticStrategyStack<> stack(quant::StrategyParams{});
+      for (size_t i = 0; i < win.train_begin; ++i)
+        stack.on_bar(bars[i]);
+      quant::Engine engine(nullptr);
+      replay[w].train = engine.run_backtest(
+          series.subspan(win.train_begin, win.test_begin - win.train_begin),
+          stack);
+      replay[w].test = engine.run_backtest(
+          series.subspan(win.test_begin, win.test_end - win.test_begin),
+          stack);
+    }
+  });
+
+  bool ok = true;
+  for (size_t w = 0; w < windows.size(); ++w) {
+    ok &= same_result(one.windows[w].train, replay[w].train) &&
+          same_result(one.windows[w].test, replay[w].test) &&
+          same_result(many.windows[w].test, replay[w].test);
+  }
+
+  std::cout << "Walk-forward: " << n << " bars, train " << config.train_bars
+            << " / test " << config.test_bars << ", " << windows.size()
+            << " windows\n\n"
+            << std::fixed << std::setprecision(1) << "  replay from bar 0      "
+            << std::setw(10) << replay_ms << " ms\n"
+            << "  snapshots, 1 thread    " << std::setw(10) << one_ms << " ms ("
+            << replay_ms / one_ms << "x)\n"
+            << "  snapshots, " << std::left << std::setw(12)
+            << (std::to_string(threads) + " threads") << std::right
+            << std::setw(10) << many_ms << " ms (" << replay_ms / many_ms
+            << "x)\n"
+            << "\nOut-of-sample: " << many.combined_test.total_trades
+            << " trades, return " << std::setprecision(2)
+            << many.combined_test.total_return_pct << "%\n"
+            << "Matches replay: " << (ok ? "yes" : "NO") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+#include "Engine.hpp"
+#include "ParameterSweep.hpp"
+#include "Warmup.hpp"
+#include "bench_data.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <vector>
+
+// Lazy warm-up: first each indicator's seed() against update() over the
+// same history, then short windows late in the series evaluated with the
+// planner (seeded, and replay-only) against a full replay from bar 0, and
+// a windowed parameter sweep both ways.
+//
+// Usage: WarmupBench [bars] [window] [windows]
+namespace {
+
+template <typename F> double time_ms(F &&fn) {
+  auto t0 = std::chrono::steady_clock::now();
+  fn();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+double rel_diff(double a, double b) {
+  return std::abs(a - b) / std::max(1e-12, std::max(std::abs(a), std::abs(b)));
+}
+
+// Largest relative difference between update() over every value and
+// seed(values), for one indicator per class.
+template <typename T, typename Value>
+void check_seed(const char *name, T streamed, T seeded,
+                std::span<const double> values, Value value) {
+  for (double v : values)
+    streamed.update(v);
+  seeded.seed(values);
+  std::cout << "  " << std::left << std::setw(16) << name << std::right
+            << std::scientific << std::setprecision(2)
+            << rel_diff(value(streamed), value(seeded)) << "\n";
+}
+
+struct Agreement {
+  bool same_trades = true;
+  double max_equity_diff = 0.0;
+};
+
+void compare(const quant::BacktestResult &a, const quant::BacktestResult &b,
+             Agreement &agree) {
+  agree.same_trades &= a.trades.size() == b.trades.size() &&
+                       std::equal(a.trades.begin(), a.trades.end(),
+                                  b.trades.begin(),
+                                  [](const quant::Trade &x, const quant::Trade &y) {
+                                    return x.entry_time == y.entry_time &&
+                                           x.exit_time == y.exit_time &&
+                                           x.side == y.side;
+                                  });
+  agree.max_equity_diff =
+      std::max(agree.max_equity_diff,
+               std::abs(a.report.final_equity - b.report.final_equity));
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 300000;
+  size_t window = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5000;
+  size_t windows = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 10;
+  auto bars = bench::make_bars(n, 42);
+  std::span<const quant::Bar> series(bars);
+
+  std::vector<double> close, high, low;
+  for (const auto &b : bars) {
+    close.push_back(b.close);
+    high.push_back(b.high);
+    low.push_back(b.low);
+  }
+
+  std::cout << "seed() vs update() over " << n << " bars (max rel diff)\n";
+  check_seed("SMA(300)", quant::SimpleMovingAverage(300),
+             quant::SimpleMovingAverage(300), close,
+             [](const auto &i) { return i.value(); });
+  check_seed("EMA(26)", quant::ExponentialMovingAverage(26),
+             quant::ExponentialMovingAverage(26), close,
+             [](const auto &i) { return i.value(); });
+  check_seed("RSI(20)", quant::RSI(20), quant::RSI(20), close,
+             [](const auto &i) { return i.value(); });
+  check_seed("ROC(100)", quant::RateOfChange(100), quant::RateOfChange(100),
+             close, [](const auto &i) { return i.value(); });
+  check_seed("Stats(200).sd", quant::RollingStats(200),
+             quant::RollingStats(200), close,
+             [](const auto &i) { return i.std_dev(); });
+  check_seed("BB(100).upper", quant::BollingerBands(100, 2.0),
+             quant::BollingerBands(100, 2.0), close,
+             [](const auto &i) { return i.value().upper; });
+  {
+    quant::ATR streamed(14), seeded(14);
+    for (size_t i = 0; i < n; ++i)
+      streamed.update(high[i], low[i], close[i]);
+    seeded.seed(high, low, close);
+    std::cout << "  " << std::left << std::setw(16) << "ATR(14)" << std::right
+              << rel_diff(streamed.value(), seeded.value()) << "\n";
+  }
+
+  quant::StaticStrategyStack<> probe(quant::StrategyParams{});
+  const quant::WarmupConfig lazy;
+  const quant::WarmupPlan sample = quant::plan_warmup(probe, n - window, lazy);
+  std::cout << std::defaultfloat << "\nDefault stack: lookback "
+            << probe.lookback(lazy.tolerance) << " bars (tolerance "
+            << lazy.tolerance << "), strategies replay "
+            << probe.warmup_bars() << " + " << lazy.settle_bars
+            << " settle bars\n";
+
+  // Windows spread over the second half of the series
+  std::vector<size_t> begins;
+  for (size_t w = 0; w < windows; ++w)
+    begins.push_back(n / 2 + w * (n / 2 - window) /
+                                 std::max<size_t>(1, windows - 1));
+
+  quant::WarmupConfig full;
+  full.tolerance = 0.0; // Replay from bar 0 = the full run
+  quant::WarmupConfig replay_only = lazy;
+  replay_only.seed = false;
+
+  struct Mode {
+    const char *name;
+    quant::WarmupConfig config;
+    double ms = 0.0;
+    Agreement agree;
+  };
+  Mode modes[] = {{"replay from bar 0", full, 0.0, {}},
+                  {"lazy, replay only", replay_only, 0.0, {}},
+                  {"lazy, seeded", lazy, 0.0, {}}};
+
+  std::vector<quant::BacktestResult> reference(begins.size());
+  for (auto &mode : modes) {
+    quant::Engine engine(nullptr);
+    engine.set_warmup_config(mode.config);
+    engine.run_window(series, begins[0], begins[0] + window); // Untimed
+    for (size_t w = 0; w < begins.size(); ++w) {
+      quant::BacktestResult r;
+      mode.ms += time_ms(
+          [&] { r = engine.run_window(series, begins[w], begins[w] + window); });
+      if (&mode == &modes[0])
+        reference[w] = std::move(r);
+      else
+        compare(reference[w], r, mode.agree);
+    }
+  }
+
+  std::cout << "\n" << begins.size() << " windows of " << window
+            << " bars in the second half (history per window: "
+            << sample.history_bars() << " bars planned)\n"
+            << std::left << std::setw(20) << "  mode" << std::right
+            << std::setw(12) << "ms/window" << std::setw(10) << "speedup"
+            << std::setw(14) << "same trades" << std::setw(14)
+            << "max |dEq|" << "\n";
+  bool ok = true;
+  for (const auto &mode : modes) {
+    bool reference_mode = &mode == &modes[0];
+    std::cout << "  " << std::left << std::setw(18) << mode.name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(12)
+              << mode.ms / begins.size() << std::setw(9)
+              << modes[0].ms / mode.ms << "x" << std::setw(14)
+              << (reference_mode ? "-" : mode.agree.same_trades ? "yes" : "NO")
+              << std::setw(14) << mode.agree.max_equity_diff << "\n";
+    ok &= mode.agree.same_trades;
+  }
+
+  // Sweep over the last window: full replay vs lazy
+  quant::ParameterGrid grid;
+  grid.add("bb_period", {80, 100, 120}).add("trend_sma", {200, 300});
+  double sweep_ms[2];
+  quant::SweepReport sweeps[2];
+  for (int lazy_mode = 0; lazy_mode < 2; ++lazy_mode) {
+    quant::ParameterSweep sweep(series);
+    sweep.set_window(n - window, n, lazy_mode ? lazy : full);
+    sweep_ms[lazy_mode] = time_ms([&] { sweeps[lazy_mode] = sweep.run(grid, 1); });
+  }
+  bool same_ranking = true;
+  for (size_t i = 0; i < grid.size(); ++i)
+    same_ranking &= sweeps[0].ranked[i].combo_index ==
+                    sweeps[1].ranked[i].combo_index;
+  std::cout << "\nSweep of " << grid.size() << " combos on the last " << window
+            << " bars: replay from bar 0 " << std::setprecision(1)
+            << sweep_ms[0] << " ms, lazy " << sweep_ms[1] << " ms ("
+            << std::setprecision(1) << sweep_ms[0] / sweep_ms[1]
+            << "x), same ranking: " << (same_ranking ? "yes" : "NO") << "\n";
+  ok &= same_ranking;
+
+  std::cout << "\nAll checks: " << (ok ? "pass" : "FAIL") << "\n";
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Debug heap-allocation counting
+// ---------------------------------------------------------
+// Built with QUANT_COUNT_ALLOCATIONS (CMake option of the same name), the
+// library replaces global operator new (src/AllocationCounter.cpp) and
+// counts allocations per thread. Otherwise counting compiles to nothing and
+// every count reads 0.
+
+#ifdef QUANT_COUNT_ALLOCATIONS
+inline constexpr bool ALLOCATION_COUNTING = true;
+
+// Heap allocations made by the calling thread so far.
+uint64_t thread_allocation_count();
+#else
+inline constexpr bool ALLOCATION_COUNTING = false;
+
+inline uint64_t thread_allocation_count() { return 0; }
+#endif
+
+/**
+ * @brief Allocations made by this thread since construction, e.g. around a
+ * hot loop that must not allocate.
+ */
+class AllocationScope {
+public:
+  AllocationScope() : start_(thread_allocation_count()) {}
+
+  uint64_t count() const { return thread_allocation_count() - start_; }
+
+private:
+  uint64_t start_;
+};
+
+} // namespace quant
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Bar.hpp"
+#include "BarSeries.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace quant {
+
+/**
+ * @brief Binary columnar bar cache (.qbar).
+ *
+ * Layout (little-endian, every section 64-byte aligned):
+ *   QBarHeader (64 bytes)
+ *   int64  timestamp[bar_count]
+ *   double open[bar_count], high[..], low[..], close[..], volume[..]
+ *
+ * The checksum covers all six columns, so truncated or partially written
+ * caches are rejected and the CSV is re-parsed instead.
+ */
+constexpr uint32_t QBAR_MAGIC = 0x52414251; // "QBAR"
+constexpr uint32_t QBAR_VERSION = 1;
+constexpr size_t QBAR_ALIGNMENT = 64;
+constexpr size_t QBAR_COLUMNS = 6;
+
+struct QBarHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t bar_count;
+  int64_t utc_offset;  // Offset the timestamps were parsed with
+  uint64_t source_size; // Byte size of the CSV the cache was built from
+  uint64_t checksum;    // qbar_checksum over the column payload
+  uint64_t column_stride; // Bytes between column starts (padded)
+  uint64_t reserved[2];
+};
+static_assert(sizeof(QBarHeader) == QBAR_ALIGNMENT,
+              "QBarHeader must occupy exactly one cache line");
+
+/// Cache file path used for a given CSV ("data.csv" -> "data.csv.qbar").
+std::string qbar_path_for(const std::string &csv_path);
+
+/// True if cache_path exists and is at least as new as source_path.
+bool qbar_is_fresh(const std::string &cache_path,
+                   const std::string &source_path);
+
+/**
+ * @brief Write bars as a .qbar file (via a temporary file + rename, so a
+ * crashed writer never leaves a half-written cache behind). Every call
+ * writes its own uniquely named temporary, so concurrent writers of one
+ * cache never clobber each other; the last rename wins.
+ */
+bool write_qbar(const std::string &cache_path, const BarSeries &series,
+                int64_t utc_offset, uint64_t source_size);
+
+/**
+ * @brief Memory-map a .qbar file and load its columns into series.
+ * Each column is a single memcpy out of the mapping. Fails (returning false,
+ * leaving series untouched) on a schema version, offset or source-size
+ * mismatch, or a bad checksum.
+ */
+bool read_qbar(const std::string &cache_path, int64_t expected_utc_offset,
+               uint64_t expected_source_size, BarSeries &series);
+
+/**
+ * @brief Same checks, but fill row-layout bars in a single pass straight
+ * from the mapped columns, with no intermediate BarSeries. If `header` is
+ * given it receives the cache's header, for a later reread_qbar().
+ */
+bool read_qbar(const std::string &cache_path, int64_t expected_utc_offset,
+               uint64_t expected_source_size, std::vector<Bar> &bars,
+               QBarHeader *header = nullptr);
+
+/**
+ * @brief Copy the columns of a cache read_qbar() already verified into
+ * series, one memcpy each and no checksum pass. Fails if the file no longer
+ * carries exactly `verified` as its header (it was replaced since).
+ */
+bool reread_qbar(const std::string &cache_path, const QBarHeader &verified,
+                 BarSeries &series);
+
+} // namespace quant
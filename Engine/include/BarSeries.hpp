@@ -0,0 +1,165 @@
+#pragma once
+
+#include "Bar.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <vector>
+
+namespace quant {
+
+/**
+ * @brief Minimal allocator returning Align-byte aligned storage.
+ * Used so every BarSeries column starts on a cache line (and SIMD loads
+ * from column[0] are aligned).
+ */
+template <typename T, size_t Align = 64> struct AlignedAllocator {
+  using value_type = T;
+
+  AlignedAllocator() noexcept = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Align> &) noexcept {}
+
+  template <typename U> struct rebind {
+    using other = AlignedAllocator<U, Align>;
+  };
+
+  T *allocate(size_t n) {
+    return static_cast<T *>(
+        ::operator new(n * sizeof(T), std::align_val_t(Align)));
+  }
+  void deallocate(T *p, size_t) noexcept {
+    ::operator delete(p, std::align_val_t(Align));
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Align> &) const noexcept {
+    return true;
+  }
+};
+
+template <typename T> using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+/**
+ * @brief Non-owning columnar bar view, e.g. over NumPy / pandas columns
+ * handed in from Python. Rows are gathered on access; nothing is copied up
+ * front. All columns must have the same length.
+ */
+struct BarColumns {
+  std::span<const int64_t> timestamp;
+  std::span<const double> open;
+  std::span<const double> high;
+  std::span<const double> low;
+  std::span<const double> close;
+  std::span<const double> volume;
+
+  size_t size() const { return close.size(); }
+  bool empty() const { return close.empty(); }
+
+  bool consistent() const {
+    const size_t n = close.size();
+    return timestamp.size() == n && open.size() == n && high.size() == n &&
+           low.size() == n && volume.size() == n;
+  }
+
+  Bar operator[](size_t i) const {
+    return Bar(timestamp[i], open[i], high[i], low[i], close[i], volume[i]);
+  }
+};
+
+/**
+ * @brief Structure-of-arrays bar storage.
+ * One contiguous 64-byte aligned column per field, exposed as std::span so
+ * the batch functions in features.hpp can consume a column without copying
+ * it out of a std::vector<Bar> first.
+ */
+class BarSeries {
+public:
+  BarSeries() = default;
+
+  static BarSeries from_bars(const std::vector<Bar> &bars) {
+    BarSeries series;
+    series.reserve(bars.size());
+    for (const auto &bar : bars)
+      series.push_back(bar);
+    return series;
+  }
+
+  std::vector<Bar> to_bars() const {
+    std::vector<Bar> bars;
+    bars.reserve(size());
+    for (size_t i = 0; i < size(); ++i)
+      bars.push_back((*this)[i]);
+    return bars;
+  }
+
+  void reserve(size_t n) {
+    timestamp_.reserve(n);
+    open_.reserve(n);
+    high_.reserve(n);
+    low_.reserve(n);
+    close_.reserve(n);
+    volume_.reserve(n);
+  }
+
+  // Resize all columns (new rows zeroed); follow with the mutable_* spans
+  // to fill columns in bulk.
+  void resize(size_t n) {
+    timestamp_.resize(n);
+    open_.resize(n);
+    high_.resize(n);
+    low_.resize(n);
+    close_.resize(n);
+    volume_.resize(n);
+  }
+
+  void push_back(const Bar &bar) {
+    timestamp_.push_back(bar.timestamp);
+    open_.push_back(bar.open);
+    high_.push_back(bar.high);
+    low_.push_back(bar.low);
+    close_.push_back(bar.close);
+    volume_.push_back(bar.volume);
+  }
+
+  void clear() { resize(0); }
+
+  size_t size() const { return close_.size(); }
+  bool empty() const { return close_.empty(); }
+
+  // Row view (gathers one element from each column)
+  Bar operator[](size_t i) const {
+    return Bar(timestamp_[i], open_[i], high_[i], low_[i], close_[i],
+               volume_[i]);
+  }
+
+  // Column accessors
+  std::span<const int64_t> timestamps() const { return timestamp_; }
+  std::span<const double> open() const { return open_; }
+  std::span<const double> high() const { return high_; }
+  std::span<const double> low() const { return low_; }
+  std::span<const double> close() const { return close_; }
+  std::span<const double> volume() const { return volume_; }
+
+  BarColumns columns() const {
+    return {timestamp_, open_, high_, low_, close_, volume_};
+  }
+
+  std::span<int64_t> mutable_timestamps() { return timestamp_; }
+  std::span<double> mutable_open() { return open_; }
+  std::span<double> mutable_high() { return high_; }
+  std::span<double> mutable_low() { return low_; }
+  std::span<double> mutable_close() { return close_; }
+  std::span<double> mutable_volume() { return volume_; }
+
+private:
+  AlignedVector<int64_t> timestamp_;
+  AlignedVector<double> open_;
+  AlignedVector<double> high_;
+  AlignedVector<double> low_;
+  AlignedVector<double> close_;
+  AlignedVector<double> volume_;
+};
+
+} // namespace quant
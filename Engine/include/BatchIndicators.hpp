@@ -0,0 +1,1058 @@
+#pragma once
+
+#include "BarSeries.hpp"
+#include "IndicatorRegistry.hpp"
+#include "Indicators.hpp"
+#include "RollingMoments.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Cross-symbol (batched) indicators
+// ---------------------------------------------------------
+// One lane = one symbol. State is stored structure-of-arrays (one array per
+// state variable, indexed by lane), so a loop over lanes is one SIMD lane per
+// symbol. Every class reproduces its scalar counterpart in Indicators.hpp
+// operation for operation: lane l of a batch fed x[t][l] holds bit-for-bit
+// the value a scalar indicator fed the same series would, unless the compiler
+// fuses multiply-adds (-ffp-contract=fast) differently in the two, which can
+// move a Bollinger band by an ulp.
+//
+// update() takes one input per lane. NaN marks a lane with no bar at this
+// timestamp; that lane's state is left untouched, exactly as if the scalar
+// indicator had not been called.
+//
+// Each class has two paths, both branch-free lane loops that auto-vectorize
+// (bar the std::sqrt loops, which need -fno-math-errno).
+// Dense: all lanes present and in step (same history length), so warm-up
+// phase and ring row are shared. Masked: per-lane history lengths and ring
+// positions; every lane computes its step and absent lanes keep their old
+// state through a select. A batch switches to the masked path for good on
+// its first update with an absent lane.
+
+inline constexpr double BATCH_MISSING = std::numeric_limits<double>::quiet_NaN();
+
+// How many lanes carry a value in one cross-section.
+enum class LaneCoverage : uint8_t { None, Dense, Sparse };
+
+inline LaneCoverage lane_coverage(const double *x, size_t lanes) {
+  size_t present = 0;
+  for (size_t l = 0; l < lanes; ++l)
+    present += !std::isnan(x[l]);
+  return present == 0       ? LaneCoverage::None
+         : present == lanes ? LaneCoverage::Dense
+                            : LaneCoverage::Sparse;
+}
+
+/**
+ * @brief Per-lane history length (number of accepted inputs).
+ * All lanes share one count until the first sparse update, which splits it
+ * into per-lane counters.
+ */
+class LaneClock {
+public:
+  explicit LaneClock(size_t lanes) : lanes_(lanes) {}
+
+  size_t lanes() const { return lanes_; }
+  size_t count(size_t lane) const {
+    return uniform_ ? count_ : counts_[lane];
+  }
+
+  // This update may take the dense path; shared_count() is then every
+  // lane's history length. Follow with tick().
+  bool dense(LaneCoverage coverage) const {
+    return coverage == LaneCoverage::Dense && uniform_;
+  }
+  size_t shared_count() const { return count_; }
+  void tick() { ++count_; }
+
+  // Masked path: per-lane inputs accepted before this update. Lanes whose
+  // key is NaN are absent. Follow with advance(key).
+  const size_t *counts() {
+    if (uniform_) {
+      counts_.assign(lanes_, count_);
+      uniform_ = false;
+    }
+    return counts_.data();
+  }
+  void advance(const double *key) {
+    size_t *counts = counts_.data();
+    const size_t lanes = lanes_;
+    for (size_t l = 0; l < lanes; ++l)
+      counts[l] += !std::isnan(key[l]);
+  }
+
+private:
+  size_t lanes_;
+  bool uniform_ = true;
+  size_t count_ = 0;
+  std::vector<size_t> counts_;
+};
+
+/**
+ * @brief Power-of-two ring per lane, stored [slot][lane] so that lanes at
+ * the same position are one contiguous row. Position = history index.
+ */
+class LaneRing {
+public:
+  LaneRing(size_t lanes, size_t capacity)
+      : lanes_(lanes), mask_(std::bit_ceil(std::max<size_t>(capacity, 1)) - 1),
+        data_((mask_ + 1) * lanes, 0.0) {}
+
+  double *row(size_t n) { return data_.data() + (n & mask_) * lanes_; }
+  const double *row(size_t n) const {
+    return data_.data() + (n & mask_) * lanes_;
+  }
+  double &at(size_t n, size_t lane) { return row(n)[lane]; }
+  double at(size_t n, size_t lane) const { return row(n)[lane]; }
+
+  // Masked path, one slot per lane (n[l] = that lane's history index). The
+  // arguments must not point into the ring: the scatter and gather loops
+  // only vectorize with that promise.
+
+  // x[l] at n[l]. An absent lane writes its NaN into the slot its next value
+  // will take; with capacity >= period + 1 that slot holds nothing still in
+  // the window.
+  void store(const size_t *__restrict n, const double *__restrict x) {
+    double *__restrict data = data_.data();
+    const size_t mask = mask_;
+    const size_t lanes = lanes_;
+    for (size_t l = 0; l < lanes; ++l)
+      data[(n[l] & mask) * lanes + l] = x[l];
+  }
+  // out[l] = value at n[l] - back (stale for lanes with n[l] < back).
+  void gather(const size_t *__restrict n, size_t back,
+              double *__restrict out) const {
+    const double *__restrict data = data_.data();
+    const size_t mask = mask_;
+    const size_t lanes = lanes_;
+    for (size_t l = 0; l < lanes; ++l)
+      out[l] = data[((n[l] - back) & mask) * lanes + l];
+  }
+
+private:
+  size_t lanes_;
+  size_t mask_;
+  AlignedVector<double> data_;
+};
+
+// Strided view of one lane's window (0 = latest), for RollingMoments-style
+// re-anchoring in the same element order as the scalar buffers.
+struct LaneWindow {
+  const LaneRing *ring;
+  size_t latest; // History index of the newest value
+  size_t lane;
+  size_t count;
+
+  size_t size() const { return count; }
+  double operator[](size_t i) const { return ring->at(latest - i, lane); }
+};
+
+// ---------------------------------------------------------
+// Simple Moving Average
+// ---------------------------------------------------------
+class BatchSMA {
+public:
+  // Ring keeps period + 1 rows so the leaving and entering rows differ.
+  BatchSMA(size_t lanes, int period)
+      : period_(period), clock_(lanes), ring_(lanes, period + 1),
+        sum_(lanes, 0.0), value_(lanes, 0.0), leaving_(lanes, 0.0) {}
+
+  void update(const double *x) { update(x, lane_coverage(x, lanes())); }
+  void update(const double *x, LaneCoverage coverage) {
+    if (coverage == LaneCoverage::None)
+      return;
+    if (!clock_.dense(coverage)) {
+      update_masked(x);
+      return;
+    }
+    const size_t n = clock_.shared_count();
+    const size_t p = static_cast<size_t>(period_);
+    const size_t size = std::min(n + 1, p);
+    double *row = ring_.row(n);
+    double *sum = sum_.data();
+    double *value = value_.data();
+    if (n >= p) {
+      const double *oldest = ring_.row(n - p);
+      for (size_t l = 0; l < lanes(); ++l)
+        sum[l] -= oldest[l];
+    }
+    for (size_t l = 0; l < lanes(); ++l) {
+      row[l] = x[l];
+      sum[l] += x[l];
+      value[l] = sum[l] / size;
+    }
+    clock_.tick();
+  }
+
+  size_t lanes() const { return clock_.lanes(); }
+  double value(size_t l) const { return value_[l]; }
+  bool is_ready(size_t l) const {
+    return clock_.count(l) >= static_cast<size_t>(period_);
+  }
+
+private:
+  void update_masked(const double *x) {
+    const size_t *count = clock_.counts();
+    const size_t p = static_cast<size_t>(period_);
+    double *sum = sum_.data();
+    double *value = value_.data();
+    const double *oldest = leaving_.data();
+    ring_.store(count, x);
+    ring_.gather(count, p, leaving_.data());
+    for (size_t l = 0; l < lanes(); ++l) {
+      const bool on = !std::isnan(x[l]);
+      const size_t n = count[l];
+      const double s = (sum[l] - (n >= p ? oldest[l] : 0.0)) + x[l];
+      const double v = s / std::min(n + 1, p);
+      sum[l] = on ? s : sum[l];
+      value[l] = on ? v : value[l];
+    }
+    clock_.advance(x);
+  }
+
+  int period_;
+  LaneClock clock_;
+  LaneRing ring_;
+  AlignedVector<double> sum_;
+  AlignedVector<double> value_;
+  AlignedVector<double> leaving_; // Masked path: ring value at n - period
+};
+
+// ---------------------------------------------------------
+// Exponential Moving Average
+// ---------------------------------------------------------
+class BatchEMA {
+public:
+  BatchEMA(size_t lanes, int period)
+      : alpha_(2.0 / (period + 1.0)), clock_(lanes), value_(lanes, 0.0) {}
+
+  void update(const double *x) { update(x, lane_coverage(x, lanes())); }
+  void update(const double *x, LaneCoverage coverage) {
+    if (coverage == LaneCoverage::None)
+      return;
+    if (!clock_.dense(coverage)) {
+      update_masked(x);
+      return;
+    }
+    double *value = value_.data();
+    if (clock_.shared_count() == 0) {
+      std::copy(x, x + lanes(), value);
+    } else {
+      for (size_t l = 0; l < lanes(); ++l)
+        value[l] = alpha_ * x[l] + (1.0 - alpha_) * value[l];
+    }
+    clock_.tick();
+  }
+
+  size_t lanes() const { return clock_.lanes(); }
+  double value(size_t l) const { return value_[l]; }
+  bool is_ready(size_t l) const { return clock_.count(l) > 0; }
+
+private:
+  void update_masked(const double *x) {
+    const size_t *count = clock_.counts();
+    const double alpha = alpha_;
+    double *value = value_.data();
+    for (size_t l = 0; l < lanes(); ++l) {
+      const bool on = !std::isnan(x[l]);
+      const double v =
+          count[l] == 0 ? x[l] : alpha * x[l] + (1.0 - alpha) * value[l];
+      value[l] = on ? v : value[l];
+    }
+    clock_.advance(x);
+  }
+
+  double alpha_;
+  LaneClock clock_;
+  AlignedVector<double> value_;
+};
+
+// ---------------------------------------------------------
+// Relative Strength Index (Wilder)
+// ---------------------------------------------------------
+class BatchRSI {
+public:
+  BatchRSI(size_t lanes, int period)
+      : period_(period), clock_(lanes), prev_(lanes, 0.0),
+        avg_gain_(lanes, 0.0), avg_loss_(lanes, 0.0), value_(lanes, 0.0) {}
+
+  void update(const double *x) { update(x, lane_coverage(x, lanes())); }
+  void update(const double *x, LaneCoverage coverage) {
+    if (coverage == LaneCoverage::None)
+      return;
+    if (!clock_.dense(coverage)) {
+      update_masked(x);
+      return;
+    }
+    const size_t n = clock_.shared_count();
+    const size_t p = static_cast<size_t>(period_);
+    double *prev = prev_.data();
+    double *avg_gain = avg_gain_.data();
+    double *avg_loss = avg_loss_.data();
+    double *value = value_.data();
+    clock_.tick();
+    if (n == 0) {
+      std::copy(x, x + lanes(), prev);
+      return;
+    }
+
+    const size_t changes = n - 1; // Changes accumulated before this one
+    if (changes < p) {
+      for (size_t l = 0; l < lanes(); ++l) {
+        double change = x[l] - prev[l];
+        prev[l] = x[l];
+        avg_gain[l] += (change > 0) ? change : 0.0;
+        avg_loss[l] += (change < 0) ? -change : 0.0;
+      }
+      if (changes + 1 < p)
+        return;
+      for (size_t l = 0; l < lanes(); ++l) {
+        avg_gain[l] /= period_;
+        avg_loss[l] /= period_;
+      }
+    } else {
+      for (size_t l = 0; l < lanes(); ++l) {
+        double change = x[l] - prev[l];
+        prev[l] = x[l];
+        double gain = (change > 0) ? change : 0.0;
+        double loss = (change < 0) ? -change : 0.0;
+        avg_gain[l] = (avg_gain[l] * (period_ - 1) + gain) / period_;
+        avg_loss[l] = (avg_loss[l] * (period_ - 1) + loss) / period_;
+      }
+    }
+    for (size_t l = 0; l < lanes(); ++l) {
+      double rs = avg_gain[l] / avg_loss[l];
+      value[l] = avg_loss[l] == 0 ? 100.0 : 100.0 - (100.0 / (1.0 + rs));
+    }
+  }
+
+  size_t lanes() const { return clock_.lanes(); }
+  double value(size_t l) const { return value_[l]; }
+  bool is_ready(size_t l) const {
+    return clock_.count(l) > static_cast<size_t>(period_);
+  }
+
+private:
+  // With n inputs before this one: the first input only seeds prev, inputs
+  // 1..p sum their changes (averaged at n == p), later ones smooth.
+  void update_masked(const double *x) {
+    const size_t *count = clock_.counts();
+    const size_t p = static_cast<size_t>(period_);
+    const double period = period_;
+    const double decay = period_ - 1;
+    double *prev = prev_.data();
+    double *avg_gain = avg_gain_.data();
+    double *avg_loss = avg_loss_.data();
+    double *value = value_.data();
+    for (size_t l = 0; l < lanes(); ++l) {
+      const bool on = !std::isnan(x[l]);
+      const size_t n = count[l];
+      double change = x[l] - prev[l];
+      double gain = (change > 0) ? change : 0.0;
+      double loss = (change < 0) ? -change : 0.0;
+      double g = n <= p ? avg_gain[l] + gain
+                        : (avg_gain[l] * decay + gain) / period;
+      double lo = n <= p ? avg_loss[l] + loss
+                         : (avg_loss[l] * decay + loss) / period;
+      g = n == p ? g / period : g;
+      lo = n == p ? lo / period : lo;
+      double rs = g / lo;
+      double v = lo == 0 ? 100.0 : 100.0 - (100.0 / (1.0 + rs));
+
+      const bool step = on && n > 0;
+      prev[l] = on ? x[l] : prev[l];
+      avg_gain[l] = step ? g : avg_gain[l];
+      avg_loss[l] = step ? lo : avg_loss[l];
+      value[l] = step && n >= p ? v : value[l];
+    }
+    clock_.advance(x);
+  }
+
+  int period_;
+  LaneClock clock_;
+  AlignedVector<double> prev_;
+  AlignedVector<double> avg_gain_;
+  AlignedVector<double> avg_loss_;
+  AlignedVector<double> value_;
+};
+
+// ---------------------------------------------------------
+// Rate of Change
+// ---------------------------------------------------------
+class BatchROC {
+public:
+  BatchROC(size_t lanes, int period)
+      : period_(period), clock_(lanes), ring_(lanes, period + 1),
+        value_(lanes, 0.0), leaving_(lanes, 0.0) {}
+
+  void update(const double *x) { update(x, lane_coverage(x, lanes())); }
+  void update(const double *x, LaneCoverage coverage) {
+    if (coverage == LaneCoverage::None)
+      return;
+    if (!clock_.dense(coverage)) {
+      update_masked(x);
+      return;
+    }
+    const size_t n = clock_.shared_count();
+    const size_t p = static_cast<size_t>(period_);
+    std::copy(x, x + lanes(), ring_.row(n));
+    clock_.tick();
+    if (n < p)
+      return; // Not ready
+    const double *old = ring_.row(n - p);
+    double *value = value_.data();
+    for (size_t l = 0; l < lanes(); ++l)
+      value[l] = old[l] != 0.0 ? (x[l] - old[l]) / old[l] : 0.0;
+  }
+
+  size_t lanes() const { return clock_.lanes(); }
+  double value(size_t l) const { return value_[l]; }
+  bool is_ready(size_t l) const {
+    return clock_.count(l) > static_cast<size_t>(period_);
+  }
+
+private:
+  void update_masked(const double *x) {
+    const size_t *count = clock_.counts();
+    const size_t p = static_cast<size_t>(period_);
+    double *value = value_.data();
+    const double *old = leaving_.data();
+    ring_.store(count, x);
+    ring_.gather(count, p, leaving_.data());
+    for (size_t l = 0; l < lanes(); ++l) {
+      const bool on = !std::isnan(x[l]);
+      const size_t n = count[l];
+      const double v = old[l] != 0.0 ? (x[l] - old[l]) / old[l] : 0.0;
+      value[l] = on && n >= p ? v : value[l];
+    }
+    clock_.advance(x);
+  }
+
+  int period_;
+  LaneClock clock_;
+  LaneRing ring_;
+  AlignedVector<double> value_;
+  AlignedVector<double> leaving_; // Masked path: ring value at n - period
+};
+
+// ---------------------------------------------------------
+// Rolling moments per lane (SoA RollingMoments)
+// ---------------------------------------------------------
+// Shared by BatchRollingStats and BatchBollinger: the anchor-shifted
+// Welford updates and re-anchor schedule of RollingMoments. The caller's
+// ring holds the window and must keep period + 1 rows (the value leaving
+// the window is read after the entering one is stored).
+class LaneMoments {
+public:
+  explicit LaneMoments(size_t lanes)
+      : anchor_(lanes, 0.0), mean_(lanes, 0.0), m2_(lanes, 0.0) {}
+
+  // All lanes at history index n (already stored in the ring).
+  void push_dense(const LaneRing &ring, size_t n, size_t period) {
+    const size_t lanes = anchor_.size();
+    const double *x = ring.row(n);
+    double *anchor = anchor_.data();
+    double *mean = mean_.data();
+    double *m2 = m2_.data();
+    if (n < period) {
+      // RollingMoments::add with count = n + 1
+      if (n == 0)
+        std::copy(x, x + lanes, anchor);
+      const size_t count = n + 1;
+      for (size_t l = 0; l < lanes; ++l) {
+        double xs = x[l] - anchor[l];
+        double delta = xs - mean[l];
+        mean[l] += delta / count;
+        m2[l] += delta * (xs - mean[l]);
+      }
+      return;
+    }
+    // RollingMoments::replace
+    const double *old = ring.row(n - period);
+    for (size_t l = 0; l < lanes; ++l) {
+      double x_old = old[l] - anchor[l];
+      double x_new = x[l] - anchor[l];
+      double delta = x_new - x_old;
+      double old_mean = mean[l];
+      mean[l] += delta / period;
+      m2[l] += delta * ((x_new - mean[l]) + (x_old - old_mean));
+    }
+    if (due_for_reanchor(n, period)) {
+      for (size_t l = 0; l < lanes; ++l)
+        reanchor(LaneWindow{&ring, n, l, period});
+    }
+  }
+
+  // Lane l's x[l] at history index count[l] (already stored in the ring)
+  // unless x[l] is NaN; leaving[l] is the ring value at count[l] - period.
+  // add and replace share one division, by min(n + 1, period): n + 1 while
+  // warming up, period after.
+  void push_masked(const LaneRing &ring, const size_t *count, const double *x,
+                   const double *leaving, size_t period) {
+    const size_t lanes = anchor_.size();
+    double *anchor = anchor_.data();
+    double *mean = mean_.data();
+    double *m2 = m2_.data();
+    for (size_t l = 0; l < lanes; ++l) {
+      const bool on = !std::isnan(x[l]);
+      const size_t n = count[l];
+      const bool warm = n < period; // RollingMoments::add, else replace
+      const double a = n == 0 ? x[l] : anchor[l];
+      const double x_new = x[l] - a;
+      const double x_old = leaving[l] - a;
+      const double delta = warm ? x_new - mean[l] : x_new - x_old;
+      const double new_mean = mean[l] + delta / std::min(n + 1, period);
+      const double spread = warm ? x_new - new_mean
+                                 : (x_new - new_mean) + (x_old - mean[l]);
+      anchor[l] = on ? a : anchor[l];
+      m2[l] = on ? m2[l] + delta * spread : m2[l];
+      mean[l] = on ? new_mean : mean[l];
+    }
+    for (size_t l = 0; l < lanes; ++l) {
+      const size_t n = count[l];
+      if (!std::isnan(x[l]) && n >= period && due_for_reanchor(n, period))
+        reanchor(LaneWindow{&ring, n, l, period});
+    }
+  }
+
+  double mean(size_t l) const { return anchor_[l] + mean_[l]; }
+  double variance(size_t l, size_t count) const {
+    return count > 0 && m2_[l] > 0.0 ? m2_[l] / count : 0.0;
+  }
+
+private:
+  // Every ROLLING_REANCHOR_INTERVAL-th replace, as in RollingMoments
+  static bool due_for_reanchor(size_t n, size_t period) {
+    return (n - period + 1) % ROLLING_REANCHOR_INTERVAL == 0;
+  }
+
+  void reanchor(const LaneWindow &w) {
+    double sum = 0.0;
+    for (size_t i = 0; i < w.size(); ++i)
+      sum += w[i];
+    double anchor = sum / w.size();
+    double m2 = 0.0;
+    for (size_t i = 0; i < w.size(); ++i) {
+      double d = w[i] - anchor;
+      m2 += d * d;
+    }
+    anchor_[w.lane] = anchor;
+    mean_[w.lane] = 0.0;
+    m2_[w.lane] = m2;
+  }
+
+  AlignedVector<double> anchor_;
+  AlignedVector<double> mean_;
+  AlignedVector<double> m2_;
+};
+
+// ---------------------------------------------------------
+// Rolling Statistics (Mean, StdDev, ZScore)
+// ---------------------------------------------------------
+class BatchRollingStats {
+public:
+  BatchRollingStats(size_t lanes, int period)
+      : period_(period), clock_(lanes), ring_(lanes, period + 1),
+        moments_(lanes), mean_(lanes, 0.0), std_dev_(lanes, 0.0),
+        zscore_(lanes, 0.0), leaving_(lanes, 0.0) {}
+
+  void update(const double *x) { update(x, lane_coverage(x, lanes())); }
+  void update(const double *x, LaneCoverage coverage) {
+    if (coverage == LaneCoverage::None)
+      return;
+    if (!clock_.dense(coverage)) {
+      update_masked(x);
+      return;
+    }
+    const size_t n = clock_.shared_count();
+    const size_t p = static_cast<size_t>(period_);
+    const size_t count = std::min(n + 1, p);
+    std::copy(x, x + lanes(), ring_.row(n));
+    moments_.push_dense(ring_, n, p);
+    for (size_t l = 0; l < lanes(); ++l)
+      emit(l, x[l], count);
+    clock_.tick();
+  }
+
+  size_t lanes() const { return clock_.lanes(); }
+  double value(size_t l) const { return mean_[l]; }
+  double std_dev(size_t l) const { return std_dev_[l]; }
+  double zscore(size_t l) const { return zscore_[l]; }
+  bool is_ready(size_t l) const {
+    return clock_.count(l) >= static_cast<size_t>(period_);
+  }
+
+private:
+  void update_masked(const double *x) {
+    const size_t *count = clock_.counts();
+    const size_t p = static_cast<size_t>(period_);
+    ring_.store(count, x);
+    ring_.gather(count, p, leaving_.data());
+    moments_.push_masked(ring_, count, x, leaving_.data(), p);
+    double *mean = mean_.data();
+    double *std_dev = std_dev_.data();
+    double *zscore = zscore_.data();
+    for (size_t l = 0; l < lanes(); ++l) {
+      const bool on = !std::isnan(x[l]);
+      const double m = moments_.mean(l);
+      const double sd =
+          std::sqrt(moments_.variance(l, std::min(count[l] + 1, p)));
+      const double z = sd > 1e-9 ? (x[l] - m) / sd : 0.0;
+      mean[l] = on ? m : mean[l];
+      std_dev[l] = on ? sd : std_dev[l];
+      zscore[l] = on ? z : zscore[l];
+    }
+    clock_.advance(x);
+  }
+
+  void emit(size_t l, double x, size_t count) {
+    mean_[l] = moments_.mean(l);
+    std_dev_[l] = std::sqrt(moments_.variance(l, count));
+    zscore_[l] = std_dev_[l] > 1e-9 ? (x - mean_[l]) / std_dev_[l] : 0.0;
+  }
+
+  int period_;
+  LaneClock clock_;
+  LaneRing ring_;
+  LaneMoments moments_;
+  AlignedVector<double> mean_;
+  AlignedVector<double> std_dev_;
+  AlignedVector<double> zscore_;
+  AlignedVector<double> leaving_; // Masked path: ring value at n - period
+};
+
+// ---------------------------------------------------------
+// Bollinger Bands
+// ---------------------------------------------------------
+class BatchBollinger {
+public:
+  BatchBollinger(size_t lanes, int period, double std_dev_mult)
+      : period_(period), mult_(std_dev_mult), clock_(lanes),
+        ring_(lanes, period + 1), moments_(lanes), sum_(lanes, 0.0),
+        value_(lanes, BBResult{}), leaving_(lanes, 0.0) {}
+
+  void update(const double *x) { update(x, lane_coverage(x, lanes())); }
+  void update(const double *x, LaneCoverage coverage) {
+    if (coverage == LaneCoverage::None)
+      return;
+    if (!clock_.dense(coverage)) {
+      update_masked(x);
+      return;
+    }
+    const size_t n = clock_.shared_count();
+    const size_t p = static_cast<size_t>(period_);
+    double *sum = sum_.data();
+    // Basis: the SMA's running sum over the same window
+    if (n >= p) {
+      const double *oldest = ring_.row(n - p);
+      for (size_t l = 0; l < lanes(); ++l)
+        sum[l] -= oldest[l];
+    }
+    std::copy(x, x + lanes(), ring_.row(n));
+    moments_.push_dense(ring_, n, p);
+    for (size_t l = 0; l < lanes(); ++l) {
+      sum[l] += x[l];
+      emit(l, x[l], n);
+    }
+    clock_.tick();
+  }
+
+  size_t lanes() const { return clock_.lanes(); }
+  BBResult value(size_t l) const { return value_[l]; }
+  bool is_ready(size_t l) const {
+    return clock_.count(l) >= static_cast<size_t>(period_);
+  }
+
+private:
+  void update_masked(const double *x) {
+    const size_t *count = clock_.counts();
+    const size_t p = static_cast<size_t>(period_);
+    double *sum = sum_.data();
+    const double *oldest = leaving_.data();
+    ring_.store(count, x);
+    ring_.gather(count, p, leaving_.data());
+    for (size_t l = 0; l < lanes(); ++l) {
+      const size_t n = count[l];
+      const double s = (sum[l] - (n >= p ? oldest[l] : 0.0)) + x[l];
+      sum[l] = !std::isnan(x[l]) ? s : sum[l];
+    }
+    moments_.push_masked(ring_, count, x, oldest, p);
+    for (size_t l = 0; l < lanes(); ++l) {
+      const bool on = !std::isnan(x[l]);
+      const BBResult r = band(l, x[l], count[l]);
+      BBResult &out = value_[l];
+      out.upper = on ? r.upper : out.upper;
+      out.middle = on ? r.middle : out.middle;
+      out.lower = on ? r.lower : out.lower;
+      out.pct_b = on ? r.pct_b : out.pct_b;
+    }
+    clock_.advance(x);
+  }
+
+  void emit(size_t l, double x, size_t n) { value_[l] = band(l, x, n); }
+
+  BBResult band(size_t l, double x, size_t n) const {
+    const size_t p = static_cast<size_t>(period_);
+    double basis = sum_[l] / std::min(n + 1, p);
+    double std_dev = n + 1 >= p ? std::sqrt(moments_.variance(l, p)) : 0.0;
+
+    BBResult r = {basis + mult_ * std_dev, basis, basis - mult_ * std_dev,
+                  0.0};
+    r.pct_b =
+        r.upper != r.lower ? (x - r.lower) / (r.upper - r.lower) : 0.5;
+    return r;
+  }
+
+  int period_;
+  double mult_;
+  LaneClock clock_;
+  LaneRing ring_;
+  LaneMoments moments_;
+  AlignedVector<double> sum_;
+  std::vector<BBResult> value_;
+  AlignedVector<double> leaving_; // Masked path: ring value at n - period
+};
+
+// ---------------------------------------------------------
+// Average True Range (Wilder)
+// ---------------------------------------------------------
+class BatchATR {
+public:
+  BatchATR(size_t lanes, int period)
+      : period_(period), clock_(lanes), prev_close_(lanes, 0.0),
+        value_(lanes, 0.0) {}
+
+  // Lanes with NaN close are absent.
+  void update(const double *high, const double *low, const double *close) {
+    update(high, low, close, lane_coverage(close, lanes()));
+  }
+  void update(const double *high, const double *low, const double *close,
+              LaneCoverage coverage) {
+    if (coverage == LaneCoverage::None)
+      return;
+    if (!clock_.dense(coverage)) {
+      update_masked(high, low, close);
+      return;
+    }
+    const size_t n = clock_.shared_count();
+    const size_t p = static_cast<size_t>(period_);
+    double *prev_close = prev_close_.data();
+    double *value = value_.data();
+    for (size_t l = 0; l < lanes(); ++l) {
+      double tr = true_range(n, high[l], low[l], prev_close[l]);
+      prev_close[l] = close[l];
+      value[l] = n < p ? value[l] + tr
+                       : (value[l] * (period_ - 1) + tr) / period_;
+    }
+    if (n + 1 == p) {
+      for (size_t l = 0; l < lanes(); ++l)
+        value[l] /= period_;
+    }
+    clock_.tick();
+  }
+
+  size_t lanes() const { return clock_.lanes(); }
+  double value(size_t l) const { return value_[l]; }
+  bool is_ready(size_t l) const {
+    return clock_.count(l) >= static_cast<size_t>(period_);
+  }
+
+private:
+  static double true_range(size_t n, double high, double low,
+                           double prev_close) {
+    double tr1 = high - low;
+    if (n == 0)
+      return tr1;
+    double tr2 = std::abs(high - prev_close);
+    double tr3 = std::abs(low - prev_close);
+    return std::max({tr1, tr2, tr3});
+  }
+
+  void update_masked(const double *high, const double *low,
+                     const double *close) {
+    const size_t *count = clock_.counts();
+    const size_t p = static_cast<size_t>(period_);
+    const double period = period_;
+    const double decay = period_ - 1;
+    double *prev_close = prev_close_.data();
+    double *value = value_.data();
+    for (size_t l = 0; l < lanes(); ++l) {
+      const bool on = !std::isnan(close[l]);
+      const size_t n = count[l];
+      double tr = true_range(n, high[l], low[l], prev_close[l]);
+      // Sum the first p ranges and average them, then Wilder's smoothing
+      double v = n < p ? value[l] + tr : (value[l] * decay + tr) / period;
+      v = n + 1 == p ? v / period : v;
+      prev_close[l] = on ? close[l] : prev_close[l];
+      value[l] = on ? v : value[l];
+    }
+    clock_.advance(close);
+  }
+
+  int period_;
+  LaneClock clock_;
+  AlignedVector<double> prev_close_;
+  AlignedVector<double> value_;
+};
+
+// ---------------------------------------------------------
+// Scalar indicator type -> batch type
+// ---------------------------------------------------------
+template <typename T> struct BatchTraits;
+template <> struct BatchTraits<SimpleMovingAverage> { using type = BatchSMA; };
+template <> struct BatchTraits<ExponentialMovingAverage> {
+  using type = BatchEMA;
+};
+template <> struct BatchTraits<RSI> { using type = BatchRSI; };
+template <> struct BatchTraits<RateOfChange> { using type = BatchROC; };
+template <> struct BatchTraits<RollingStats> {
+  using type = BatchRollingStats;
+};
+template <> struct BatchTraits<BollingerBands> { using type = BatchBollinger; };
+template <> struct BatchTraits<ATR> { using type = BatchATR; };
+
+template <typename T> using BatchOf = typename BatchTraits<T>::type;
+
+/**
+ * @brief One lane of a batch indicator, with the scalar indicator's read
+ * interface (value(), is_ready(), ...), so strategy code reads it unchanged.
+ */
+template <typename B> struct LaneRef {
+  const B *batch;
+  size_t lane;
+
+  auto value() const { return batch->value(lane); }
+  bool is_ready() const { return batch->is_ready(lane); }
+  double std_dev() const
+    requires requires(const B &b) { b.std_dev(size_t{}); }
+  {
+    return batch->std_dev(lane);
+  }
+  double zscore() const
+    requires requires(const B &b) { b.zscore(size_t{}); }
+  {
+    return batch->zscore(lane);
+  }
+};
+
+class BatchRegistryLane;
+
+/**
+ * @brief IndicatorRegistry for N symbols at once.
+ *
+ * Same (type, input, period[, param]) deduplication and typed handles as
+ * IndicatorRegistry; each slot is a batch indicator covering every lane.
+ * update() advances all slots by one cross-section (one timestamp).
+ * Strategies bind to a lane through lane(l), which offers the registration
+ * and get() interface of IndicatorRegistry.
+ */
+class BatchIndicatorRegistry {
+public:
+  explicit BatchIndicatorRegistry(size_t lanes)
+      : lanes_(lanes), last_close_(lanes, 0.0), log_return_(lanes, 0.0),
+        inputs_(3, AlignedVector<double>(lanes, BATCH_MISSING)) {}
+
+  // Registries are bound by pointer from their lanes; keep them in place.
+  BatchIndicatorRegistry(const BatchIndicatorRegistry &) = delete;
+  BatchIndicatorRegistry &operator=(const BatchIndicatorRegistry &) = delete;
+
+  size_t lanes() const { return lanes_; }
+
+  IndicatorHandle<SimpleMovingAverage> sma(IndicatorInput input, int period) {
+    return acquire<SimpleMovingAverage>(input, period, 0.0);
+  }
+  IndicatorHandle<ExponentialMovingAverage> ema(IndicatorInput input,
+                                                int period) {
+    return acquire<ExponentialMovingAverage>(input, period, 0.0);
+  }
+  IndicatorHandle<RSI> rsi(IndicatorInput input, int period) {
+    return acquire<RSI>(input, period, 0.0);
+  }
+  IndicatorHandle<RateOfChange> roc(IndicatorInput input, int period) {
+    return acquire<RateOfChange>(input, period, 0.0);
+  }
+  IndicatorHandle<RollingStats> rolling_stats(IndicatorInput input,
+                                              int period) {
+    return acquire<RollingStats>(input, period, 0.0);
+  }
+  IndicatorHandle<BollingerBands> bollinger(IndicatorInput input, int period,
+                                            double std_dev_mult) {
+    return acquire<BollingerBands>(input, period, std_dev_mult);
+  }
+  // ATR reads high/low/close of the cross-section.
+  IndicatorHandle<ATR> atr(int period) {
+    return acquire<ATR>(IndicatorInput::Close, period, 0.0);
+  }
+
+  template <typename T> const BatchOf<T> &batch(IndicatorHandle<T> h) const {
+    return slots<T>()[h.index].batch;
+  }
+  template <typename T>
+  LaneRef<BatchOf<T>> get(IndicatorHandle<T> h, size_t lane) const {
+    return {&batch(h), lane};
+  }
+
+  /**
+   * @brief Advance every slot by one timestamp. Arrays hold one value per
+   * lane; a NaN close marks a lane without a bar (all its inputs ignored).
+   */
+  void update(const double *high, const double *low, const double *close,
+              const double *volume) {
+    LaneCoverage price_cov = lane_coverage(close, lanes_);
+    if (price_cov == LaneCoverage::None)
+      return;
+
+    double *in_close = inputs_[0].data();
+    double *in_volume = inputs_[1].data();
+    double *in_log_return = inputs_[2].data();
+    for (size_t l = 0; l < lanes_; ++l) {
+      bool present = !std::isnan(close[l]);
+      bool has_log_return = present && last_close_[l] > 0;
+      double r = has_log_return ? std::log(close[l] / last_close_[l]) : 0.0;
+      if (present) {
+        log_return_[l] = r;
+        last_close_[l] = close[l];
+      }
+      in_close[l] = close[l];
+      in_volume[l] = present ? volume[l] : BATCH_MISSING;
+      in_log_return[l] = has_log_return ? r : BATCH_MISSING;
+    }
+    LaneCoverage return_cov = lane_coverage(in_log_return, lanes_);
+
+    std::apply(
+        [&](auto &...vecs) {
+          (
+              [&] {
+                for (auto &slot : vecs) {
+                  if constexpr (std::is_same_v<
+                                    std::decay_t<decltype(slot.batch)>,
+                                    BatchATR>) {
+                    slot.batch.update(high, low, close, price_cov);
+                  } else {
+                    int i = static_cast<int>(slot.input);
+                    slot.batch.update(inputs_[i].data(),
+                                      slot.input == IndicatorInput::LogReturn
+                                          ? return_cov
+                                          : price_cov);
+                  }
+                }
+              }(),
+              ...);
+        },
+        slots_);
+  }
+
+  // Most recent log return of a lane (0 before its second bar).
+  double log_return(size_t lane) const { return log_return_[lane]; }
+
+  size_t size() const {
+    return std::apply([](const auto &...vecs) { return (vecs.size() + ...); },
+                      slots_);
+  }
+
+  BatchRegistryLane lane(size_t l);
+
+private:
+  template <typename T> struct Slot {
+    IndicatorInput input;
+    int period;
+    double param;
+    BatchOf<T> batch;
+  };
+
+  template <typename T> std::vector<Slot<T>> &slots() {
+    return std::get<std::vector<Slot<T>>>(slots_);
+  }
+  template <typename T> const std::vector<Slot<T>> &slots() const {
+    return std::get<std::vector<Slot<T>>>(slots_);
+  }
+
+  template <typename T>
+  IndicatorHandle<T> acquire(IndicatorInput input, int period, double param) {
+    auto &vec = slots<T>();
+    for (size_t i = 0; i < vec.size(); ++i) {
+      if (vec[i].input == input && vec[i].period == period &&
+          vec[i].param == param)
+        return {static_cast<uint32_t>(i)};
+    }
+    if constexpr (std::is_same_v<T, BollingerBands>) {
+      vec.push_back({input, period, param, BatchOf<T>(lanes_, period, param)});
+    } else {
+      vec.push_back({input, period, param, BatchOf<T>(lanes_, period)});
+    }
+    return {static_cast<uint32_t>(vec.size() - 1)};
+  }
+
+  size_t lanes_;
+  std::tuple<std::vector<Slot<SimpleMovingAverage>>,
+             std::vector<Slot<ExponentialMovingAverage>>,
+             std::vector<Slot<RSI>>, std::vector<Slot<RateOfChange>>,
+             std::vector<Slot<RollingStats>>,
+             std::vector<Slot<BollingerBands>>, std::vector<Slot<ATR>>>
+      slots_;
+
+  AlignedVector<double> last_close_;
+  AlignedVector<double> log_return_;
+  std::vector<AlignedVector<double>> inputs_; // Indexed by IndicatorInput
+};
+
+/**
+ * @brief A BatchIndicatorRegistry seen from one symbol. Strategies templated
+ * on their registry type bind to this exactly as to an IndicatorRegistry.
+ * All lanes register the same requests, so handles are shared.
+ */
+class BatchRegistryLane {
+public:
+  BatchRegistryLane(BatchIndicatorRegistry &registry, size_t lane)
+      : registry_(&registry), lane_(lane) {}
+
+  IndicatorHandle<SimpleMovingAverage> sma(IndicatorInput input, int period) {
+    return registry_->sma(input, period);
+  }
+  IndicatorHandle<ExponentialMovingAverage> ema(IndicatorInput input,
+                                                int period) {
+    return registry_->ema(input, period);
+  }
+  IndicatorHandle<RSI> rsi(IndicatorInput input, int period) {
+    return registry_->rsi(input, period);
+  }
+  IndicatorHandle<RateOfChange> roc(IndicatorInput input, int period) {
+    return registry_->roc(input, period);
+  }
+  IndicatorHandle<RollingStats> rolling_stats(IndicatorInput input,
+                                              int period) {
+    return registry_->rolling_stats(input, period);
+  }
+  IndicatorHandle<BollingerBands> bollinger(IndicatorInput input, int period,
+                                            double std_dev_mult) {
+    return registry_->bollinger(input, period, std_dev_mult);
+  }
+  IndicatorHandle<ATR> atr(int period) { return registry_->atr(period); }
+
+  template <typename T> LaneRef<BatchOf<T>> get(IndicatorHandle<T> h) const {
+    return registry_->get(h, lane_);
+  }
+
+  double log_return() const { return registry_->log_return(lane_); }
+  size_t lane() const { return lane_; }
+
+private:
+  BatchIndicatorRegistry *registry_;
+  size_t lane_;
+};
+
+inline BatchRegistryLane BatchIndicatorRegistry::lane(size_t l) {
+  return BatchRegistryLane(*this, l);
+}
+
+} // namespace quant
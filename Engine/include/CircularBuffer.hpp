@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <bit>
 #include <cmath>
 #include <cstddef>
 #include <numeric>
@@ -9,11 +11,16 @@
 
 namespace quant {
 
+// Capacity argument selecting the runtime-sized buffer.
+inline constexpr size_t DYNAMIC_CAPACITY = 0;
+
+template <typename T, size_t N = DYNAMIC_CAPACITY> class CircularBuffer;
+
 /**
  * @brief Fixed-size circular buffer for efficient rolling window calculations.
  * Avoids data copying/shifting.
  */
-template <typename T> class CircularBuffer {
+template <typename T> class CircularBuffer<T, DYNAMIC_CAPACITY> {
 public:
   explicit CircularBuffer(size_t capacity)
       : buffer_(capacity, T()), capacity_(capacity), head_(0), count_(0) {}
@@ -28,12 +35,20 @@ public:
   T get(size_t index) const {
     if (index >= count_)
       throw std::out_of_range("Index out of bounds");
+    return (*this)[index];
+  }
+
+  // Unchecked get(): index must be < size().
+  T operator[](size_t index) const {
     // Convert logical index (0 = latest, 1 = previous) to physical index
     // physical = (head - 1 - index + capacity) % capacity
     size_t physical_idx = (head_ - 1 - index + capacity_) % capacity_;
     return buffer_[physical_idx];
   }
 
+  T back() const { return (*this)[0]; }           // Latest
+  T front() const { return (*this)[count_ - 1]; } // Oldest
+
   // Access raw buffer for vector-like operations (ordering not guaranteed to be
   // linear in memory) For simple iteration, it's better to use get() or
   // implementing iterators.
@@ -55,4 +70,93 @@ private:
   size_t count_; // Number of valid elements
 };
 
+namespace detail {
+
+/**
+ * @brief Ring over power-of-two storage: indices are masked instead of
+ * reduced with %, so push/operator[] compile to an AND and a load.
+ * The logical window (capacity) can be smaller than the storage; slots past
+ * it are simply never read.
+ */
+template <typename T, typename Storage> class MaskedRing {
+public:
+  void push(T value) {
+    buffer_[head_ & mask_] = value;
+    ++head_; // Free-running; wraps harmlessly under the mask
+    count_ += count_ < capacity_;
+  }
+
+  T get(size_t index) const {
+    if (index >= count_)
+      throw std::out_of_range("Index out of bounds");
+    return (*this)[index];
+  }
+
+  // Unchecked: 0 = latest, size() - 1 = oldest.
+  T operator[](size_t index) const { return buffer_[(head_ - 1 - index) & mask_]; }
+
+  T back() const { return (*this)[0]; }
+  T front() const { return (*this)[count_ - 1]; }
+
+  T sum() const {
+    T total = T(0);
+    for (size_t i = 0; i < count_; ++i)
+      total += (*this)[i];
+    return total;
+  }
+
+  size_t size() const { return count_; }
+  size_t capacity() const { return capacity_; }
+  bool is_full() const { return count_ == capacity_; }
+
+protected:
+  MaskedRing(Storage storage, size_t capacity)
+      : buffer_(std::move(storage)), mask_(buffer_.size() - 1),
+        capacity_(capacity) {}
+
+  Storage buffer_;
+  size_t mask_;
+  size_t capacity_;
+  size_t head_ = 0;
+  size_t count_ = 0;
+};
+
+} // namespace detail
+
+/**
+ * @brief Runtime capacity, heap storage rounded up to a power of two.
+ * Drop-in for CircularBuffer<T> in hot loops.
+ */
+template <typename T>
+class MaskedCircularBuffer
+    : public detail::MaskedRing<T, std::vector<T>> {
+public:
+  explicit MaskedCircularBuffer(size_t capacity)
+      : detail::MaskedRing<T, std::vector<T>>(
+            std::vector<T>(std::bit_ceil(capacity ? capacity : 1), T()),
+            capacity) {}
+};
+
+/**
+ * @brief Compile-time capacity with inline storage (no heap, no pointer
+ * chase). A smaller runtime window may be passed, e.g. one buffer type for
+ * any period <= N.
+ */
+template <typename T, size_t N>
+class CircularBuffer
+    : public detail::MaskedRing<T, std::array<T, std::bit_ceil(N)>> {
+  using Base = detail::MaskedRing<T, std::array<T, std::bit_ceil(N)>>;
+
+public:
+  CircularBuffer() : CircularBuffer(N) {}
+  explicit CircularBuffer(size_t capacity) : Base({}, check(capacity)) {}
+
+private:
+  static size_t check(size_t capacity) {
+    if (capacity > N)
+      throw std::invalid_argument("CircularBuffer capacity exceeds N");
+    return capacity;
+  }
+};
+
 } // namespace quant
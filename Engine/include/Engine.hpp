@@ -1,171 +1,743 @@
 #pragma once
 
+#include "AllocationCounter.hpp"
+#include "EquityTracker.hpp"
+#include "EventJournal.hpp"
 #include "ExecutionEngine.hpp"
 #include "MarketDataManager.hpp"
+#include "Performance.hpp"
+#include "Pipeline.hpp"
+#include "PositionSizing.hpp"
 #include "RiskManager.hpp"
+#include "SessionIndex.hpp"
+#include "StageTimer.hpp"
 #include "Strategies.hpp"
+#include "Warmup.hpp"
 #include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 
 namespace quant {
 
+constexpr double INITIAL_CAPITAL = 100000.0; // 100k Capital
+// Limit: 20 Trades/Day (for 1-min data)
+constexpr RiskConfig DEFAULT_RISK_CONFIG = {2.0, 0.10, 20, 5};
+
+// ---------------------------------------------------------
+// Result of one backtest over one symbol
+// ---------------------------------------------------------
+struct BacktestResult {
+  std::string symbol;
+  size_t bars_processed = 0;
+  double elapsed_ms = 0.0; // Event loop only (excludes data loading)
+  PerformanceReport report;
+  std::vector<Trade> trades;
+  RegimeStats regimes; // Bars / episodes per regime over the run
+  EquityCurve equity_curve; // Per bar; see set_record_equity()
+  StopPath stop_path;       // Per bar in a position; see set_record_stops()
+};
+
 class Engine {
 public:
-  Engine()
-      : risk_manager_(
-            {2.0, 0.10, 20, 5}),    // Limit: 20 Trades/Day (for 1-min data)
-        execution_engine_(100000.0) // 100k Capital
-  {}
+  Engine() : Engine(std::make_shared<MarketDataManager>()) {}
+
+  // Share one data store between engines (e.g. one Engine per symbol/thread).
+  // Engine::run_backtest only reads from it.
+  explicit Engine(std::shared_ptr<MarketDataManager> market_data)
+      : market_data_(std::move(market_data)),
+        risk_manager_(DEFAULT_RISK_CONFIG),
+        execution_engine_(INITIAL_CAPITAL) {}
 
   void load_data(const std::string &symbol, const std::string &filepath) {
-    if (market_data_.load_csv(symbol, filepath)) {
+    if (market_data_->load_csv(symbol, filepath)) {
       symbol_ = symbol;
     }
   }
 
+  // Access to the data layer, e.g. to set a symbol's exchange UTC offset
+  // before load_data().
+  MarketDataManager &market_data() { return *market_data_; }
+
+  // Strategy parameters used by subsequent runs (defaults = Strategies.hpp
+  // constants).
+  void set_strategy_params(const StrategyParams &params) { params_ = params; }
+  const StrategyParams &strategy_params() const { return params_; }
+
   void run() {
     if (symbol_.empty()) {
       std::cerr << "No data loaded!" << std::endl;
       return;
     }
 
-    const auto &bars = market_data_.get_bars(symbol_);
-    std::cout << "Starting Backtest on " << symbol_ << " (" << bars.size()
-              << " bars)..." << std::endl;
+    std::cout << "Starting Backtest on " << symbol_ << " ("
+              << market_data_->get_bars(symbol_).size() << " bars)..."
+              << std::endl;
 
-    // Reset Components
-    regime_strategy_ = std::make_unique<RegimeStrategy>();
-    momentum_strategy_ = std::make_unique<MomentumStrategy>();
-    mean_reversion_strategy_ = std::make_unique<MeanReversionStrategy>();
+    BacktestResult result = run_backtest(symbol_);
+    double bars_per_sec =
+        result.elapsed_ms > 0
+            ? result.bars_processed / result.elapsed_ms * 1000.0
+            : 0.0;
 
-    // Start Timer
-    auto start_time = std::chrono::high_resolution_clock::now();
+    std::cout << "\n[BENCHMARK] Processed " << result.bars_processed
+              << " bars in " << result.elapsed_ms << " ms (" << std::fixed
+              << std::setprecision(0) << bars_per_sec << " bars/sec)\n";
 
-    // Main Event Loop
-    for (const auto &bar : bars) {
+    // Final Reporting
+    print_report(result.report);
+    print_regime_stats(result.regimes);
+    if (!journal_path_.empty())
+      std::cout << "[JOURNAL] " << result.bars_processed << " bars -> "
+                << journal_path_ << "\n";
+
+    if constexpr (STAGE_TIMING) {
+      stage_profile_->print();
+      if (!stage_trace_path_.empty()) {
+        if (stage_profile_->write_chrome_trace(stage_trace_path_))
+          std::cout << "[STAGES] " << stage_profile_->trace_events()
+                    << " trace events -> " << stage_trace_path_ << "\n";
+        else
+          std::cerr << "Could not write " << stage_trace_path_ << std::endl;
+      }
+    }
+  }
 
-      // 1. Process Fills (Orders from previous bar execute at Open)
-      execution_engine_.on_bar_open(bar);
+  /**
+   * @brief Run the full strategy/risk/execution stack over one symbol without
+   * printing. All per-run state is reset first, so one Engine can be reused.
+   */
+  BacktestResult run_backtest(const std::string &symbol) {
+    BacktestResult result =
+        run_bars(std::span<const Bar>(market_data_->get_bars(symbol)),
+                 market_data_->get_sessions(symbol));
+    result.symbol = symbol;
+    return result;
+  }
 
-      // 2. Intra-bar Risk Check (Stops/Targets hit during High/Low?)
-      if (execution_engine_.is_invested()) {
-        if (risk_manager_.check_exit(bar)) {
-          execution_engine_.close_position();
-          risk_manager_.on_exit(false); // Stop hit = Loss (mostly)
-          // std::cout << "STOP HIT at " << bar.timestamp << std::endl;
-        }
-      }
+  // Same by interned id (MarketDataManager::intern / symbol_id).
+  BacktestResult run_backtest(SymbolId id) {
+    BacktestResult result =
+        run_bars(std::span<const Bar>(market_data_->get_bars(id)),
+                 market_data_->get_sessions(id));
+    result.symbol = market_data_->symbol_name(id);
+    return result;
+  }
+
+  /**
+   * @brief Same as above over an arbitrary bar range (e.g. a shared series
+   * in a parameter sweep). The bars are only read; their session index is
+   * derived with session_utc_offset().
+   */
+  BacktestResult run_backtest(std::span<const Bar> bars) {
+    return run_bars(bars, SessionIndex::from_bars(bars, session_offset_));
+  }
 
-      // 3. Update Strategies (End of Bar)
-      regime_strategy_->on_bar(bar);
-      momentum_strategy_->on_bar(bar);
-      mean_reversion_strategy_->on_bar(bar);
+  /**
+   * @brief Same, on a caller-owned strategy stack that keeps whatever
+   * indicator / strategy state it holds (e.g. a snapshot restored at a
+   * walk-forward boundary) and is left as of the last bar. Risk, execution
+   * and equity state start fresh; strategy params and factories of this
+   * Engine are not used.
+   */
+  template <typename Stack>
+  BacktestResult run_backtest(std::span<const Bar> bars, Stack &stack) {
+    if (bars.empty())
+      return {};
+    start_run();
+    bind_sizing(stack);
+    return run_loop(bars, SessionIndex::from_bars(bars, session_offset_),
+                    stack);
+  }
 
-      std::string regime = regime_strategy_->regime();
+  /**
+   * @brief Backtest only bars [begin, end) of a longer series (e.g. a short
+   * test window in a sweep). The stack is warmed on the bars before begin
+   * per plan_warmup() and warmup_config(): indicators seeded in bulk from
+   * their lookback, then the last few bars replayed without trading, instead
+   * of replaying everything from bar 0. Trades, report and sessions are
+   * those of run_backtest(bars.subspan(begin, end - begin)) on the warm
+   * stack.
+   */
+  BacktestResult run_window(std::span<const Bar> bars, size_t begin,
+                            size_t end) {
+    end = std::min(end, bars.size());
+    if (begin >= end)
+      return {};
+    auto window = bars.subspan(begin, end - begin);
+    auto run = [&](auto &stack) {
+      bind_sizing(stack); // Sizing indicators warm with the rest
+      warm_up(stack, bars, plan_warmup(stack, begin, warmup_config_));
+      return run_backtest(window, stack);
+    };
+    if (dispatch_mode_ == DispatchMode::Virtual || trend_factory_ ||
+        range_factory_) {
+      DynamicStrategyStack stack(params_, trend_factory_, range_factory_,
+                                 allocation_);
+      return run(stack);
+    }
+    StaticStrategyStack<> stack(params_, allocation_);
+    return run(stack);
+  }
 
-      // 4. Generate Signals & Position Sizing
-      int signal = 0;
+  // Warm-up used by run_window() (default: WarmupConfig{}).
+  void set_warmup_config(const WarmupConfig &config) {
+    warmup_config_ = config;
+  }
+  const WarmupConfig &warmup_config() const { return warmup_config_; }
+
+  /**
+   * @brief Same over columnar bars (BarSeries::columns() or external
+   * buffers such as NumPy arrays). Rows are gathered one at a time, so the
+   * columns are never copied. Throws std::invalid_argument if the column
+   * lengths differ.
+   */
+  BacktestResult run_backtest(const BarColumns &bars) {
+    if (!bars.consistent())
+      throw std::invalid_argument("run_backtest: bar columns differ in length");
+    return run_bars(bars, SessionIndex(bars.timestamp, session_offset_));
+  }
+
+  // Exchange offset (seconds ahead of UTC) defining trading days for runs
+  // over raw bars / columns and for on_bar(); symbol runs use the index
+  // MarketDataManager built with the symbol's offset. Default 0 (UTC).
+  void set_session_utc_offset(int64_t seconds) { session_offset_ = seconds; }
+  int64_t session_utc_offset() const { return session_offset_; }
+
+  // Close any position at the close of each day's last bar (and take no new
+  // entry on it), instead of carrying it overnight. Off by default.
+  void set_flatten_at_close(bool enabled) { flatten_at_close_ = enabled; }
+
+  // Risk limits used by subsequent runs (default = DEFAULT_RISK_CONFIG).
+  void set_risk_config(const RiskConfig &config) { risk_config_ = config; }
+  const RiskConfig &risk_config() const { return risk_config_; }
+
+  // Fill policy, slippage, fees and volume participation for subsequent
+  // runs (default: next-bar open, frictionless).
+  void set_fill_config(const FillConfig &config) { fill_config_ = config; }
+  const FillConfig &fill_config() const { return fill_config_; }
+
+  // Record BacktestResult::equity_curve (equity / drawdown columns, one row
+  // per bar, preallocated for the run); off by default. Drawdown, Sharpe
+  // and Sortino are tracked either way.
+  void set_record_equity(bool enabled) { record_equity_ = enabled; }
+
+  // Record BacktestResult::stop_path: every open position's stop level per
+  // bar (preallocated for the run); off by default. Each Trade carries its
+  // initial and last stop either way.
+  void set_record_stops(bool enabled) { record_stops_ = enabled; }
+
+  /**
+   * @brief Journal every subsequent run to `path` (orders, fills, stops,
+   * exits and a per-bar signal / regime / equity record, with periodic
+   * state snapshots; see EventJournal.hpp). Each run overwrites the file;
+   * an empty path turns journalling off. The file is written by a
+   * background thread and finished when the run ends; start_run() throws
+   * std::runtime_error if it cannot be created.
+   */
+  void set_journal(std::string path, const JournalConfig &config = {}) {
+    journal_path_ = std::move(path);
+    journal_config_ = config;
+  }
+
+  // -------------------------------------------------------
+  // Capital and position sizing
+  // -------------------------------------------------------
+  // Starting cash of subsequent runs (default INITIAL_CAPITAL); reports
+  // and the drawdown limit are relative to it.
+  void set_initial_capital(double capital) { initial_capital_ = capital; }
+  double initial_capital() const { return initial_capital_; }
+
+  // How entries are sized (default: 20% of initial capital, see
+  // PositionSizing.hpp).
+  void set_position_sizing(const SizingConfig &config) { sizing_ = config; }
+  const SizingConfig &position_sizing() const { return sizing_; }
+
+  /**
+   * @brief Register the sizing mode's indicator in `stack`'s registry and
+   * size from it (PositionSizer::bind). Runs bind the stacks they use;
+   * drivers that step() their own stacks call this after start_run() and
+   * before the stack's first bar, so the indicator sees every bar the stack
+   * does (and warms / snapshots with it).
+   */
+  template <typename Stack> void bind_sizing(Stack &stack) {
+    sizer_ = PositionSizer(sizing_);
+    sizer_.bind(stack.registry());
+  }
+
+  /**
+   * @brief Size entries against a shared portfolio instead of this
+   * engine's own capital: capital from `budget`, notional clamped to its
+   * long / short limits (see Portfolio). The budget is owned by the caller
+   * and updated between bars; nullptr restores standalone sizing.
+   */
+  void set_portfolio_budget(const PortfolioBudget *budget) {
+    budget_ = budget;
+  }
+
+  // This run's cash / position as of `price`, for portfolio reconciliation.
+  PositionState position_state(double price) const {
+    PositionState state;
+    state.cash = execution_engine_.get_cash();
+    state.quantity = execution_engine_.get_position();
+    state.price = price;
+    if (state.quantity == 0)
+      state.pending = execution_engine_.order_book().quantity() * price;
+    return state;
+  }
+
+  // -------------------------------------------------------
+  // Allocation-free hot loop
+  // -------------------------------------------------------
+  /**
+   * @brief Keep closed trades in a TradeLog of `capacity` preallocated
+   * records, spilled to `spill_path` when full (see TradeLog). capacity 0
+   * restores the default growing log.
+   */
+  void set_trade_log(size_t capacity, std::string spill_path = {}) {
+    trade_log_capacity_ = capacity;
+    trade_log_spill_path_ = std::move(spill_path);
+  }
+
+  /**
+   * @brief Throw std::runtime_error when the bar loop (or one on_bar call)
+   * heap-allocates. Needs a QUANT_COUNT_ALLOCATIONS build; a no-op
+   * otherwise (see ALLOCATION_COUNTING).
+   */
+  void set_fail_on_allocation(bool enabled) { fail_on_allocation_ = enabled; }
+
+  /**
+   * @brief Per-stage timing of the last run (fills, check_exit, indicators,
+   * each strategy's on_bar, signal, orders, equity; see StageTimer.hpp).
+   * Only QUANT_STAGE_TIMING builds time anything; otherwise null.
+   */
+  const StageProfile *stage_profile() const { return stage_profile_.get(); }
+
+  /**
+   * @brief Also keep a trace of every `every_nth_bar`-th bar's stages (up
+   * to `max_events` slices, preallocated per run). run() writes it to
+   * `path` as Chrome trace JSON; otherwise use
+   * stage_profile()->write_chrome_trace(). Timing builds only.
+   */
+  void set_stage_trace(std::string path, size_t max_events = 1 << 20,
+                       size_t every_nth_bar = 1) {
+    stage_trace_path_ = std::move(path);
+    stage_trace_events_ = max_events;
+    stage_trace_every_ = every_nth_bar;
+  }
+
+  // Static: built-in strategies composed at compile time (default, fastest).
+  // Virtual: every strategy called through the Strategy interface.
+  enum class DispatchMode { Static, Virtual };
+  void set_dispatch_mode(DispatchMode mode) { dispatch_mode_ = mode; }
+
+  // Plug a custom Strategy into the trend (LV/HV_TREND) or range (LV_RANGE)
+  // slot; runs then take the virtual path. Pass nullptr to restore built-ins.
+  void set_trend_strategy(StrategyFactory factory) {
+    trend_factory_ = std::move(factory);
+  }
+  void set_range_strategy(StrategyFactory factory) {
+    range_factory_ = std::move(factory);
+  }
+
+  // Regime -> strategy routing and per-regime size scaling (default =
+  // allocator.py legacy mode).
+  void set_regime_allocation(const RegimeAllocation &allocation) {
+    allocation_ = allocation;
+  }
+  const RegimeAllocation &regime_allocation() const { return allocation_; }
+
+  void print_performance_report(double current_price) {
+    print_report(make_report(execution_engine_.get_trades(), current_price));
+  }
+
+  // -------------------------------------------------------
+  // Stepwise driving (one bar at a time)
+  // -------------------------------------------------------
+  // run_backtest() is start_run(), step() per bar, finish_run(). Drivers
+  // that interleave many engines (MultiSymbolRunner::run_batched) call the
+  // three directly with their own stack per engine.
+
+  // Reset risk and execution state for a new run.
+  void start_run() {
+    if constexpr (STAGE_TIMING) {
+      if (!stage_profile_)
+        stage_profile_ = std::make_unique<StageProfile>();
+      stage_profile_->reset();
+      if (stage_trace_events_ > 0)
+        stage_profile_->enable_trace(stage_trace_events_, stage_trace_every_);
+    }
+    risk_manager_ = RiskManager(risk_config_);
+    sizer_ = PositionSizer(sizing_);
+    equity_tracker_.reset(initial_capital_);
+    execution_engine_ =
+        ExecutionEngine(initial_capital_,
+                        trade_log_capacity_ > 0
+                            ? TradeLog(trade_log_capacity_,
+                                       trade_log_spill_path_)
+                            : TradeLog(),
+                        fill_config_);
+    close_journal();
+    if (!journal_path_.empty())
+      journal_ = std::make_unique<JournalWriter>(
+          journal_path_, initial_capital_, journal_config_);
+    execution_engine_.set_journal(journal_.get());
+  }
 
-      // Allocation Logic (from allocator.py)
-      if (regime == "LV_TREND" || regime == "HV_TREND") {
-        signal = momentum_strategy_->signal();
-      } else if (regime == "LV_RANGE") {
-        signal = mean_reversion_strategy_->signal();
-      } else {
-        // HV_RANGE -> Cash
-        signal = 0;
+  /**
+   * @brief Process one bar: fills, stops, stack.on_bar(bar), then entry/exit
+   * on the stack's signal. `session` is the bar's SessionIndex entry.
+   * Instantiated once per strategy stack type.
+   */
+  template <typename Stack>
+  void step(const Bar &bar, SessionInfo session, Stack &stack,
+            BacktestResult &result) {
+#ifdef QUANT_STAGE_TIMING
+    StageStep stage_step(stage_profile_.get());
+#endif
+    JournalWriter *const journal = journal_.get();
+    if (journal)
+      journal->begin_bar(static_cast<uint32_t>(result.bars_processed),
+                         bar.timestamp);
+
+    // 1. Process Fills (orders from previous bars, per the fill policy)
+    {
+      QUANT_STAGE_SCOPE(Stage::Fills);
+      execution_engine_.on_bar_open(bar);
+    }
+
+    // 2. Intra-bar Risk Check (Stops/Targets hit during High/Low?)
+    if (execution_engine_.is_invested() && risk_manager_.active()) {
+      QUANT_STAGE_SCOPE(Stage::RiskExit);
+      const bool stopped = risk_manager_.check_exit(bar);
+      execution_engine_.set_stops(risk_manager_.initial_stop(),
+                                  risk_manager_.stop());
+      if (journal)
+        journal->stop(risk_manager_.stop(), risk_manager_.initial_stop());
+      if (record_stops_)
+        result.stop_path.push_back(
+            bar.timestamp,
+            static_cast<uint32_t>(execution_engine_.trade_log().size()),
+            risk_manager_.stop());
+      if (stopped) {
+        if (journal)
+          journal->exit(ExitReason::Stop, position_side());
+        execution_engine_.close_position();
+        risk_manager_.on_exit(false); // Stop hit = Loss (mostly)
+        // std::cout << "STOP HIT at " << bar.timestamp << std::endl;
       }
+    }
+
+    // 3. Update Strategies (End of Bar): shared indicators first, once each.
+    // The stack times its indicator and per-strategy stages itself.
+    stack.on_bar(bar);
+
+    // 4. Generate Signals & Position Sizing (regime allocation)
+    Regime regime;
+    int signal;
+    {
+      QUANT_STAGE_SCOPE(Stage::Signal);
+      regime = stack.regime();
+      result.regimes.record(regime);
+      signal = stack.signal();
+    }
 
-      // 5. Execution Logic (if not already in position)
-      if (signal != 0 && !execution_engine_.is_invested()) {
-        if (risk_manager_.can_enter(bar.timestamp)) {
-          // Calculate Allocation (e.g., fixed fractional or fixed size)
-          double alloc_amt = 100000.0 * 0.20; // Reduced to 20%
+    // 5. Execution Logic (if not already in position)
+    {
+      QUANT_STAGE_SCOPE(Stage::Orders);
+      const bool closing_bar = flatten_at_close_ && session.last_of_day();
+      if (signal != 0 && !execution_engine_.is_invested() &&
+          !execution_engine_.has_working_orders()) {
+        // Stop distance: the stack's ATR (NaN, so no entry, until ready)
+        const double stop_atr = stack.stop_atr();
+        if (!closing_bar && stop_atr > 0 &&
+            risk_manager_.can_enter(session.day)) {
+          // Calculate Allocation (sizing mode, then portfolio limits)
+          double alloc_amt =
+              sizer_.notional(budget_ ? budget_->capital : initial_capital_,
+                              bar.close, allocation_[regime].size_scale,
+                              stack.registry());
+          if (budget_)
+            alloc_amt = budget_->clamp(signal, alloc_amt);
           double qty = alloc_amt / bar.close;
 
-          execution_engine_.submit_order(signal, qty);
+          if (qty > 0) {
+            execution_engine_.submit_order(signal, qty, bar.timestamp);
 
-          risk_manager_.on_entry(bar.close, bar.close * 0.01,
-                                 signal); // Dummy ATR
+            risk_manager_.on_entry(bar.close, stop_atr, signal);
+            execution_engine_.set_stops(risk_manager_.initial_stop(),
+                                        risk_manager_.stop());
+            if (journal)
+              journal->stop(risk_manager_.stop(), risk_manager_.initial_stop());
+          }
         }
       } else if (signal == 0 && execution_engine_.is_invested()) {
+        if (journal)
+          journal->exit(ExitReason::Signal, position_side());
         execution_engine_.close_position();
         risk_manager_.on_exit(true); // Normal exit
       }
 
+      // Session close: flatten at this bar's close
+      if (closing_bar && execution_engine_.is_invested()) {
+        if (journal)
+          journal->exit(ExitReason::SessionClose, position_side());
+        execution_engine_.close_now(bar.timestamp, bar.close);
+        risk_manager_.on_exit(true);
+      }
+
       // Update Churn Cooldown
       risk_manager_.update_cooldown();
     }
+    ++result.bars_processed;
+
+    // 6. Mark to market; breaching max_drawdown_limit halts trading
+    QUANT_STAGE_SCOPE(Stage::Equity);
+    double equity = execution_engine_.get_equity(bar.close);
+    if (record_equity_)
+      equity_tracker_.update(bar.timestamp, equity, result.equity_curve);
+    else
+      equity_tracker_.update(equity);
+
+    if (risk_manager_.check_drawdown(equity_tracker_.drawdown())) {
+      execution_engine_.cancel_all_orders();
+      if (execution_engine_.is_invested()) {
+        if (journal)
+          journal->exit(ExitReason::Drawdown, position_side());
+        execution_engine_.close_position();
+        risk_manager_.on_exit(false);
+      }
+    }
+    if (journal)
+      journal->end_bar(signal, regime, bar.close, equity,
+                       execution_engine_.get_position());
+  }
+
+  // Fill the report and trade log; open positions are marked at last_close.
+  void finish_run(BacktestResult &result, double last_close) {
+    result.trades = execution_engine_.get_trades();
+    result.report = make_report(result.trades, last_close);
+    close_journal();
+  }
+
+  // -------------------------------------------------------
+  // Streaming (live bars)
+  // -------------------------------------------------------
+  // The same stack, risk and execution path as run_backtest(), one bar per
+  // on_bar() call. The stack is built once in start_stream(); on_bar() then
+  // does no setup work of its own.
+
+  // Begin a new stream (resets risk / execution state, builds the stack for
+  // the current dispatch mode and strategy factories). expected_bars sizes
+  // the equity curve when it is recorded.
+  void start_stream(size_t expected_bars = 0) {
+    start_run();
+    stream_result_ = BacktestResult{};
+    stream_result_.symbol = symbol_;
+    if (record_equity_)
+      stream_result_.equity_curve.reserve(expected_bars);
+    if (record_stops_)
+      stream_result_.stop_path.reserve(expected_bars);
+    stream_static_.reset();
+    stream_dynamic_.reset();
+    if (dispatch_mode_ == DispatchMode::Virtual || trend_factory_ ||
+        range_factory_) {
+      stream_dynamic_ = std::make_unique<DynamicStrategyStack>(
+          params_, trend_factory_, range_factory_, allocation_);
+    } else {
+      stream_static_ =
+          std::make_unique<StaticStrategyStack<>>(params_, allocation_);
+    }
+    if (stream_static_)
+      bind_sizing(*stream_static_);
+    else
+      bind_sizing(*stream_dynamic_);
+    stream_last_close_ = 0.0;
+    stream_sessions_ = SessionTracker(session_offset_);
+  }
+
+  bool streaming() const { return stream_static_ || stream_dynamic_; }
+
+  /**
+   * @brief Process one live bar and return the stack's signal for it
+   * (1 / -1 / 0). Starts a stream on first use. The trading day comes from
+   * session_utc_offset(); a live bar is never known to be the day's last,
+   * so flatten_at_close needs the overload below.
+   */
+  int on_bar(const Bar &bar) {
+    if (!streaming())
+      start_stream();
+    return on_bar(bar, stream_sessions_.next(bar.timestamp));
+  }
+
+  // Same, with the session flags supplied by the feed (e.g. LAST_OF_DAY
+  // from the exchange calendar).
+  int on_bar(const Bar &bar, SessionInfo session) {
+    if (!streaming())
+      start_stream();
+    stream_last_close_ = bar.close;
+    AllocationScope allocations;
+    int signal;
+    if (stream_static_) {
+      step(bar, session, *stream_static_, stream_result_);
+      signal = stream_static_->signal();
+    } else {
+      step(bar, session, *stream_dynamic_, stream_result_);
+      signal = stream_dynamic_->signal();
+    }
+    check_allocations(allocations, "on_bar");
+    return signal;
+  }
+
+  // End the stream: report and trades as of the last bar (open positions
+  // marked at its close).
+  BacktestResult finish_stream() {
+    BacktestResult result = std::move(stream_result_);
+    if (result.bars_processed > 0)
+      finish_run(result, stream_last_close_);
+    close_journal();
+    stream_static_.reset();
+    stream_dynamic_.reset();
+    stream_result_ = BacktestResult{};
+    return result;
+  }
+
+private:
+  // Bars: std::span<const Bar> or BarColumns (anything with size() / [i]).
+  template <typename Bars>
+  BacktestResult run_bars(const Bars &bars, const SessionIndex &sessions) {
+    if (bars.empty())
+      return {};
+    if (sessions.size() != bars.size())
+      throw std::invalid_argument("run_backtest: session index size mismatch");
+
+    start_run();
+
+    if (dispatch_mode_ == DispatchMode::Virtual || trend_factory_ ||
+        range_factory_) {
+      DynamicStrategyStack stack(params_, trend_factory_, range_factory_,
+                                 allocation_);
+      bind_sizing(stack);
+      return run_loop(bars, sessions, stack);
+    }
+    StaticStrategyStack<> stack(params_, allocation_);
+    bind_sizing(stack);
+    return run_loop(bars, sessions, stack);
+  }
+
+  template <typename Bars, typename Stack>
+  BacktestResult run_loop(const Bars &bars, const SessionIndex &sessions,
+                          Stack &stack) {
+    BacktestResult result;
+    if (record_equity_)
+      result.equity_curve.reserve(bars.size());
+    if (record_stops_)
+      result.stop_path.reserve(bars.size());
+
+    // Start Timer
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    // Main Event Loop
+    AllocationScope allocations;
+    for (size_t i = 0; i < bars.size(); ++i)
+      step(bars[i], sessions[i], stack, result);
+    check_allocations(allocations, "bar loop");
 
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(
                            end_time - start_time)
                            .count();
-    double duration_ms = duration_us / 1000.0;
-    double bars_per_sec = (bars.size() / duration_ms) * 1000.0;
 
-    std::cout << "\n[BENCHMARK] Processed " << bars.size() << " bars in "
-              << duration_ms << " ms (" << std::fixed << std::setprecision(0)
-              << bars_per_sec << " bars/sec)\n";
+    result.elapsed_ms = duration_us / 1000.0;
+    finish_run(result, bars[bars.size() - 1].close);
+    return result;
+  }
 
-    // Final Reporting
-    print_performance_report(bars.back().close);
+  // Trade statistics plus the equity tracker's drawdown / ratios.
+  PerformanceReport make_report(const std::vector<Trade> &trades,
+                                double last_close) const {
+    PerformanceReport report = summarize_trades(
+        trades, initial_capital_, execution_engine_.get_equity(last_close));
+    report.max_drawdown_pct = equity_tracker_.max_drawdown() * 100.0;
+    report.sharpe = equity_tracker_.sharpe();
+    report.sortino = equity_tracker_.sortino();
+    report.halted = risk_manager_.halted();
+    return report;
   }
 
-  void print_performance_report(double current_price) {
-    double final_equity = execution_engine_.get_equity(current_price);
-    double total_return = (final_equity - 100000.0) / 100000.0 * 100.0;
-
-    const auto &trades = execution_engine_.get_trades();
-    int total_trades = trades.size();
-    int winning_trades = 0;
-    double gross_profit = 0.0;
-    double gross_loss = 0.0;
-
-    for (const auto &t : trades) {
-      if (t.pnl > 0) {
-        winning_trades++;
-        gross_profit += t.pnl;
-      } else {
-        gross_loss += std::abs(t.pnl);
-      }
-    }
+  int position_side() const {
+    return execution_engine_.get_position() > 0 ? 1 : -1;
+  }
 
-    double win_rate =
-        total_trades > 0 ? (double)winning_trades / total_trades * 100.0 : 0.0;
-    double profit_factor = gross_loss > 0 ? gross_profit / gross_loss : 99.9;
-
-    std::cout << "\n==========================================\n";
-    std::cout << "          PERFORMANCE REPORT              \n";
-    std::cout << "==========================================\n";
-    std::cout << "Final Equity:   " << std::fixed << std::setprecision(2)
-              << final_equity << "\n";
-    std::cout << "Total Return:   " << total_return << "%\n";
-    std::cout << "------------------------------------------\n";
-    std::cout << "Total Trades:   " << total_trades << "\n";
-    std::cout << "Win Rate:       " << win_rate << "%\n";
-    std::cout << "Profit Factor:  " << profit_factor << "\n";
-    std::cout << "Gross Profit:   " << gross_profit << "\n";
-    std::cout << "Gross Loss:     " << -gross_loss << "\n";
-    std::cout << "==========================================\n";
+  // Finish the current run's journal file, if any.
+  void close_journal() {
+    if (!journal_)
+      return;
+    execution_engine_.set_journal(nullptr);
+    const bool written = journal_->close();
+    journal_.reset();
+    if (!written)
+      throw std::runtime_error("Engine: could not write journal " +
+                               journal_path_);
   }
 
-private:
-  MarketDataManager market_data_;
+  void check_allocations(const AllocationScope &scope, const char *where) {
+    if constexpr (ALLOCATION_COUNTING) {
+      if (fail_on_allocation_ && scope.count() > 0)
+        throw std::runtime_error("Engine: " + std::to_string(scope.count()) +
+                                 " heap allocation(s) in " + where);
+    }
+  }
+
+  std::shared_ptr<MarketDataManager> market_data_;
   std::string symbol_;
+  StrategyParams params_;
+  RiskConfig risk_config_ = DEFAULT_RISK_CONFIG;
+  FillConfig fill_config_;
+  bool record_equity_ = false;
+  bool record_stops_ = false;
+  size_t trade_log_capacity_ = 0;
+  std::string trade_log_spill_path_;
+  bool fail_on_allocation_ = false;
+  int64_t session_offset_ = 0;
+  bool flatten_at_close_ = false;
+  double initial_capital_ = INITIAL_CAPITAL;
+  SizingConfig sizing_;
+  const PortfolioBudget *budget_ = nullptr;
+  std::string journal_path_;
+  JournalConfig journal_config_;
 
   // Components
   RiskManager risk_manager_;
   ExecutionEngine execution_engine_;
-
-  // Strategies
-  std::unique_ptr<RegimeStrategy> regime_strategy_;
-  std::unique_ptr<MomentumStrategy> momentum_strategy_;
-  std::unique_ptr<MeanReversionStrategy> mean_reversion_strategy_;
+  EquityTracker equity_tracker_;
+  PositionSizer sizer_;
+  std::unique_ptr<JournalWriter> journal_; // Current run's (set_journal)
+
+  // Strategy composition
+  RegimeAllocation allocation_ = RegimeAllocation::legacy();
+  DispatchMode dispatch_mode_ = DispatchMode::Static;
+  StrategyFactory trend_factory_;
+  StrategyFactory range_factory_;
+  WarmupConfig warmup_config_;
+
+  // Stage timing (QUANT_STAGE_TIMING builds only; created by start_run)
+  std::unique_ptr<StageProfile> stage_profile_;
+  size_t stage_trace_events_ = 0;
+  size_t stage_trace_every_ = 1;
+  std::string stage_trace_path_;
+
+  // Streaming state (start_stream .. finish_stream)
+  std::unique_ptr<StaticStrategyStack<>> stream_static_;
+  std::unique_ptr<DynamicStrategyStack> stream_dynamic_;
+  BacktestResult stream_result_;
+  double stream_last_close_ = 0.0;
+  SessionTracker stream_sessions_;
 };
 
 } // namespace quant
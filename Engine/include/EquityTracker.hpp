@@ -0,0 +1,142 @@
+#pragma once
+
+#include "BarSeries.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+
+namespace quant {
+
+// 1-minute bars: 375 per NSE session x 252 sessions.
+inline constexpr double BARS_PER_YEAR_1MIN = 375.0 * 252.0;
+
+// Mark-to-market equity at a bar's close (one row of an EquityCurve)
+struct EquityPoint {
+  int64_t timestamp;
+  double equity;
+  double drawdown; // Fraction below the running peak, >= 0
+};
+
+/**
+ * @brief Per-bar equity and drawdown columns (structure-of-arrays).
+ */
+class EquityCurve {
+public:
+  void reserve(size_t n) {
+    timestamp_.reserve(n);
+    equity_.reserve(n);
+    drawdown_.reserve(n);
+  }
+
+  void push_back(int64_t ts, double equity, double drawdown) {
+    timestamp_.push_back(ts);
+    equity_.push_back(equity);
+    drawdown_.push_back(drawdown);
+  }
+
+  size_t size() const { return equity_.size(); }
+  bool empty() const { return equity_.empty(); }
+  void clear() {
+    timestamp_.clear();
+    equity_.clear();
+    drawdown_.clear();
+  }
+
+  EquityPoint operator[](size_t i) const {
+    return {timestamp_[i], equity_[i], drawdown_[i]};
+  }
+  EquityPoint back() const { return (*this)[size() - 1]; }
+
+  std::span<const int64_t> timestamps() const { return timestamp_; }
+  std::span<const double> equity() const { return equity_; }
+  std::span<const double> drawdown() const { return drawdown_; }
+
+private:
+  AlignedVector<int64_t> timestamp_;
+  AlignedVector<double> equity_;
+  AlignedVector<double> drawdown_;
+};
+
+/**
+ * @brief Incremental equity statistics, one update() per bar.
+ *
+ * Tracks the running peak, current / max drawdown and per-bar simple
+ * returns, from which Sharpe and Sortino follow in O(1) at any point; no
+ * second pass over the curve. Per-bar returns are small and centred near
+ * zero, so plain sums of r and r^2 keep full precision. update() is two
+ * divisions and a handful of adds; the optional EquityCurve write is
+ * three stores into preallocated columns.
+ */
+class EquityTracker {
+public:
+  explicit EquityTracker(double initial_equity = 0.0) { reset(initial_equity); }
+
+  void reset(double initial_equity) {
+    peak_ = last_ = initial_equity;
+    drawdown_ = max_drawdown_ = 0.0;
+    count_ = 0;
+    sum_ = sum_sq_ = downside_sq_ = 0.0;
+  }
+
+  void update(double equity) {
+    const double r = last_ != 0.0 ? equity / last_ - 1.0 : 0.0;
+    ++count_;
+    sum_ += r;
+    sum_sq_ += r * r;
+    downside_sq_ += r < 0.0 ? r * r : 0.0;
+    last_ = equity;
+
+    peak_ = std::max(peak_, equity);
+    drawdown_ = peak_ > 0.0 ? (peak_ - equity) / peak_ : 0.0;
+    max_drawdown_ = std::max(max_drawdown_, drawdown_);
+  }
+
+  // update() plus one row appended to `curve`.
+  void update(int64_t ts, double equity, EquityCurve &curve) {
+    update(equity);
+    curve.push_back(ts, equity, drawdown_);
+  }
+
+  double equity() const { return last_; }
+  double peak() const { return peak_; }
+  double drawdown() const { return drawdown_; }
+  double max_drawdown() const { return max_drawdown_; }
+  size_t count() const { return count_; }
+
+  double mean_return() const { return count_ ? sum_ / count_ : 0.0; }
+
+  // Sample std of per-bar returns
+  double return_std() const {
+    if (count_ < 2)
+      return 0.0;
+    double var = (sum_sq_ - sum_ * sum_ / count_) / (count_ - 1);
+    return std::sqrt(std::max(var, 0.0));
+  }
+
+  // Annualized; 0 when undefined (no variation)
+  double sharpe(double periods_per_year = BARS_PER_YEAR_1MIN) const {
+    double sd = return_std();
+    return sd > 0.0 ? mean_return() / sd * std::sqrt(periods_per_year) : 0.0;
+  }
+
+  // Annualized, downside deviation = sqrt(mean(min(r, 0)^2))
+  double sortino(double periods_per_year = BARS_PER_YEAR_1MIN) const {
+    if (count_ == 0 || downside_sq_ <= 0.0)
+      return 0.0;
+    double dd = std::sqrt(downside_sq_ / count_);
+    return mean_return() / dd * std::sqrt(periods_per_year);
+  }
+
+private:
+  double peak_ = 0.0;
+  double last_ = 0.0;
+  double drawdown_ = 0.0;
+  double max_drawdown_ = 0.0;
+  size_t count_ = 0;
+  double sum_ = 0.0;
+  double sum_sq_ = 0.0;
+  double downside_sq_ = 0.0;
+};
+
+} // namespace quant
@@ -0,0 +1,677 @@
+#pragma once
+
+#include "OrderBook.hpp"
+#include "Regime.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Event Journal
+// ---------------------------------------------------------
+// Binary log of what one Engine run did, one fixed-size record per event
+// (Engine::set_journal):
+//
+//   Order / Cancel / Fill   from ExecutionEngine, as they happen
+//   Stop                    RiskManager stop placed or trailed
+//   Exit                    why a position is being closed
+//   Bar                     end of bar: signal, regime, close, equity
+//   Snapshot                every snapshot_every bars: the whole
+//                           JournalState, in the records that follow
+//
+// File: JournalHeader, the records in order, the snapshot index, then a
+// JournalTrailer. JournalReader::state_at(bar) binary-searches the index,
+// loads the last snapshot at or before `bar` and applies at most
+// snapshot_every bars of records from there, so any bar is reconstructed
+// without re-running (or re-reading) the run from bar 0. A file without a
+// trailer (run interrupted) is indexed by one scan when opened.
+//
+// JournalWriter keeps its own JournalState by applying each record as it
+// writes it, with the same apply() the reader replays, so snapshots and
+// replay agree by construction. Records go into preallocated blocks; full
+// blocks are handed to a writer thread (two atomic counters, wait /
+// notify) that does every fwrite, so the bar loop neither blocks on I/O
+// nor allocates.
+
+enum class JournalEvent : uint8_t {
+  Bar,
+  Order,
+  Cancel,
+  Fill,
+  Stop,
+  Exit,
+  Snapshot
+};
+
+// Exit record flags
+enum class ExitReason : uint8_t { Signal, Stop, Drawdown, SessionClose };
+
+inline const char *journal_event_name(JournalEvent event) {
+  switch (event) {
+  case JournalEvent::Bar:
+    return "BAR";
+  case JournalEvent::Order:
+    return "ORDER";
+  case JournalEvent::Cancel:
+    return "CANCEL";
+  case JournalEvent::Fill:
+    return "FILL";
+  case JournalEvent::Stop:
+    return "STOP";
+  case JournalEvent::Exit:
+    return "EXIT";
+  case JournalEvent::Snapshot:
+    return "SNAPSHOT";
+  }
+  return "?";
+}
+
+inline const char *exit_reason_name(ExitReason reason) {
+  switch (reason) {
+  case ExitReason::Signal:
+    return "signal";
+  case ExitReason::Stop:
+    return "stop";
+  case ExitReason::Drawdown:
+    return "drawdown";
+  case ExitReason::SessionClose:
+    return "session_close";
+  }
+  return "?";
+}
+
+/**
+ * @brief One journal event (40 bytes). Fields per type:
+ *
+ *   Bar     side = signal, flags = Regime, a = close, b = equity,
+ *           c = position
+ *   Order   side, flags = OrderType, a = quantity, b = level (NaN: market)
+ *   Cancel  a = quantity cancelled
+ *   Fill    side, a = quantity, b = price, c = fee
+ *   Stop    a = stop, b = initial stop
+ *   Exit    side = position side, flags = ExitReason
+ */
+struct JournalRecord {
+  int64_t timestamp;
+  uint32_t bar; // Bar index within the run
+  JournalEvent type;
+  int8_t side;
+  uint8_t flags;
+  uint8_t reserved;
+  double a;
+  double b;
+  double c;
+};
+static_assert(sizeof(JournalRecord) == 40);
+
+/**
+ * @brief Book, risk and signal state as of the last applied record. After
+ * a Bar record: the state at the end of that bar. Plain data, so a
+ * snapshot is its bytes.
+ */
+struct JournalState {
+  int64_t timestamp = 0;
+  uint32_t bar = 0;  // Last bar closed
+  uint32_t bars = 0; // Bars closed so far
+  int32_t signal = 0;
+  uint8_t regime = 0; // Regime
+  int8_t side = 0;    // Position side
+  uint16_t reserved = 0;
+  double close = 0.0;
+  double equity = 0.0; // Engine's mark at the bar close
+  double cash = 0.0;
+  double position = 0.0;
+  double entry_price = 0.0; // Average, as ExecutionEngine
+  double stop = std::numeric_limits<double>::quiet_NaN();
+  double initial_stop = std::numeric_limits<double>::quiet_NaN();
+  double working_quantity = 0.0; // Ordered, not filled or cancelled
+  uint32_t orders = 0;
+  uint32_t fills = 0;
+  uint32_t trades = 0; // Fills that reduced a position
+  uint32_t exits = 0;
+
+  // cash + position * close; equals `equity` after a Bar record.
+  double mark() const { return cash + position * close; }
+
+  void apply(const JournalRecord &r) {
+    switch (r.type) {
+    case JournalEvent::Bar:
+      timestamp = r.timestamp;
+      bar = r.bar;
+      ++bars;
+      signal = r.side;
+      regime = r.flags;
+      close = r.a;
+      equity = r.b;
+      return;
+    case JournalEvent::Order:
+      ++orders;
+      working_quantity += r.a;
+      return;
+    case JournalEvent::Cancel:
+      working_quantity = std::max(0.0, working_quantity - r.a);
+      return;
+    case JournalEvent::Fill:
+      apply_fill(r.side, r.a, r.b, r.c);
+      return;
+    case JournalEvent::Stop:
+      stop = r.a;
+      initial_stop = r.b;
+      return;
+    case JournalEvent::Exit:
+      ++exits;
+      return;
+    case JournalEvent::Snapshot:
+      return;
+    }
+  }
+
+private:
+  // Same arithmetic as ExecutionEngine::execute_trade, so cash and
+  // position match the engine's bit for bit.
+  void apply_fill(int fill_side, double qty, double price, double fee) {
+    ++fills;
+    working_quantity = std::max(0.0, working_quantity - qty);
+    double cost = qty * price;
+    if (fill_side == 1)
+      cash -= (cost + fee);
+    else
+      cash += (cost - fee);
+
+    double open_qty = std::abs(position);
+    if (side == 0 || fill_side == side) {
+      if (side == 0)
+        entry_price = price;
+      else
+        entry_price = (entry_price * open_qty + price * qty) / (open_qty + qty);
+      position += fill_side * qty;
+      side = static_cast<int8_t>(fill_side);
+      return;
+    }
+    ++trades;
+    position += fill_side * qty;
+    if (std::abs(position) < 1e-9) {
+      position = 0.0;
+      side = 0;
+    } else if ((position > 0) != (side == 1)) {
+      side = static_cast<int8_t>(fill_side);
+      entry_price = price;
+    }
+  }
+};
+
+// Records a snapshot's payload takes after its Snapshot record.
+inline constexpr size_t SNAPSHOT_RECORDS =
+    (sizeof(JournalState) + sizeof(JournalRecord) - 1) / sizeof(JournalRecord);
+
+inline constexpr char JOURNAL_MAGIC[8] = {'Q', 'J', 'R', 'N', 'L', '0', '0', '1'};
+inline constexpr char JOURNAL_INDEX_MAGIC[8] = {'Q', 'J', 'I', 'D', 'X', '0',
+                                                '0', '1'};
+
+struct JournalHeader {
+  char magic[8];
+  uint32_t record_size;
+  uint32_t snapshot_every; // Bars
+  uint32_t snapshot_records;
+  uint32_t reserved;
+  double initial_capital;
+};
+
+// Snapshot index entry: the snapshot taken after bar `bar` is record
+// `record` (its payload follows).
+struct JournalIndexEntry {
+  uint32_t bar;
+  uint32_t reserved;
+  uint64_t record;
+};
+
+struct JournalTrailer {
+  uint64_t records;
+  uint64_t snapshots; // Index entries before the trailer
+  uint64_t bars;
+  char magic[8];
+};
+
+struct JournalConfig {
+  uint32_t snapshot_every = 4096; // Bars between snapshots
+  size_t block_records = 8192;    // Records per write block
+  size_t blocks = 8; // Blocks in flight before the bar loop waits (1: none)
+};
+
+/**
+ * @brief Journal file writer. The recording calls (begin_bar .. end_bar)
+ * come from the engine thread only; close() flushes the last block, joins
+ * the writer thread and writes the index. Throws std::runtime_error if
+ * the file cannot be created.
+ */
+class JournalWriter {
+public:
+  JournalWriter(const std::string &path, double initial_capital,
+                const JournalConfig &config = {})
+      : config_(config), buffer_(std::max<size_t>(1, config.blocks) *
+                                 std::max<size_t>(1, config.block_records)),
+        sizes_(std::max<size_t>(1, config.blocks), 0) {
+    config_.blocks = sizes_.size();
+    config_.block_records = buffer_.size() / config_.blocks;
+    config_.snapshot_every = std::max<uint32_t>(1, config.snapshot_every);
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_)
+      throw std::runtime_error("JournalWriter: cannot create " + path);
+
+    JournalHeader header{};
+    std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+    header.record_size = sizeof(JournalRecord);
+    header.snapshot_every = config_.snapshot_every;
+    header.snapshot_records = SNAPSHOT_RECORDS;
+    header.initial_capital = initial_capital;
+    ok_ = std::fwrite(&header, sizeof(header), 1, file_) == 1;
+
+    state_.cash = state_.equity = initial_capital;
+    block_ = buffer_.data();
+    writer_ = std::thread([this] { writer_loop(); });
+  }
+
+  ~JournalWriter() { close(); }
+
+  JournalWriter(const JournalWriter &) = delete;
+  JournalWriter &operator=(const JournalWriter &) = delete;
+
+  // -------------------------------------------------------
+  // Recording (engine thread)
+  // -------------------------------------------------------
+  void begin_bar(uint32_t bar, int64_t timestamp) {
+    bar_ = bar;
+    timestamp_ = timestamp;
+  }
+
+  void order(int side, OrderType type, double quantity, double level) {
+    push(JournalEvent::Order, side, static_cast<uint8_t>(type), quantity,
+         level);
+  }
+
+  void cancel(double quantity) {
+    if (quantity > 0)
+      push(JournalEvent::Cancel, 0, 0, quantity);
+  }
+
+  void fill(int side, double quantity, double price, double fee) {
+    push(JournalEvent::Fill, side, 0, quantity, price, fee);
+  }
+
+  // Only changes are recorded.
+  void stop(double stop, double initial_stop) {
+    if (stop == state_.stop && initial_stop == state_.initial_stop)
+      return;
+    push(JournalEvent::Stop, 0, 0, stop, initial_stop);
+  }
+
+  void exit(ExitReason reason, int side) {
+    push(JournalEvent::Exit, side, static_cast<uint8_t>(reason));
+  }
+
+  void end_bar(int signal, Regime regime, double close, double equity,
+               double position) {
+    push(JournalEvent::Bar, signal, static_cast<uint8_t>(regime), close,
+         equity, position);
+    if (state_.bars % config_.snapshot_every == 0)
+      snapshot();
+  }
+
+  // State after the last recorded event.
+  const JournalState &state() const { return state_; }
+  uint64_t records() const { return records_; }
+
+  /**
+   * @brief Write everything out and finish the file (index + trailer).
+   * Idempotent. Returns false if any write failed.
+   */
+  bool close() {
+    if (!file_)
+      return ok_;
+    // Last (possibly empty) block; the writer exits once it has written it
+    const uint64_t last = produced_.load(std::memory_order_relaxed);
+    sizes_[last % config_.blocks] = used_;
+    final_block_.store(last + 1, std::memory_order_relaxed);
+    publish();
+    writer_.join();
+
+    JournalTrailer trailer{};
+    trailer.records = records_;
+    trailer.snapshots = index_.size();
+    trailer.bars = state_.bars;
+    std::memcpy(trailer.magic, JOURNAL_INDEX_MAGIC, sizeof(trailer.magic));
+    if (!index_.empty())
+      ok_ &= std::fwrite(index_.data(), sizeof(JournalIndexEntry),
+                         index_.size(), file_) == index_.size();
+    ok_ &= std::fwrite(&trailer, sizeof(trailer), 1, file_) == 1;
+    ok_ &= std::fclose(file_) == 0;
+    file_ = nullptr;
+    return ok_;
+  }
+
+private:
+  void push(JournalEvent type, int side, uint8_t flags, double a = 0.0,
+            double b = 0.0, double c = 0.0) {
+    JournalRecord r{timestamp_, bar_, type, static_cast<int8_t>(side),
+                    flags, 0, a, b, c};
+    state_.apply(r);
+    emit(r);
+  }
+
+  void snapshot() {
+    emit({timestamp_, bar_, JournalEvent::Snapshot, 0, 0, 0, 0.0, 0.0, 0.0});
+    JournalRecord payload[SNAPSHOT_RECORDS] = {};
+    std::memcpy(payload, &state_, sizeof(state_));
+    for (const JournalRecord &r : payload)
+      emit(r);
+  }
+
+  void emit(const JournalRecord &r) {
+    block_[used_++] = r;
+    ++records_;
+    if (used_ == config_.block_records) {
+      sizes_[produced_.load(std::memory_order_relaxed) % config_.blocks] =
+          used_;
+      publish();
+    }
+  }
+
+  // Hand the current block to the writer and take the next one, waiting
+  // while every block is still being written.
+  void publish() {
+    const uint64_t produced =
+        produced_.fetch_add(1, std::memory_order_release) + 1;
+    produced_.notify_one();
+    for (uint64_t done = completed_.load(std::memory_order_acquire);
+         produced - done >= config_.blocks;
+         done = completed_.load(std::memory_order_acquire))
+      completed_.wait(done, std::memory_order_acquire);
+    block_ = buffer_.data() + (produced % config_.blocks) * config_.block_records;
+    used_ = 0;
+  }
+
+  void writer_loop() {
+    uint64_t done = 0;
+    uint64_t written = 0;
+    size_t skip = 0; // Snapshot payload records still to pass over
+    for (;;) {
+      uint64_t produced = produced_.load(std::memory_order_acquire);
+      if (produced == done) {
+        produced_.wait(produced, std::memory_order_acquire);
+        continue;
+      }
+      const size_t slot = done % config_.blocks;
+      const size_t n = sizes_[slot];
+      const JournalRecord *block =
+          buffer_.data() + slot * config_.block_records;
+      for (size_t i = 0; i < n; ++i) {
+        if (skip > 0) {
+          --skip;
+        } else if (block[i].type == JournalEvent::Snapshot) {
+          index_.push_back({block[i].bar, 0, written + i});
+          skip = SNAPSHOT_RECORDS;
+        }
+      }
+      if (n > 0 && std::fwrite(block, sizeof(JournalRecord), n, file_) != n)
+        ok_ = false;
+      written += n;
+      completed_.store(++done, std::memory_order_release);
+      completed_.notify_one();
+      // Published before the final block's produced_ increment, which this
+      // thread has acquired by now if `done` reached it
+      if (done == final_block_.load(std::memory_order_relaxed))
+        return;
+    }
+  }
+
+  JournalConfig config_;
+  std::FILE *file_ = nullptr;
+  bool ok_ = true; // Writer thread's until close() joins it
+
+  // Engine thread
+  JournalState state_;
+  uint32_t bar_ = 0;
+  int64_t timestamp_ = 0;
+  JournalRecord *block_ = nullptr;
+  size_t used_ = 0;
+  uint64_t records_ = 0;
+
+  // Shared: blocks [completed, produced) belong to the writer
+  std::vector<JournalRecord> buffer_;
+  std::vector<size_t> sizes_;
+  alignas(64) std::atomic<uint64_t> produced_{0};
+  alignas(64) std::atomic<uint64_t> completed_{0};
+  // Blocks published in total, set by close() before the last publish
+  std::atomic<uint64_t> final_block_{std::numeric_limits<uint64_t>::max()};
+
+  // Writer thread
+  std::vector<JournalIndexEntry> index_;
+  std::thread writer_;
+};
+
+/**
+ * @brief Random access into a journal file. Throws std::runtime_error if
+ * the file is missing or not a journal.
+ */
+class JournalReader {
+public:
+  explicit JournalReader(const std::string &path) {
+    file_ = std::fopen(path.c_str(), "rb");
+    if (!file_)
+      throw std::runtime_error("JournalReader: cannot open " + path);
+    if (std::fread(&header_, sizeof(header_), 1, file_) != 1 ||
+        std::memcmp(header_.magic, JOURNAL_MAGIC, sizeof(header_.magic)) != 0 ||
+        header_.record_size != sizeof(JournalRecord) ||
+        header_.snapshot_records != SNAPSHOT_RECORDS) {
+      std::fclose(file_);
+      throw std::runtime_error("JournalReader: not a journal file: " + path);
+    }
+    if (!read_index())
+      scan();
+  }
+
+  ~JournalReader() {
+    if (file_)
+      std::fclose(file_);
+  }
+
+  JournalReader(const JournalReader &) = delete;
+  JournalReader &operator=(const JournalReader &) = delete;
+
+  const JournalHeader &header() const { return header_; }
+  uint64_t records() const { return records_; }
+  uint32_t bars() const { return bars_; }
+  size_t snapshots() const { return index_.size(); }
+  bool has_trailer() const { return has_trailer_; }
+
+  // Before the first bar.
+  JournalState initial_state() const {
+    JournalState state;
+    state.cash = state.equity = header_.initial_capital;
+    return state;
+  }
+
+  /**
+   * @brief State at the end of bar `bar`: nearest snapshot at or before it
+   * plus the records after it. nullopt past the last bar.
+   */
+  std::optional<JournalState> state_at(uint32_t bar) const {
+    if (bar >= bars_)
+      return std::nullopt;
+    JournalState state;
+    uint64_t record = seek_snapshot(bar, state);
+    if (state.bars > 0 && state.bar == bar)
+      return state;
+    for_each(record, [&](const JournalRecord &r) {
+      state.apply(r);
+      return !(r.type == JournalEvent::Bar && r.bar == bar);
+    });
+    return state;
+  }
+
+  /**
+   * @brief fn(record) for every event of bars [first, last], in order,
+   * snapshots excluded, starting from the nearest snapshot before `first`.
+   */
+  template <typename Fn>
+  void events(uint32_t first, uint32_t last, Fn &&fn) const {
+    if (first > last || first >= bars_)
+      return;
+    JournalState state;
+    uint64_t record = seek_snapshot(first == 0 ? 0 : first - 1, state);
+    if (first == 0)
+      record = 0;
+    for_each(record, [&](const JournalRecord &r) {
+      if (r.bar > last)
+        return false;
+      if (r.bar >= first && r.type != JournalEvent::Snapshot)
+        fn(r);
+      return true;
+    });
+  }
+
+  // One full pass; what state_at() avoids. Returns the final state.
+  JournalState replay() const {
+    JournalState state = initial_state();
+    for_each(0, [&](const JournalRecord &r) {
+      state.apply(r);
+      return true;
+    });
+    return state;
+  }
+
+private:
+  static constexpr size_t CHUNK = 4096;
+
+  long offset_of(uint64_t record) const {
+    return static_cast<long>(sizeof(JournalHeader) +
+                             record * sizeof(JournalRecord));
+  }
+
+  // Loads into `state` the last snapshot taken at or before `bar` (or the
+  // initial state) and returns the record to continue from.
+  uint64_t seek_snapshot(uint32_t bar, JournalState &state) const {
+    auto it = std::upper_bound(
+        index_.begin(), index_.end(), bar,
+        [](uint32_t b, const JournalIndexEntry &e) { return b < e.bar; });
+    if (it == index_.begin()) {
+      state = initial_state();
+      return 0;
+    }
+    const JournalIndexEntry &entry = *(it - 1);
+    JournalRecord payload[SNAPSHOT_RECORDS];
+    std::fseek(file_, offset_of(entry.record + 1), SEEK_SET);
+    if (std::fread(payload, sizeof(JournalRecord), SNAPSHOT_RECORDS, file_) !=
+        SNAPSHOT_RECORDS)
+      throw std::runtime_error("JournalReader: truncated snapshot");
+    std::memcpy(&state, payload, sizeof(state));
+    return entry.record + 1 + SNAPSHOT_RECORDS;
+  }
+
+  // fn(record) from `record` on, snapshot payloads skipped, until fn
+  // returns false or the records end.
+  template <typename Fn> void for_each(uint64_t record, Fn &&fn) const {
+    std::vector<JournalRecord> chunk(CHUNK);
+    std::fseek(file_, offset_of(record), SEEK_SET);
+    size_t skip = 0;
+    while (record < records_) {
+      const size_t want =
+          static_cast<size_t>(std::min<uint64_t>(CHUNK, records_ - record));
+      const size_t got =
+          std::fread(chunk.data(), sizeof(JournalRecord), want, file_);
+      for (size_t i = 0; i < got; ++i) {
+        if (skip > 0) {
+          --skip;
+          continue;
+        }
+        if (chunk[i].type == JournalEvent::Snapshot)
+          skip = SNAPSHOT_RECORDS;
+        if (!fn(chunk[i]))
+          return;
+      }
+      if (got < want)
+        return; // Truncated
+      record += got;
+    }
+  }
+
+  bool read_index() {
+    JournalTrailer trailer{};
+    if (std::fseek(file_, -static_cast<long>(sizeof(trailer)), SEEK_END) != 0 ||
+        std::fread(&trailer, sizeof(trailer), 1, file_) != 1 ||
+        std::memcmp(trailer.magic, JOURNAL_INDEX_MAGIC,
+                    sizeof(trailer.magic)) != 0)
+      return false;
+    index_.resize(trailer.snapshots);
+    std::fseek(file_, offset_of(trailer.records), SEEK_SET);
+    if (!index_.empty() &&
+        std::fread(index_.data(), sizeof(JournalIndexEntry), index_.size(),
+                   file_) != index_.size()) {
+      index_.clear();
+      return false;
+    }
+    records_ = trailer.records;
+    bars_ = static_cast<uint32_t>(trailer.bars);
+    has_trailer_ = true;
+    return true;
+  }
+
+  // No trailer: every whole record up to the end of the file.
+  void scan() {
+    std::fseek(file_, 0, SEEK_END);
+    const long size = std::ftell(file_);
+    records_ = size > offset_of(0)
+                   ? static_cast<uint64_t>(size - offset_of(0)) /
+                         sizeof(JournalRecord)
+                   : 0;
+    index_.clear();
+    bars_ = 0;
+    uint64_t record = 0;
+    size_t skip = 0;
+    std::vector<JournalRecord> chunk(CHUNK);
+    std::fseek(file_, offset_of(0), SEEK_SET);
+    while (record < records_) {
+      const size_t got = std::fread(
+          chunk.data(), sizeof(JournalRecord),
+          static_cast<size_t>(std::min<uint64_t>(CHUNK, records_ - record)),
+          file_);
+      if (got == 0)
+        break;
+      for (size_t i = 0; i < got; ++i) {
+        if (skip > 0) {
+          --skip;
+          continue;
+        }
+        if (chunk[i].type == JournalEvent::Snapshot) {
+          // A snapshot cut off by the end of the file is not usable
+          if (record + i + SNAPSHOT_RECORDS < records_)
+            index_.push_back({chunk[i].bar, 0, record + i});
+          skip = SNAPSHOT_RECORDS;
+        } else if (chunk[i].type == JournalEvent::Bar) {
+          bars_ = chunk[i].bar + 1;
+        }
+      }
+      record += got;
+    }
+  }
+
+  std::FILE *file_ = nullptr;
+  JournalHeader header_{};
+  uint64_t records_ = 0;
+  uint32_t bars_ = 0;
+  bool has_trailer_ = false;
+  std::vector<JournalIndexEntry> index_;
+};
+
+} // namespace quant
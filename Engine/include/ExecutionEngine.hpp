@@ -1,120 +1,185 @@
 #pragma once
 
 #include "Bar.hpp"
+#include "EventJournal.hpp"
+#include "OrderBook.hpp"
+#include "TradeLog.hpp"
 #include <cmath>
-#include <iostream>
+#include <utility>
 #include <vector>
 
 namespace quant {
 
-struct Order {
-  int id;
-  int64_t timestamp;
-  int side; // 1=Buy, -1=Sell
-  double quantity;
-  double price; // 0 for Market
-};
-
-struct Trade {
-  int64_t entry_time;
-  int64_t exit_time;
-  double entry_price;
-  double exit_price;
-  int side;
-  double pnl;
-};
-
 class ExecutionEngine {
 public:
-  ExecutionEngine(double initial_capital = 100000.0)
-      : capital_(initial_capital), position_(0), cash_(initial_capital) {}
+  ExecutionEngine(double initial_capital = 100000.0,
+                  TradeLog trade_log = TradeLog(),
+                  FillConfig fill_config = FillConfig())
+      : capital_(initial_capital), cash_(initial_capital), position_(0),
+        fill_config_(fill_config), trades_(std::move(trade_log)) {}
+
+  // Market order, filled on the next bar per the fill policy. Returns the
+  // order id.
+  int submit_order(int side, double quantity, int64_t time = 0) {
+    return submit(OrderType::Market, side, quantity, std::nan(""), time);
+  }
+
+  int submit_limit(int side, double quantity, double limit_price,
+                   int64_t time = 0) {
+    return submit(OrderType::Limit, side, quantity, limit_price, time);
+  }
 
-  void submit_order(int side, double quantity) {
-    // In a real system, adds to queue. Here we just set "next order"
-    pending_order_side_ = side;
-    pending_order_qty_ = quantity;
+  int submit_stop(int side, double quantity, double stop_price,
+                  int64_t time = 0) {
+    return submit(OrderType::Stop, side, quantity, stop_price, time);
   }
 
+  bool cancel_order(int id) {
+    if (!journal_)
+      return book_.cancel(id);
+    const double before = book_.quantity();
+    const bool cancelled = book_.cancel(id);
+    if (cancelled)
+      journal_->cancel(before - book_.quantity());
+    return cancelled;
+  }
+
+  // Drop every order that has not filled yet.
+  void cancel_all_orders() {
+    if (journal_ && !book_.empty())
+      journal_->cancel(book_.quantity());
+    book_.clear();
+  }
+
+  // Flatten at the next fill: working orders are cancelled (so a resting
+  // stop cannot reopen the position) and a market order closes it.
   void close_position() {
     if (position_ != 0) {
+      cancel_all_orders();
       submit_order(-position_side_, std::abs(position_));
     }
   }
 
-  // Simulates filling orders at the OPEN of the current bar
+  // Flatten immediately at `price` (e.g. the session's closing bar), rather
+  // than at the next bar's open. Working orders are dropped; slippage and
+  // fees apply as for a market fill.
+  void close_now(int64_t time, double price) {
+    cancel_all_orders();
+    if (position_ != 0)
+      execute_trade(time, -position_side_, std::abs(position_),
+                    fill_config_.slippage.apply(-position_side_, price));
+  }
+
+  // Fill whatever this bar reaches: market orders from the previous bar,
+  // plus limit / stop orders the bar trades through (see FillPolicy).
   void on_bar_open(const Bar &bar) {
-    if (pending_order_side_ != 0) {
-      execute_trade(bar.timestamp, pending_order_side_, pending_order_qty_,
-                    bar.open);
-      pending_order_side_ = 0;
-      pending_order_qty_ = 0;
-    }
+    if (!book_.empty())
+      book_.match(bar, fill_config_, [this](const Fill &f) {
+        execute_trade(f.timestamp, f.side, f.quantity, f.price);
+      });
   }
 
   double get_equity(double current_price) const {
     return cash_ + (position_ * current_price);
   }
 
+  // Stop levels of the open position (RiskManager::initial_stop / stop),
+  // stamped on the trades it closes into.
+  void set_stops(double initial_stop, double stop) {
+    initial_stop_ = initial_stop;
+    stop_ = stop;
+  }
+
+  // Orders, cancels and fills are recorded to `journal` while set
+  // (Engine::set_journal); nullptr = off.
+  void set_journal(JournalWriter *journal) { journal_ = journal; }
+
   double get_position() const { return position_; }
+  double get_cash() const { return cash_; }
   bool is_invested() const { return position_ != 0; }
+  bool has_working_orders() const { return !book_.empty(); }
+  const OrderBook &order_book() const { return book_; }
+  const FillConfig &fill_config() const { return fill_config_; }
 
-  const std::vector<Trade> &get_trades() const { return trades_; }
+  // Every closed trade in order (reads back any spilled records).
+  std::vector<Trade> get_trades() const { return trades_.to_vector(); }
+  const TradeLog &trade_log() const { return trades_; }
 
 private:
+  int submit(OrderType type, int side, double quantity, double price,
+             int64_t time) {
+    const int id = book_.submit(type, side, quantity, price, time);
+    if (journal_ && id != 0)
+      journal_->order(side, type, quantity, price);
+    return id;
+  }
+
+  // Apply one fill. Adding to a position averages the entry price; a fill
+  // against it closes up to the open quantity (one Trade per reduction, so
+  // partial closes are recorded) and any excess opens the reverse position.
   void execute_trade(int64_t time, int side, double qty, double price) {
     double cost = qty * price;
-    // Simple fee model (0.05%) - DISABLED FOR COMPARISON
-    double fee = 0.0; // cost * 0.0005;
-
-    // Capture Entry Details
-    if (position_ == 0 && side != 0) {
-      last_entry_time_ = time;
-      last_entry_price_ = price;
-    }
+    double fee = fill_config_.fees(cost);
+    if (journal_)
+      journal_->fill(side, qty, price, fee);
 
     if (side == 1) { // BUY
       cash_ -= (cost + fee);
-      position_ += qty;
     } else { // SELL
       cash_ += (cost - fee);
-      position_ -= qty;
     }
 
-    // Capture Exit / Trade Record
-    // logic: If we just went from Invested -> Flat (0), that's a closed trade.
-    // Assumptions: No partial closes, no reversing (Long -> Short) in 1 step
-    // for now.
-    if (std::abs(position_) < 1e-9 && position_side_ != 0) {
-      // We just closed a position.
-      Trade t;
-      t.entry_time = last_entry_time_;
-      t.exit_time = time;
-      t.entry_price = last_entry_price_;
-      t.exit_price = price;
-      t.side = position_side_;
-
-      // PnL calc
-      if (position_side_ == 1) { // Long
-        t.pnl = (t.exit_price - t.entry_price) * qty;
-      } else { // Short
-        t.pnl = (t.entry_price - t.exit_price) * qty;
+    double open_qty = std::abs(position_);
+    if (position_side_ == 0 || side == position_side_) {
+      // Entry or add
+      if (position_side_ == 0) {
+        entry_time_ = time;
+        entry_price_ = price;
+        entry_fees_ = fee;
+      } else {
+        entry_price_ = (entry_price_ * open_qty + price * qty) / (open_qty + qty);
+        entry_fees_ += fee;
       }
-      // Subtract fees (Entry + Exit fee approx)
-      double total_fee = 0.0; // (t.entry_price * qty * 0.0005) + (t.exit_price
-                              // * qty * 0.0005);
-      t.pnl -= total_fee;
-
-      trades_.push_back(t);
+      position_ += side * qty;
+      position_side_ = side;
+      return;
     }
 
-    // Update State
-    if (std::abs(position_) > 1e-9)
-      position_side_ = (position_ > 0) ? 1 : -1;
-    else
+    // Reduce / close, possibly reversing
+    double closed = std::min(qty, open_qty);
+    double entry_fee_share = entry_fees_ * (closed / open_qty);
+    double exit_fee_share = fee * (closed / qty);
+
+    Trade t;
+    t.entry_time = entry_time_;
+    t.exit_time = time;
+    t.entry_price = entry_price_;
+    t.exit_price = price;
+    t.side = position_side_;
+    if (position_side_ == 1) { // Long
+      t.pnl = (t.exit_price - t.entry_price) * closed;
+    } else { // Short
+      t.pnl = (t.entry_price - t.exit_price) * closed;
+    }
+    t.quantity = closed;
+    t.fees = entry_fee_share + exit_fee_share;
+    t.pnl -= t.fees;
+    t.initial_stop = initial_stop_;
+    t.exit_stop = stop_;
+    trades_.push_back(t);
+
+    entry_fees_ -= entry_fee_share;
+    position_ += side * qty;
+    if (std::abs(position_) < 1e-9) {
+      position_ = 0.0;
       position_side_ = 0;
-
-    // std::cout << ">> EXEC: " << (side == 1 ? "BUY" : "SELL") << " " << qty
-    //           << " @ " << price << " | Cash: " << cash_ << std::endl;
+    } else if ((position_ > 0) != (position_side_ == 1)) {
+      // Reversed: the remainder is a new entry at this fill
+      position_side_ = side;
+      entry_time_ = time;
+      entry_price_ = price;
+      entry_fees_ = fee - exit_fee_share;
+    }
   }
 
   double capital_;
@@ -122,14 +187,17 @@ private:
   double position_ = 0.0;
   int position_side_ = 0;
 
-  // Trade Tracking
-  int64_t last_entry_time_ = 0;
-  double last_entry_price_ = 0.0;
-
-  int pending_order_side_ = 0;
-  double pending_order_qty_ = 0.0;
-
-  std::vector<Trade> trades_;
+  // Open position: first fill time, average entry price, unallocated fees
+  int64_t entry_time_ = 0;
+  double entry_price_ = 0.0;
+  double entry_fees_ = 0.0;
+  double initial_stop_ = std::nan("");
+  double stop_ = std::nan("");
+
+  FillConfig fill_config_;
+  OrderBook book_;
+  TradeLog trades_;
+  JournalWriter *journal_ = nullptr;
 };
 
 } // namespace quant
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace quant {
+
+// ---------------------------------------------------------
+// SIMD dispatch for the batch feature kernels
+// ---------------------------------------------------------
+// The widest instruction set is picked once at runtime (CPUID), so one
+// binary runs on any x86-64 and uses AVX2 / AVX-512 where present. Other
+// targets and compilers without target attributes use the scalar kernels.
+enum class SimdLevel : uint8_t { Scalar, AVX2, AVX512 };
+
+const char *simd_level_name(SimdLevel level);
+
+// Best level supported by this CPU and build.
+SimdLevel detected_simd_level();
+
+// Level used by the kernels (defaults to detected_simd_level()).
+SimdLevel simd_level();
+
+// Force a level, e.g. to benchmark or cross-check paths. Requests above
+// detected_simd_level() are clamped. Process-wide.
+void set_simd_level(SimdLevel level);
+
+/**
+ * @brief Data-parallel building blocks of features.cpp. Raw pointers and
+ * lengths; callers size the outputs and handle the NaN warm-up region.
+ *
+ * true_range, gain_loss and momentum are element-wise and bit-identical
+ * across levels. The rolling kernels run a vectorized prefix sum of window
+ * differences, re-seeded with an exact window sum every block, so they
+ * agree with the scalar path to rounding (~1e-12 relative).
+ */
+namespace kernels {
+
+// out[i - 1] = max(h - l, |h - c[i-1]|, |l - c[i-1]|) for i in [1, n)
+void true_range(const double *high, const double *low, const double *close,
+                size_t n, double *out);
+
+// gains[i - 1] / losses[i - 1] = positive / negative part of p[i] - p[i-1]
+void gain_loss(const double *prices, size_t n, double *gains,
+               double *losses);
+
+// out[i] = (p[i] - p[i-period]) / p[i-period] for i in [period, n);
+// entries with p[i-period] == 0 are left untouched.
+void momentum(const double *prices, size_t n, size_t period, double *out);
+
+// out[i] = mean of x[i-period+1 .. i] for i in [period-1, n)
+void rolling_mean(const double *x, size_t n, size_t period, double *out);
+
+// Population mean / std dev of each full window, as above. mean_out may be
+// null when only std dev is needed.
+void rolling_mean_std(const double *x, size_t n, size_t period,
+                      double *mean_out, double *std_out);
+
+// out[i] = (x[i] - mean) / std dev of the same windows, NaN where the std
+// dev is 0; no scratch columns.
+void rolling_zscore(const double *x, size_t n, size_t period, double *out);
+
+} // namespace kernels
+
+} // namespace quant
@@ -0,0 +1,332 @@
+#pragma once
+
+#include "Bar.hpp"
+#include "Indicators.hpp"
+#include "Resampler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace quant {
+
+// Series an indicator is fed from. LogReturn = ln(close / prev_close); it is
+// only defined from the second bar on, so LogReturn indicators skip bar 0.
+enum class IndicatorInput : uint8_t { Close, Volume, LogReturn };
+
+// Typed index into an IndicatorRegistry. Handles (not pointers) keep a
+// registry and the strategies bound to it trivially copyable as a unit.
+template <typename T> struct IndicatorHandle {
+  uint32_t index = 0;
+};
+
+/**
+ * @brief Owns every streaming indicator used by a strategy stack.
+ *
+ * Strategies request indicators by (type, input, period[, param]); identical
+ * requests return the same handle, so shared indicators (e.g. an RSI(14) on
+ * close used by two strategies, or the log-return series) are updated once
+ * per bar. Per-bar cost scales with the number of *distinct* indicators.
+ *
+ * Call update(bar) once per bar before the bound strategies' on_bar().
+ *
+ * Higher timeframes: timeframe(seconds) returns a child registry fed with
+ * bars resampled from this one's input as they complete (BarResampler), in
+ * the same update() call. Strategies bind to the child like to any registry;
+ * the base series is never stored a second time.
+ *
+ * Warm start: seed(history) sets every indicator as if update() had run on
+ * each bar of `history`, in bulk per indicator (see Indicators.hpp), and
+ * lookback(tolerance) is how many bars of history that needs.
+ */
+class IndicatorRegistry {
+public:
+  IndicatorRegistry() = default;
+  // Copies are deep (timeframe children included), like the rest of the
+  // registry, so stack snapshots stay exact.
+  IndicatorRegistry(const IndicatorRegistry &other);
+  IndicatorRegistry &operator=(const IndicatorRegistry &other);
+  IndicatorRegistry(IndicatorRegistry &&other) noexcept;
+  IndicatorRegistry &operator=(IndicatorRegistry &&other) noexcept;
+  ~IndicatorRegistry();
+
+  IndicatorHandle<SimpleMovingAverage> sma(IndicatorInput input, int period) {
+    return acquire<SimpleMovingAverage>(input, period, 0.0);
+  }
+  IndicatorHandle<ExponentialMovingAverage> ema(IndicatorInput input,
+                                                int period) {
+    return acquire<ExponentialMovingAverage>(input, period, 0.0);
+  }
+  IndicatorHandle<RSI> rsi(IndicatorInput input, int period) {
+    return acquire<RSI>(input, period, 0.0);
+  }
+  IndicatorHandle<RateOfChange> roc(IndicatorInput input, int period) {
+    return acquire<RateOfChange>(input, period, 0.0);
+  }
+  IndicatorHandle<RollingStats> rolling_stats(IndicatorInput input,
+                                              int period) {
+    return acquire<RollingStats>(input, period, 0.0);
+  }
+  IndicatorHandle<BollingerBands> bollinger(IndicatorInput input, int period,
+                                            double std_dev_mult) {
+    return acquire<BollingerBands>(input, period, std_dev_mult);
+  }
+  // ATR reads the bar's high/low/close; it has no input series.
+  IndicatorHandle<ATR> atr(int period) {
+    return acquire<ATR>(IndicatorInput::Close, period, 0.0);
+  }
+
+  template <typename T> const T &get(IndicatorHandle<T> handle) const {
+    return slots<T>()[handle.index].indicator;
+  }
+
+  // Advance every registered indicator by one bar.
+  void update(const Bar &bar) {
+    has_log_return_ = last_close_ > 0;
+    log_return_ = has_log_return_ ? std::log(bar.close / last_close_) : 0.0;
+    last_close_ = bar.close;
+
+    const double inputs[3] = {bar.close, bar.volume, log_return_};
+
+    std::apply(
+        [&](auto &...vecs) {
+          (
+              [&] {
+                for (auto &slot : vecs) {
+                  if constexpr (std::is_same_v<
+                                    std::decay_t<decltype(slot.indicator)>,
+                                    ATR>) {
+                    slot.indicator.update(bar.high, bar.low, bar.close);
+                  } else {
+                    if (slot.input == IndicatorInput::LogReturn &&
+                        !has_log_return_)
+                      continue;
+                    slot.indicator.update(
+                        inputs[static_cast<int>(slot.input)]);
+                  }
+                }
+              }(),
+              ...);
+        },
+        slots_);
+
+    if (!feeds_.empty())
+      update_timeframes(bar);
+  }
+
+  /**
+   * @brief Child registry on `seconds` bars (buckets aligned to `origin`,
+   * see BarResampler), created on first use; the same (seconds, origin)
+   * returns the same child. The reference stays valid for the registry's
+   * lifetime. Register timeframes before the first update().
+   */
+  IndicatorRegistry &timeframe(int64_t seconds, int64_t origin = 0);
+
+  // On a timeframe child: whether the parent's last update() completed a bar
+  // here, and that bar (with two completions, the later one). The root
+  // registry is never fresh.
+  bool fresh() const { return fresh_; }
+  const Bar &bar() const { return bar_; }
+
+  /**
+   * @brief Bars of history after which no registered indicator depends on
+   * older bars (recursive ones: to `tolerance`, see Indicators.hpp).
+   * UNBOUNDED_LOOKBACK with timeframe children: their windows count in
+   * resampled bars, so they are only warmed by replay.
+   */
+  size_t lookback(double tolerance) const {
+    if (!feeds_.empty())
+      return UNBOUNDED_LOOKBACK;
+    size_t bars = 0;
+    std::apply(
+        [&](const auto &...vecs) {
+          (
+              [&] {
+                for (const auto &slot : vecs) {
+                  size_t n = slot.indicator.lookback(tolerance);
+                  // LogReturn series start one bar later
+                  if (n != UNBOUNDED_LOOKBACK &&
+                      slot.input == IndicatorInput::LogReturn)
+                    ++n;
+                  bars = std::max(bars, n);
+                }
+              }(),
+              ...);
+        },
+        slots_);
+    return bars;
+  }
+
+  /**
+   * @brief Replace every indicator's state with the state after update() on
+   * each bar of `history`, in order, without the per-bar calls: the input
+   * columns are gathered once and each indicator seeds from its column.
+   * With timeframe children the bars are replayed through update() instead.
+   */
+  void seed(std::span<const Bar> history);
+
+  // Most recent log return (0 before the second bar).
+  double log_return() const { return log_return_; }
+
+  // Number of distinct indicator instances being updated per bar.
+  size_t size() const {
+    return std::apply([](const auto &...vecs) { return (vecs.size() + ...); },
+                      slots_);
+  }
+
+private:
+  struct Feed;
+
+  void update_timeframes(const Bar &bar);
+
+  template <typename T> struct Slot {
+    IndicatorInput input;
+    int period;
+    double param;
+    T indicator;
+  };
+
+  template <typename T> std::vector<Slot<T>> &slots() {
+    return std::get<std::vector<Slot<T>>>(slots_);
+  }
+  template <typename T> const std::vector<Slot<T>> &slots() const {
+    return std::get<std::vector<Slot<T>>>(slots_);
+  }
+
+  template <typename T>
+  IndicatorHandle<T> acquire(IndicatorInput input, int period, double param) {
+    auto &vec = slots<T>();
+    for (size_t i = 0; i < vec.size(); ++i) {
+      if (vec[i].input == input && vec[i].period == period &&
+          vec[i].param == param)
+        return {static_cast<uint32_t>(i)};
+    }
+    if constexpr (std::is_same_v<T, BollingerBands>) {
+      vec.push_back({input, period, param, T(period, param)});
+    } else {
+      vec.push_back({input, period, param, T(period)});
+    }
+    return {static_cast<uint32_t>(vec.size() - 1)};
+  }
+
+  std::tuple<std::vector<Slot<SimpleMovingAverage>>,
+             std::vector<Slot<ExponentialMovingAverage>>,
+             std::vector<Slot<RSI>>, std::vector<Slot<RateOfChange>>,
+             std::vector<Slot<RollingStats>>,
+             std::vector<Slot<BollingerBands>>, std::vector<Slot<ATR>>>
+      slots_;
+
+  double last_close_ = 0.0;
+  double log_return_ = 0.0;
+  bool has_log_return_ = false;
+
+  // Timeframe children (heap-allocated so references handed out stay put)
+  std::vector<std::unique_ptr<Feed>> feeds_;
+  bool fresh_ = false;
+  Bar bar_{};
+};
+
+struct IndicatorRegistry::Feed {
+  Feed(int64_t seconds, int64_t origin) : resampler(seconds, origin) {}
+
+  BarResampler resampler;
+  IndicatorRegistry registry;
+};
+
+inline IndicatorRegistry::IndicatorRegistry(const IndicatorRegistry &other)
+    : slots_(other.slots_), last_close_(other.last_close_),
+      log_return_(other.log_return_), has_log_return_(other.has_log_return_),
+      fresh_(other.fresh_), bar_(other.bar_) {
+  feeds_.reserve(other.feeds_.size());
+  for (const auto &feed : other.feeds_)
+    feeds_.push_back(std::make_unique<Feed>(*feed));
+}
+
+inline IndicatorRegistry &
+IndicatorRegistry::operator=(const IndicatorRegistry &other) {
+  if (this != &other) {
+    IndicatorRegistry copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+inline IndicatorRegistry::IndicatorRegistry(IndicatorRegistry &&) noexcept =
+    default;
+inline IndicatorRegistry &
+IndicatorRegistry::operator=(IndicatorRegistry &&) noexcept = default;
+inline IndicatorRegistry::~IndicatorRegistry() = default;
+
+inline IndicatorRegistry &IndicatorRegistry::timeframe(int64_t seconds,
+                                                       int64_t origin) {
+  for (auto &feed : feeds_)
+    if (feed->resampler.period() == seconds &&
+        feed->resampler.origin() == origin)
+      return feed->registry;
+  feeds_.push_back(std::make_unique<Feed>(seconds, origin));
+  return feeds_.back()->registry;
+}
+
+inline void IndicatorRegistry::seed(std::span<const Bar> history) {
+  if (!feeds_.empty()) {
+    for (const Bar &bar : history)
+      update(bar);
+    return;
+  }
+
+  const size_t n = history.size();
+  std::vector<double> close(n), volume(n), high(n), low(n);
+  for (size_t i = 0; i < n; ++i) {
+    close[i] = history[i].close;
+    volume[i] = history[i].volume;
+    high[i] = history[i].high;
+    low[i] = history[i].low;
+  }
+  // As update(): a log return from every bar that follows a positive close
+  std::vector<double> log_returns;
+  log_returns.reserve(n);
+  for (size_t i = 1; i < n; ++i)
+    if (close[i - 1] > 0)
+      log_returns.push_back(std::log(close[i] / close[i - 1]));
+
+  const std::span<const double> inputs[3] = {close, volume, log_returns};
+  std::apply(
+      [&](auto &...vecs) {
+        (
+            [&] {
+              for (auto &slot : vecs) {
+                if constexpr (std::is_same_v<
+                                  std::decay_t<decltype(slot.indicator)>,
+                                  ATR>)
+                  slot.indicator.seed(high, low, close);
+                else
+                  slot.indicator.seed(inputs[static_cast<int>(slot.input)]);
+              }
+            }(),
+            ...);
+      },
+      slots_);
+
+  last_close_ = n > 0 ? close[n - 1] : 0.0;
+  has_log_return_ = n > 1 && close[n - 2] > 0;
+  log_return_ = has_log_return_ ? log_returns.back() : 0.0;
+  fresh_ = false;
+}
+
+inline void IndicatorRegistry::update_timeframes(const Bar &bar) {
+  for (auto &feed : feeds_) {
+    IndicatorRegistry &child = feed->registry;
+    int completed = feed->resampler.update(bar);
+    for (int i = 0; i < completed; ++i)
+      child.update(feed->resampler.completed(i));
+    child.fresh_ = completed > 0;
+    if (completed > 0)
+      child.bar_ = feed->resampler.completed(completed - 1);
+  }
+}
+
+} // namespace quant
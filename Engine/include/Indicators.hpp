@@ -1,13 +1,53 @@
 #pragma once
 
 #include "CircularBuffer.hpp"
+#include "FeatureKernels.hpp"
+#include "RollingMoments.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <span>
 
 
 namespace quant {
 
+// Window storage for the rolling indicators below. Each is a template over
+// its buffer; the plain names (SimpleMovingAverage, ...) use the mask-indexed
+// buffer. Pass CircularBuffer<double> (modulo) or CircularBuffer<double, N>
+// (inline storage, period <= N) to the Basic* templates to choose another.
+using IndicatorBuffer = MaskedCircularBuffer<double>;
+
+// ---------------------------------------------------------
+// Warm start
+// ---------------------------------------------------------
+// Every indicator below also has:
+//
+//   seed(history)        state as if update() had run on each value of
+//                        `history` in order, computed in bulk (window tails
+//                        copied, recursions run over the batch kernels'
+//                        element-wise steps). Replaces any earlier state.
+//                        Recursive state (EMA, Wilder) matches replaying
+//                        bit for bit; window sums and moments to rounding.
+//   lookback(tolerance)  inputs after which the value no longer depends on
+//                        older ones: the window for windowed indicators;
+//                        for recursive ones, until the weight left on older
+//                        inputs is below `tolerance` (0 = never).
+
+// lookback() of an indicator that never forgets (tolerance 0).
+inline constexpr size_t UNBOUNDED_LOOKBACK = SIZE_MAX;
+
+// Inputs until the weight (1 - alpha)^k on older ones drops below tolerance.
+inline size_t decay_lookback(double alpha, double tolerance) {
+  if (tolerance <= 0.0 || alpha <= 0.0)
+    return UNBOUNDED_LOOKBACK;
+  if (alpha >= 1.0 || tolerance >= 1.0)
+    return 1;
+  return static_cast<size_t>(
+      std::ceil(std::log(tolerance) / std::log1p(-alpha)));
+}
+
 // Base class for all indicators
 class Indicator {
 public:
@@ -20,14 +60,15 @@ public:
 // ---------------------------------------------------------
 // Simple Moving Average (SMA)
 // ---------------------------------------------------------
-class SimpleMovingAverage : public Indicator {
+template <typename Buffer = IndicatorBuffer>
+class BasicSimpleMovingAverage : public Indicator {
 public:
-  explicit SimpleMovingAverage(int period)
+  explicit BasicSimpleMovingAverage(int period)
       : period_(period), sum_(0.0), buffer_(period) {}
 
   double update(double value) override {
     if (buffer_.is_full()) {
-      sum_ -= buffer_.get(period_ - 1); // Remove oldest
+      sum_ -= buffer_[period_ - 1]; // Remove oldest
     }
     buffer_.push(value);
     sum_ += value;
@@ -36,16 +77,32 @@ public:
     return current_value_;
   }
 
+  void seed(std::span<const double> history) {
+    buffer_ = Buffer(period_);
+    sum_ = 0.0;
+    current_value_ = 0.0;
+    for (double v : history.last(std::min<size_t>(history.size(), period_))) {
+      buffer_.push(v);
+      sum_ += v;
+    }
+    if (buffer_.size() > 0)
+      current_value_ = sum_ / buffer_.size();
+  }
+
+  size_t lookback(double = 0.0) const { return period_; }
+
   double value() const override { return current_value_; }
   bool is_ready() const override { return buffer_.is_full(); }
 
 private:
   int period_;
   double sum_;
-  CircularBuffer<double> buffer_;
+  Buffer buffer_;
   double current_value_ = 0.0;
 };
 
+using SimpleMovingAverage = BasicSimpleMovingAverage<>;
+
 // ---------------------------------------------------------
 // Exponential Moving Average (EMA)
 // ---------------------------------------------------------
@@ -65,6 +122,17 @@ public:
     return current_value_;
   }
 
+  void seed(std::span<const double> history) {
+    initialized_ = !history.empty();
+    current_value_ = initialized_ ? history[0] : 0.0;
+    for (size_t i = 1; i < history.size(); ++i)
+      current_value_ = alpha_ * history[i] + (1.0 - alpha_) * current_value_;
+  }
+
+  size_t lookback(double tolerance) const {
+    return decay_lookback(alpha_, tolerance);
+  }
+
   double value() const override { return current_value_; }
   bool is_ready() const override { return initialized_; }
 
@@ -95,8 +163,44 @@ public:
 
     double gain = (change > 0) ? change : 0.0;
     double loss = (change < 0) ? -change : 0.0;
+    smooth(gain, loss);
 
-    // Wilder's Smoothing
+    if (initialized_count_ < period_)
+      return 0.0;
+    set_value();
+    return current_value_;
+  }
+
+  // Gains / losses of the whole history come from kernels::gain_loss in
+  // chunks; the smoothing is the same per-change step as update().
+  void seed(std::span<const double> history) {
+    avg_gain_ = avg_loss_ = current_value_ = 0.0;
+    initialized_count_ = 0;
+    prev_price_ = history.empty() ? std::nan("") : history.back();
+
+    constexpr size_t CHUNK = 1024;
+    double gains[CHUNK], losses[CHUNK];
+    for (size_t start = 1; start < history.size(); start += CHUNK) {
+      size_t len = std::min(CHUNK, history.size() - start);
+      kernels::gain_loss(history.data() + start - 1, len + 1, gains, losses);
+      for (size_t j = 0; j < len; ++j)
+        smooth(gains[j], losses[j]);
+    }
+    if (initialized_count_ >= period_)
+      set_value();
+  }
+
+  size_t lookback(double tolerance) const {
+    size_t decay = decay_lookback(1.0 / period_, tolerance);
+    return decay == UNBOUNDED_LOOKBACK ? decay : period_ + 1 + decay;
+  }
+
+  double value() const override { return current_value_; }
+  bool is_ready() const override { return initialized_count_ >= period_; }
+
+private:
+  // Wilder's Smoothing
+  void smooth(double gain, double loss) {
     if (initialized_count_ < period_) {
       avg_gain_ += gain;
       avg_loss_ += loss;
@@ -110,23 +214,17 @@ public:
       avg_gain_ = (avg_gain_ * (period_ - 1) + gain) / period_;
       avg_loss_ = (avg_loss_ * (period_ - 1) + loss) / period_;
     }
+  }
 
-    if (initialized_count_ < period_)
-      return 0.0;
-
+  void set_value() {
     if (avg_loss_ == 0) {
       current_value_ = 100.0;
     } else {
       double rs = avg_gain_ / avg_loss_;
       current_value_ = 100.0 - (100.0 / (1.0 + rs));
     }
-    return current_value_;
   }
 
-  double value() const override { return current_value_; }
-  bool is_ready() const override { return initialized_count_ >= period_; }
-
-private:
   int period_;
   double avg_gain_;
   double avg_loss_;
@@ -145,27 +243,49 @@ struct BBResult {
   double pct_b;
 };
 
-class BollingerBands {
+template <typename Buffer = IndicatorBuffer> class BasicBollingerBands {
 public:
-  BollingerBands(int period, double std_dev_mult)
+  BasicBollingerBands(int period, double std_dev_mult)
       : period_(period), mult_(std_dev_mult), sma_(period), buffer_(period) {}
 
   BBResult update(double value) {
     double basis = sma_.update(value);
 
-    buffer_.push(value);
-
-    double variance = 0.0;
+    // O(1) variance: slide the window moments instead of re-summing it
     if (buffer_.is_full()) {
-      double sum_sq_diff = 0.0;
-      for (size_t i = 0; i < buffer_.size(); ++i) {
-        double diff = buffer_.get(i) - basis;
-        sum_sq_diff += diff * diff;
-      }
-      variance = sum_sq_diff / period_;
+      double oldest = buffer_[period_ - 1];
+      buffer_.push(value);
+      moments_.replace(oldest, value);
+      if (moments_.due_for_reanchor())
+        moments_.reanchor(buffer_);
+    } else {
+      buffer_.push(value);
+      moments_.add(value);
     }
 
-    double std_dev = std::sqrt(variance);
+    set_bands(value, basis);
+    return current_;
+  }
+
+  void seed(std::span<const double> history) {
+    sma_.seed(history);
+    buffer_ = Buffer(period_);
+    for (double v : history.last(std::min<size_t>(history.size(), period_)))
+      buffer_.push(v);
+    moments_.reanchor(buffer_);
+    current_ = {};
+    if (!history.empty())
+      set_bands(history.back(), sma_.value());
+  }
+
+  size_t lookback(double = 0.0) const { return period_; }
+
+  BBResult value() const { return current_; }
+  bool is_ready() const { return sma_.is_ready(); }
+
+private:
+  void set_bands(double value, double basis) {
+    double std_dev = buffer_.is_full() ? moments_.std_dev() : 0.0;
 
     current_ = {basis + mult_ * std_dev, basis, basis - mult_ * std_dev, 0.0};
 
@@ -175,21 +295,18 @@ public:
     } else {
       current_.pct_b = 0.5;
     }
-
-    return current_;
   }
 
-  BBResult value() const { return current_; }
-  bool is_ready() const { return sma_.is_ready(); }
-
-private:
   int period_;
   double mult_;
-  SimpleMovingAverage sma_;
-  CircularBuffer<double> buffer_;
-  BBResult current_;
+  BasicSimpleMovingAverage<Buffer> sma_;
+  Buffer buffer_;
+  RollingMoments moments_;
+  BBResult current_{};
 };
 
+using BollingerBands = BasicBollingerBands<>;
+
 // ---------------------------------------------------------
 // Average True Range (ATR)
 // ---------------------------------------------------------
@@ -210,7 +327,45 @@ public:
       tr = std::max({tr1, tr2, tr3});
     }
     prev_close_ = close;
+    smooth(tr);
+    return current_value_;
+  }
+
+  // Override standard update
+  double update(double value) override { return 0.0; }
+
+  // True ranges of the whole history (after its first bar's high - low)
+  // come from kernels::true_range in chunks. Columns of equal length.
+  void seed(std::span<const double> high, std::span<const double> low,
+            std::span<const double> close) {
+    initialized_count_ = 0;
+    current_value_ = 0.0;
+    prev_close_ = close.empty() ? std::nan("") : close.back();
+    if (close.empty())
+      return;
+
+    smooth(high[0] - low[0]);
+    constexpr size_t CHUNK = 1024;
+    double ranges[CHUNK];
+    for (size_t start = 1; start < close.size(); start += CHUNK) {
+      size_t len = std::min(CHUNK, close.size() - start);
+      kernels::true_range(high.data() + start - 1, low.data() + start - 1,
+                          close.data() + start - 1, len + 1, ranges);
+      for (size_t j = 0; j < len; ++j)
+        smooth(ranges[j]);
+    }
+  }
 
+  size_t lookback(double tolerance) const {
+    size_t decay = decay_lookback(1.0 / period_, tolerance);
+    return decay == UNBOUNDED_LOOKBACK ? decay : period_ + decay;
+  }
+
+  double value() const override { return current_value_; }
+  bool is_ready() const override { return initialized_count_ >= period_; }
+
+private:
+  void smooth(double tr) {
     if (initialized_count_ < period_) {
       current_value_ += tr;
       initialized_count_++;
@@ -221,17 +376,8 @@ public:
       // Wilder's Smoothing: (Prior ATR * (n-1) + Current TR) / n
       current_value_ = (current_value_ * (period_ - 1) + tr) / period_;
     }
-
-    return current_value_;
   }
 
-  // Override standard update
-  double update(double value) override { return 0.0; }
-
-  double value() const override { return current_value_; }
-  bool is_ready() const override { return initialized_count_ >= period_; }
-
-private:
   int period_;
   double prev_close_;
   int initialized_count_;
@@ -242,9 +388,10 @@ private:
 // Rate of Change (ROC) / Momentum
 // (Price_t - Price_t-n) / Price_t-n
 // ---------------------------------------------------------
-class RateOfChange : public Indicator {
+template <typename Buffer = IndicatorBuffer>
+class BasicRateOfChange : public Indicator {
 public:
-  explicit RateOfChange(int period)
+  explicit BasicRateOfChange(int period)
       : period_(period), buffer_(period + 1), current_value_(0.0) {}
 
   double update(double value) override {
@@ -261,7 +408,7 @@ public:
     // simple test: period=1. push 10, push 11. size=2.
     // get(0) = 11. get(1) = 10.
     // ROC = (11-10)/10.
-    double old_price = buffer_.get(period_);
+    double old_price = buffer_[period_];
 
     if (old_price != 0.0) {
       current_value_ = (value - old_price) / old_price;
@@ -271,53 +418,65 @@ public:
     return current_value_;
   }
 
+  void seed(std::span<const double> history) {
+    buffer_ = Buffer(period_ + 1);
+    current_value_ = 0.0;
+    auto tail = history.last(std::min<size_t>(history.size(), period_ + 1));
+    for (size_t i = 0; i + 1 < tail.size(); ++i)
+      buffer_.push(tail[i]);
+    if (!tail.empty())
+      update(tail.back());
+  }
+
+  size_t lookback(double = 0.0) const { return period_ + 1; }
+
   double value() const override { return current_value_; }
   bool is_ready() const override { return buffer_.size() > (size_t)period_; }
 
 private:
   int period_;
-  CircularBuffer<double> buffer_;
+  Buffer buffer_;
   double current_value_;
 };
 
+using RateOfChange = BasicRateOfChange<>;
+
 // ---------------------------------------------------------
 // Rolling Statistics (Mean, StdDev, ZScore)
 // ---------------------------------------------------------
-class RollingStats : public Indicator {
+template <typename Buffer = IndicatorBuffer>
+class BasicRollingStats : public Indicator {
 public:
-  explicit RollingStats(int period)
-      : period_(period), buffer_(period), count_(0), sum_(0.0), sum_sq_(0.0) {}
+  explicit BasicRollingStats(int period) : period_(period), buffer_(period) {}
 
   double update(double value) override {
-    double old_val = 0.0;
     if (buffer_.is_full()) {
-      old_val = buffer_.get(period_ - 1);
-      sum_ -= old_val;
-      sum_sq_ -= old_val * old_val;
-    }
-
-    buffer_.push(value);
-    sum_ += value;
-    sum_sq_ += value * value;
-
-    // Calculate stats
-    double n = (double)buffer_.size();
-    mean_ = sum_ / n;
-
-    double variance = (sum_sq_ / n) - (mean_ * mean_);
-    if (variance < 0)
-      variance = 0;
-    std_dev_ = std::sqrt(variance);
-
-    if (std_dev_ > 1e-9) {
-      zscore_ = (value - mean_) / std_dev_;
+      double old_val = buffer_[period_ - 1];
+      buffer_.push(value);
+      moments_.replace(old_val, value);
+      if (moments_.due_for_reanchor())
+        moments_.reanchor(buffer_);
     } else {
-      zscore_ = 0.0;
+      buffer_.push(value);
+      moments_.add(value);
     }
 
+    set_stats(value);
     return mean_;
   }
 
+  void seed(std::span<const double> history) {
+    buffer_ = Buffer(period_);
+    for (double v : history.last(std::min<size_t>(history.size(), period_)))
+      buffer_.push(v);
+    moments_.reanchor(buffer_);
+    mean_ = std_dev_ = zscore_ = 0.0;
+    if (!history.empty())
+      set_stats(history.back());
+  }
+
+  size_t lookback(double = 0.0) const { return period_; }
+
   double value() const override { return mean_; } // Default value is mean
   double std_dev() const { return std_dev_; }
   double zscore() const { return zscore_; }
@@ -325,15 +484,27 @@ public:
   bool is_ready() const override { return buffer_.is_full(); }
 
 private:
+  void set_stats(double value) {
+    // Calculate stats (Welford moments; no sum-of-squares cancellation)
+    mean_ = moments_.mean();
+    std_dev_ = moments_.std_dev();
+
+    if (std_dev_ > 1e-9) {
+      zscore_ = (value - mean_) / std_dev_;
+    } else {
+      zscore_ = 0.0;
+    }
+  }
+
   int period_;
-  CircularBuffer<double> buffer_;
-  size_t count_;
-  double sum_;
-  double sum_sq_;
+  Buffer buffer_;
+  RollingMoments moments_;
 
   double mean_ = 0.0;
   double std_dev_ = 0.0;
   double zscore_ = 0.0;
 };
 
+using RollingStats = BasicRollingStats<>;
+
 } // namespace quant
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace quant {
+
+/**
+ * @brief Fixed-size log-linear histogram of non-negative integer samples
+ * (e.g. nanoseconds).
+ *
+ * Each power-of-two range is split into 2^SUB_BITS equal buckets, so any
+ * recorded value is reported within ~1/2^SUB_BITS (3%) of its true value,
+ * from 1 ns to hours. All storage is inline: record() never allocates and
+ * costs a bit scan plus one increment, cheap enough for a per-bar hot path.
+ * min / max / mean are exact.
+ */
+class LatencyHistogram {
+public:
+  static constexpr unsigned SUB_BITS = 5;
+  static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BITS;
+  static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+  void record(uint64_t value) {
+    ++counts_[bucket_of(value)];
+    ++count_;
+    sum_ += static_cast<double>(value);
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  void merge(const LatencyHistogram &other) {
+    for (size_t i = 0; i < BUCKETS; ++i)
+      counts_[i] += other.counts_[i];
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+  }
+
+  void reset() { *this = LatencyHistogram(); }
+
+  uint64_t count() const { return count_; }
+  uint64_t min() const { return count_ ? min_ : 0; }
+  uint64_t max() const { return max_; }
+  double mean() const { return count_ ? sum_ / count_ : 0.0; }
+
+  /**
+   * @brief Value at quantile q in [0, 1] (0.5 = p50, 0.999 = p999): the
+   * midpoint of the bucket holding that rank, clamped to [min, max].
+   */
+  uint64_t percentile(double q) const {
+    if (count_ == 0)
+      return 0;
+    q = std::clamp(q, 0.0, 1.0);
+    uint64_t rank = std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(count_))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+      seen += counts_[i];
+      if (seen >= rank)
+        return std::clamp(bucket_mid(i), min(), max_);
+    }
+    return max_;
+  }
+
+private:
+  static size_t bucket_of(uint64_t v) {
+    if (v < SUB_BUCKETS)
+      return static_cast<size_t>(v);
+    const unsigned msb = std::bit_width(v) - 1; // >= SUB_BITS
+    const unsigned shift = msb - SUB_BITS;
+    const size_t sub = static_cast<size_t>(v >> shift) & (SUB_BUCKETS - 1);
+    return (shift + 1) * SUB_BUCKETS + sub;
+  }
+
+  static uint64_t bucket_mid(size_t i) {
+    if (i < SUB_BUCKETS)
+      return i;
+    const unsigned shift = static_cast<unsigned>(i / SUB_BUCKETS) - 1;
+    const uint64_t low = (SUB_BUCKETS + i % SUB_BUCKETS) << shift;
+    return low + ((uint64_t{1} << shift) >> 1);
+  }
+
+  std::array<uint64_t, BUCKETS> counts_{};
+  uint64_t count_ = 0;
+  double sum_ = 0.0;
+  uint64_t min_ = std::numeric_limits<uint64_t>::max();
+  uint64_t max_ = 0;
+};
+
+} // namespace quant
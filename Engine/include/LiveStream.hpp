@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Engine.hpp"
+#include "LatencyHistogram.hpp"
+#include "SpscQueue.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace quant {
+
+inline constexpr size_t DEFAULT_STREAM_CAPACITY = 4096; // ~2.8 days of 1-min bars
+
+/**
+ * @brief Live bar ingestion: a feed thread publishes bars into a bounded
+ * SPSC queue, the engine thread drains it through Engine::on_bar().
+ *
+ * Each bar is stamped on publish(); the consumer records publish -> signal
+ * latency (queueing + on_bar) per bar into a LatencyHistogram. The queue,
+ * histogram and engine stack are all set up before the first bar, so the
+ * consumer loop takes no locks and does no setup allocation (the trade log
+ * still grows as trades close).
+ *
+ * One producer thread (publish / close) and one consumer thread (run).
+ */
+class LiveStream {
+public:
+  explicit LiveStream(Engine &engine, size_t capacity = DEFAULT_STREAM_CAPACITY)
+      : engine_(engine), queue_(capacity) {}
+
+  // -------------------------------------------------------
+  // Producer (feed thread)
+  // -------------------------------------------------------
+  // Returns false if the queue is full (bar dropped by the caller's choice).
+  bool try_publish(const Bar &bar) {
+    return queue_.try_push({bar, now_ns()});
+  }
+
+  // Waits for space (back-pressure on the feed rather than dropping).
+  void publish(const Bar &bar) {
+    Stamped item{bar, now_ns()};
+    while (!queue_.try_push(item))
+      std::this_thread::yield();
+  }
+
+  // No more bars; run() returns once the queue is drained.
+  void close() { closed_.store(true, std::memory_order_release); }
+
+  // -------------------------------------------------------
+  // Consumer (engine thread)
+  // -------------------------------------------------------
+  /**
+   * @brief Drive the engine until close() and the queue is empty. on_signal
+   * (bar, signal) is called right after each bar's signal is known.
+   */
+  template <typename OnSignal> void run(OnSignal &&on_signal) {
+    if (!engine_.streaming())
+      engine_.start_stream();
+    Stamped item;
+    for (;;) {
+      if (!queue_.try_pop(item)) {
+        if (!closed_.load(std::memory_order_acquire)) {
+          std::this_thread::yield();
+          continue;
+        }
+        // Bars published before close() are visible now
+        if (!queue_.try_pop(item))
+          break;
+      }
+      int signal = engine_.on_bar(item.bar);
+      latency_.record(static_cast<uint64_t>(now_ns() - item.published_ns));
+      on_signal(item.bar, signal);
+    }
+  }
+
+  void run() {
+    run([](const Bar &, int) {});
+  }
+
+  // Publish -> signal latency in nanoseconds, one sample per bar.
+  const LatencyHistogram &latency() const { return latency_; }
+
+  size_t capacity() const { return queue_.capacity(); }
+
+private:
+  struct Stamped {
+    Bar bar;
+    int64_t published_ns = 0;
+  };
+
+  static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  Engine &engine_;
+  SpscQueue<Stamped> queue_;
+  std::atomic<bool> closed_{false};
+  LatencyHistogram latency_;
+};
+
+} // namespace quant
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace quant {
+
+/**
+ * @brief Read-only memory mapping of a whole file (RAII).
+ * Lets loaders scan file contents in place without copying them into
+ * std::string buffers. Move-only; the mapping is released on destruction.
+ */
+class MappedFile {
+public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string &filepath) { open(filepath); }
+  ~MappedFile() { close(); }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  /**
+   * @brief Map the file at filepath. Any previous mapping is released.
+   * @return true on success (an empty file maps successfully with size 0)
+   */
+  bool open(const std::string &filepath);
+  void close();
+
+  bool is_open() const { return is_open_; }
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+  std::string_view view() const { return {data_, size_}; }
+
+private:
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+  bool is_open_ = false;
+#ifdef _WIN32
+  void *file_handle_ = nullptr;
+  void *mapping_handle_ = nullptr;
+#endif
+};
+
+} // namespace quant
@@ -1,13 +1,40 @@
 #pragma once
 
 #include "Bar.hpp"
-#include <map>
+#include "BarCache.hpp"
+#include "BarSeries.hpp"
+#include "SessionIndex.hpp"
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 
 namespace quant {
 
+// Dense id of an interned symbol: 0, 1, 2, ... in first-seen order. Id
+// lookups index a flat store; only interning touches the symbol string.
+using SymbolId = uint32_t;
+constexpr SymbolId NO_SYMBOL = std::numeric_limits<SymbolId>::max();
+
+// Outcome of a bulk load (load_files / load_directory).
+struct LoadReport {
+  size_t files = 0;
+  size_t loaded = 0;
+  size_t from_cache = 0;              // Mapped from .qbar instead of parsed
+  std::vector<std::string> failed;    // Symbols that did not load
+  uint64_t bytes = 0;                 // Source CSV bytes of loaded files
+  uint64_t read_bytes = 0;            // Bytes read: .qbar size when cached
+  unsigned threads = 1;
+  double wall_ms = 0.0;
+  double mb_per_sec = 0.0;            // read_bytes / wall_ms
+};
+
 /**
  * @brief Manages market data (loading, storage, and access).
  * Optimized for sequential access during backtesting.
@@ -20,6 +47,12 @@ public:
   /**
    * @brief Load CSV data for a specific symbol.
    * Expected format: timestamp(or datetime),open,high,low,close,volume
+   * Timestamps may be Unix seconds or ISO-8601 date/times; wall-clock times
+   * are converted to UTC using the symbol's configured exchange offset.
+   *
+   * After the first parse a binary columnar cache (<filepath>.qbar) is
+   * written next to the CSV; later loads map that cache instead of parsing
+   * as long as it is newer than the CSV and was built with the same offset.
    *
    * @param symbol The ticker symbol (e.g., "ICICIBANK")
    * @param filepath Absolute path to the CSV file
@@ -28,12 +61,138 @@ public:
   bool load_csv(const std::string &symbol, const std::string &filepath);
 
   /**
-   * @brief Get all loaded bars for a symbol.
+   * @brief Load many (symbol, CSV path) pairs in parallel, one file per
+   * task, each exactly as load_csv() would (cache included). Symbols are
+   * interned up front in list order, so ids do not depend on which worker
+   * finishes first. A symbol listed twice is loaded once (first path) and
+   * the repeat reported as failed. Prints failures and one summary line
+   * instead of a line per file.
+   *
+   * @param num_threads Workers; 0 = one per hardware thread
+   */
+  LoadReport
+  load_files(const std::vector<std::pair<std::string, std::string>> &files,
+             unsigned num_threads = 0);
+
+  /**
+   * @brief load_files() over every *.csv in `directory` (not recursive),
+   * symbol = file stem ("ICICIBANK.csv" -> "ICICIBANK"), in file name
+   * order. A missing directory loads nothing.
+   */
+  LoadReport load_directory(const std::string &directory,
+                            unsigned num_threads = 0);
+
+  // The (symbol, path) list load_directory() loads.
+  static std::vector<std::pair<std::string, std::string>>
+  list_csv_files(const std::string &directory);
+
+  /**
+   * @brief Id for a symbol, assigning the next one if it is new. Interned
+   * symbols without data read as empty.
+   */
+  SymbolId intern(const std::string &symbol);
+
+  // Id of a known symbol, or NO_SYMBOL.
+  SymbolId symbol_id(const std::string &symbol) const;
+  const std::string &symbol_name(SymbolId id) const {
+    return store_[id].symbol;
+  }
+  size_t symbol_count() const { return store_.size(); }
+
+  /**
+   * @brief Store bars produced in memory (synthetic data, another feed)
+   * under a symbol, replacing any loaded data. Bars must be in time order.
+   */
+  void add_bars(const std::string &symbol, std::vector<Bar> bars);
+
+  /**
+   * @brief Get all loaded bars for a symbol (empty if unknown). The SymbolId
+   * overloads skip the string lookup; the id must come from this manager.
    */
   const std::vector<Bar> &get_bars(const std::string &symbol) const;
+  const std::vector<Bar> &get_bars(SymbolId id) const {
+    return store_[id].bars;
+  }
+
+  /**
+   * @brief Get the same bars as aligned columns (structure of arrays), for
+   * vectorized consumers such as the functions in features.hpp.
+   *
+   * The rows are the only copy a load keeps; the columns are built on the
+   * first call for a symbol and kept until it is reloaded, so a symbol costs
+   * a second copy of its bars only once something asks for columns. A
+   * symbol loaded from its .qbar cache gets them copied straight out of the
+   * cache's columns (one memcpy each); otherwise they are gathered from the
+   * rows. Safe to call from several threads at once.
+   */
+  const BarSeries &get_series(const std::string &symbol) const;
+  const BarSeries &get_series(SymbolId id) const;
+
+  /**
+   * @brief Per-bar trading day / session boundaries, built at load time from
+   * the timestamps with the symbol's exchange offset.
+   */
+  const SessionIndex &get_sessions(const std::string &symbol) const;
+  const SessionIndex &get_sessions(SymbolId id) const {
+    return store_[id].sessions;
+  }
+
+  /**
+   * @brief Set the exchange timezone for a symbol (seconds ahead of UTC,
+   * e.g. 19800 for NSE/IST). Applies to subsequent loads; default is 0.
+   */
+  void set_utc_offset(const std::string &symbol, int64_t offset_seconds);
+  int64_t utc_offset_seconds(const std::string &symbol) const;
+
+  /**
+   * @brief Enable/disable reading and writing .qbar caches (default on).
+   */
+  void set_cache_enabled(bool enabled) { cache_enabled_ = enabled; }
 
 private:
-  std::map<std::string, std::vector<Bar>> data_store_;
+  // Row layout drives the event loop and is what a load stores. A load
+  // from cache also records which .qbar (and its verified header) the rows
+  // came from, so get_series() can copy the columns from it.
+  struct SymbolData {
+    std::vector<Bar> bars;
+    SessionIndex sessions;
+    std::string cache_path;
+    QBarHeader cache_header{};
+  };
+
+  // `series` is the column copy get_series() builds on demand; null until
+  // then and reset whenever the bars are replaced.
+  struct SymbolSlot : SymbolData {
+    std::string symbol;
+    int64_t utc_offset = 0;
+    mutable std::mutex series_mutex;
+    mutable std::unique_ptr<const BarSeries> series;
+  };
+
+  // Replaces a slot's bars and drops the columns built from the old ones.
+  static void store_data(SymbolSlot &slot, SymbolData data);
+
+  // Parses (or maps) one file into `data` without touching the store or
+  // any file, so workers can run it concurrently. On failure `error` holds
+  // the message.
+  bool read_symbol_file(const std::string &symbol, const std::string &filepath,
+                        int64_t utc_offset, SymbolData &data,
+                        uint64_t &source_size, bool &from_cache,
+                        std::string &error) const;
+
+  // Writes the .qbar cache of a file read_symbol_file() just parsed,
+  // gathering the columns it stores from the bars for the write only. On
+  // failure `warning` holds the message for the caller to print (workers
+  // never write to std::cerr themselves).
+  static bool write_symbol_cache(const std::string &filepath,
+                                 const SymbolData &data, int64_t utc_offset,
+                                 uint64_t source_size, std::string &warning);
+
+  // Indexed by SymbolId. A deque so references handed out by get_bars() and
+  // friends survive interning more symbols.
+  std::deque<SymbolSlot> store_;
+  std::unordered_map<std::string, SymbolId> ids_;
+  bool cache_enabled_ = true;
 };
 
 } // namespace quant
@@ -0,0 +1,371 @@
+#pragma once
+
+#include "ThreadPool.hpp"
+#include "TradeLog.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Monte Carlo Robustness
+// ---------------------------------------------------------
+// Resamples one run's trades or per-bar returns into many synthetic paths
+// and records each path's final return and max drawdown:
+//
+//   TradeShuffle     the trades' P&L in a random order: same total, the
+//                    drawdown distribution shows how lucky the order was
+//   TradeBootstrap   blocks of block_length consecutive trades drawn with
+//                    replacement (circularly), path_length trades per path
+//   ReturnBootstrap  the same over per-bar simple returns, compounded
+//                    (moving-block bootstrap; blocks keep autocorrelation)
+//
+// Every path draws from its own counter-based stream (Philox4x32-10 keyed
+// by the seed, counter = path index and draw number), so a path's numbers
+// do not depend on which thread runs it: results are identical for any
+// thread count. Outputs go into caller-owned arrays (NumPy buffers
+// through pybind) or a MonteCarloResult allocated once per call.
+
+enum class Resampling : uint8_t { TradeShuffle, TradeBootstrap, ReturnBootstrap };
+
+inline const char *resampling_name(Resampling method) {
+  switch (method) {
+  case Resampling::TradeShuffle:
+    return "trade shuffle";
+  case Resampling::TradeBootstrap:
+    return "trade bootstrap";
+  case Resampling::ReturnBootstrap:
+    return "return bootstrap";
+  }
+  return "?";
+}
+
+struct MonteCarloConfig {
+  size_t paths = 10000;
+  size_t block_length = 10; // Bootstrap block (1 = independent draws)
+  size_t path_length = 0;   // Draws per bootstrap path; 0 = input length
+  uint64_t seed = 42;
+};
+
+/**
+ * @brief Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy
+ * as 1, 2, 3"): a keyed bijection of a 128-bit counter, so any draw of any
+ * stream is computed directly instead of by stepping a state.
+ */
+struct Philox4x32 {
+  using Counter = std::array<uint32_t, 4>;
+  using Key = std::array<uint32_t, 2>;
+
+  static Counter generate(Counter c, Key k) {
+    for (int round = 0; round < 10; ++round) {
+      if (round > 0) {
+        k[0] += 0x9E3779B9u;
+        k[1] += 0xBB67AE85u;
+      }
+      const uint64_t p0 = uint64_t{0xD2511F53u} * c[0];
+      const uint64_t p1 = uint64_t{0xCD9E8D57u} * c[2];
+      c = {static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k[0],
+           static_cast<uint32_t>(p1),
+           static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k[1],
+           static_cast<uint32_t>(p0)};
+    }
+    return c;
+  }
+};
+
+/**
+ * @brief One path's random stream: 32-bit draws from Philox blocks with
+ * counter (block, path), four draws per block.
+ */
+class PathRng {
+public:
+  PathRng(uint64_t seed, uint64_t path)
+      : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+        path_(path) {}
+
+  uint32_t next() {
+    if (used_ == 4) {
+      out_ = Philox4x32::generate({static_cast<uint32_t>(block_),
+                                   static_cast<uint32_t>(block_ >> 32),
+                                   static_cast<uint32_t>(path_),
+                                   static_cast<uint32_t>(path_ >> 32)},
+                                  key_);
+      ++block_;
+      used_ = 0;
+    }
+    return out_[used_++];
+  }
+
+  // Uniform in [0, n) by multiply-shift (bias below n / 2^32).
+  uint32_t below(uint32_t n) {
+    return static_cast<uint32_t>((uint64_t{next()} * n) >> 32);
+  }
+
+private:
+  Philox4x32::Key key_;
+  uint64_t path_;
+  uint64_t block_ = 0;
+  Philox4x32::Counter out_{};
+  int used_ = 4;
+};
+
+// ---------------------------------------------------------
+// Inputs and results
+// ---------------------------------------------------------
+// P&L per closed trade, in order (ExecutionEngine::get_trades()).
+inline std::vector<double> trade_pnls(std::span<const Trade> trades) {
+  std::vector<double> pnl;
+  pnl.reserve(trades.size());
+  for (const Trade &t : trades)
+    pnl.push_back(t.pnl);
+  return pnl;
+}
+
+// Simple per-bar returns of an equity column (EquityCurve::equity()),
+// n - 1 of them.
+inline std::vector<double> bar_returns(std::span<const double> equity) {
+  std::vector<double> returns;
+  if (equity.size() < 2)
+    return returns;
+  returns.reserve(equity.size() - 1);
+  for (size_t i = 1; i < equity.size(); ++i)
+    returns.push_back(equity[i - 1] != 0 ? equity[i] / equity[i - 1] - 1.0
+                                         : 0.0);
+  return returns;
+}
+
+// Per-path outputs, caller-owned, each at least `paths` long.
+struct MonteCarloOut {
+  std::span<double> final_return; // Fraction of starting equity
+  std::span<double> max_drawdown; // Fraction of the running peak
+};
+
+struct DistributionSummary {
+  double mean = 0.0;
+  double p05 = 0.0;
+  double p50 = 0.0;
+  double p95 = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+};
+
+// Mean and nearest-rank percentiles (sorts a copy).
+inline DistributionSummary summarize(std::span<const double> values) {
+  DistributionSummary s;
+  if (values.empty())
+    return s;
+  std::vector<double> sorted(values.begin(), values.end());
+  std::sort(sorted.begin(), sorted.end());
+  auto at = [&](double q) {
+    return sorted[static_cast<size_t>(q * (sorted.size() - 1) + 0.5)];
+  };
+  double sum = 0.0;
+  for (double v : sorted)
+    sum += v;
+  s.mean = sum / sorted.size();
+  s.p05 = at(0.05);
+  s.p50 = at(0.50);
+  s.p95 = at(0.95);
+  s.min = sorted.front();
+  s.max = sorted.back();
+  return s;
+}
+
+struct MonteCarloResult {
+  Resampling method = Resampling::TradeShuffle;
+  size_t draws = 0; // Per path
+  std::vector<double> final_return;
+  std::vector<double> max_drawdown;
+  unsigned threads = 1;
+  double wall_ms = 0.0;
+  double paths_per_sec = 0.0;
+
+  MonteCarloOut out() { return {final_return, max_drawdown}; }
+};
+
+/**
+ * @brief Parallel resampling of one run (see above). Paths are split into
+ * fixed chunks handed to a ThreadPool; each chunk writes its own slice of
+ * the outputs, so workers share nothing but the read-only input.
+ */
+class MonteCarlo {
+public:
+  explicit MonteCarlo(const MonteCarloConfig &config = {}) : config_(config) {}
+
+  const MonteCarloConfig &config() const { return config_; }
+
+  // Draws per path for `method` over `n` inputs.
+  size_t draws(Resampling method, size_t n) const {
+    if (method == Resampling::TradeShuffle || config_.path_length == 0)
+      return n;
+    return config_.path_length;
+  }
+
+  /**
+   * @brief Resample `input` (trade P&L for the trade methods, per-bar
+   * returns for ReturnBootstrap) into out[0, paths). Trade paths start at
+   * `capital`. Throws std::invalid_argument if an output is shorter than
+   * config().paths or the input has 2^32 or more values.
+   */
+  void run(Resampling method, std::span<const double> input, double capital,
+           MonteCarloOut out,
+           unsigned num_threads = ThreadPool::default_threads()) const {
+    const size_t paths = config_.paths;
+    if (out.final_return.size() < paths || out.max_drawdown.size() < paths)
+      throw std::invalid_argument("monte carlo: outputs shorter than paths");
+    if (input.size() > std::numeric_limits<uint32_t>::max())
+      throw std::invalid_argument("monte carlo: input too long");
+    if (input.empty()) {
+      std::fill_n(out.final_return.begin(), paths, 0.0);
+      std::fill_n(out.max_drawdown.begin(), paths, 0.0);
+      return;
+    }
+
+    const size_t chunks = (paths + CHUNK - 1) / CHUNK;
+    auto run_chunk = [&](size_t chunk) {
+      const size_t begin = chunk * CHUNK;
+      const size_t end = std::min(paths, begin + CHUNK);
+      switch (method) {
+      case Resampling::TradeShuffle:
+        shuffle_paths(input, capital, begin, end, out);
+        return;
+      case Resampling::TradeBootstrap:
+        bootstrap_paths<false>(input, capital, begin, end, out);
+        return;
+      case Resampling::ReturnBootstrap:
+        bootstrap_paths<true>(input, 1.0, begin, end, out);
+        return;
+      }
+    };
+    num_threads = static_cast<unsigned>(
+        std::min<size_t>(std::max(1u, num_threads), chunks));
+    if (num_threads == 1) {
+      for (size_t c = 0; c < chunks; ++c)
+        run_chunk(c);
+      return;
+    }
+    ThreadPool pool(num_threads);
+    pool.parallel_for(chunks, run_chunk);
+  }
+
+  // Same into a result allocated for config().paths.
+  MonteCarloResult run(Resampling method, std::span<const double> input,
+                       double capital,
+                       unsigned num_threads = ThreadPool::default_threads()) const {
+    MonteCarloResult result;
+    result.method = method;
+    result.draws = input.empty() ? 0 : draws(method, input.size());
+    result.final_return.resize(config_.paths);
+    result.max_drawdown.resize(config_.paths);
+    result.threads = num_threads;
+    auto t0 = std::chrono::steady_clock::now();
+    run(method, input, capital, result.out(), num_threads);
+    auto t1 = std::chrono::steady_clock::now();
+    result.wall_ms =
+        std::chrono::duration<double, std::milli>(t1 - t0).count();
+    result.paths_per_sec =
+        result.wall_ms > 0 ? config_.paths / result.wall_ms * 1000.0 : 0.0;
+    return result;
+  }
+
+  static void print(const MonteCarloResult &result,
+                    std::ostream &out = std::cout) {
+    const DistributionSummary ret = summarize(result.final_return);
+    const DistributionSummary dd = summarize(result.max_drawdown);
+    out << "\n[MC] " << resampling_name(result.method) << ": "
+        << result.final_return.size() << " paths x " << result.draws
+        << " draws\n"
+        << "[MC]         " << std::setw(10) << "mean" << std::setw(10) << "p5"
+        << std::setw(10) << "p50" << std::setw(10) << "p95" << std::setw(10)
+        << "worst" << "\n"
+        << std::fixed << std::setprecision(2) << "[MC] return% "
+        << std::setw(10) << ret.mean * 100 << std::setw(10) << ret.p05 * 100
+        << std::setw(10) << ret.p50 * 100 << std::setw(10) << ret.p95 * 100
+        << std::setw(10) << ret.min * 100 << "\n"
+        << "[MC] maxDD%  " << std::setw(10) << dd.mean * 100 << std::setw(10)
+        << dd.p05 * 100 << std::setw(10) << dd.p50 * 100 << std::setw(10)
+        << dd.p95 * 100 << std::setw(10) << dd.max * 100 << "\n"
+        << "[BENCHMARK] " << result.threads << " threads in "
+        << std::setprecision(1) << result.wall_ms << " ms ("
+        << std::setprecision(0) << result.paths_per_sec << " paths/sec)\n";
+  }
+
+private:
+  static constexpr size_t CHUNK = 64; // Paths per task
+
+  // Running equity, peak and max drawdown of one path.
+  template <bool Compound> struct PathStats {
+    double equity;
+    double peak;
+    double max_drawdown = 0.0;
+
+    explicit PathStats(double start) : equity(start), peak(start) {}
+
+    void add(double x) {
+      if constexpr (Compound)
+        equity *= 1.0 + x;
+      else
+        equity += x;
+      if (equity > peak)
+        peak = equity;
+      else if (peak > 0)
+        max_drawdown = std::max(max_drawdown, (peak - equity) / peak);
+    }
+  };
+
+  void shuffle_paths(std::span<const double> pnl, double capital, size_t begin,
+                     size_t end, MonteCarloOut out) const {
+    std::vector<double> deck(pnl.size());
+    for (size_t p = begin; p < end; ++p) {
+      // Fisher-Yates from the back; each slot is final once swapped, so
+      // the path walks the permutation as it is drawn.
+      std::copy(pnl.begin(), pnl.end(), deck.begin());
+      PathRng rng(config_.seed, p);
+      PathStats<false> stats(capital);
+      for (size_t i = deck.size(); i-- > 1;) {
+        std::swap(deck[i], deck[rng.below(static_cast<uint32_t>(i + 1))]);
+        stats.add(deck[i]);
+      }
+      stats.add(deck[0]);
+      out.final_return[p] = capital != 0 ? stats.equity / capital - 1.0 : 0.0;
+      out.max_drawdown[p] = stats.max_drawdown;
+    }
+  }
+
+  template <bool Compound>
+  void bootstrap_paths(std::span<const double> input, double start,
+                       size_t begin, size_t end, MonteCarloOut out) const {
+    const size_t n = input.size();
+    const size_t length = draws(Resampling::TradeBootstrap, n);
+    const size_t block = std::clamp<size_t>(config_.block_length, 1, n);
+    for (size_t p = begin; p < end; ++p) {
+      PathRng rng(config_.seed, p);
+      PathStats<Compound> stats(start);
+      for (size_t drawn = 0; drawn < length;) {
+        size_t i = rng.below(static_cast<uint32_t>(n));
+        const size_t take = std::min(block, length - drawn);
+        for (size_t k = 0; k < take; ++k) {
+          stats.add(input[i]);
+          if (++i == n)
+            i = 0; // Circular blocks
+        }
+        drawn += take;
+      }
+      out.final_return[p] = start != 0 ? stats.equity / start - 1.0 : 0.0;
+      out.max_drawdown[p] = stats.max_drawdown;
+    }
+  }
+
+  MonteCarloConfig config_;
+};
+
+} // namespace quant
@@ -0,0 +1,457 @@
+#pragma once
+
+#include "BatchIndicators.hpp"
+#include "Engine.hpp"
+#include "Portfolio.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <limits>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace quant {
+
+// Upper bound on symbols sharing one BatchIndicatorRegistry in
+// MultiSymbolRunner::run_batched (one lane per symbol).
+inline constexpr size_t DEFAULT_BATCH_LANES = 64;
+// Narrowest group run_batched batches. Below it the per-timestamp work
+// (merge, packing, one pass per registry slot) costs more per lane than the
+// scalar registry it replaces, so run_batched runs run() instead.
+inline constexpr size_t MIN_BATCH_LANES = 16;
+
+// A closed trade tagged with the symbol it came from (index into
+// MultiSymbolResult::per_symbol / the runner's symbol list).
+struct SymbolTrade {
+  uint32_t symbol_index;
+  Trade trade;
+};
+
+struct MultiSymbolResult {
+  std::vector<BacktestResult> per_symbol; // Same order as the symbol list
+  std::vector<SymbolTrade> trades;        // All symbols, sorted by exit time
+  PerformanceReport aggregate;            // Capital = N x per-symbol capital
+  RegimeStats regimes;                    // Summed over all symbols
+  size_t total_bars = 0;
+  double wall_ms = 0.0;
+  double bars_per_sec = 0.0;
+  unsigned threads = 1;
+  PortfolioSummary portfolio; // run_portfolio() only
+};
+
+struct ScalingPoint {
+  unsigned threads;
+  double wall_ms;
+  double bars_per_sec;
+  double speedup;    // vs. 1 thread
+  double efficiency; // speedup / threads
+};
+
+/**
+ * @brief Runs the same strategy stack over many symbols in parallel.
+ * Each task owns an independent Engine (strategies, risk, execution state);
+ * the only shared object is the read-only MarketDataManager, so workers
+ * never synchronize during the event loop.
+ */
+class MultiSymbolRunner {
+public:
+  MultiSymbolRunner(std::shared_ptr<MarketDataManager> market_data,
+                    std::vector<std::string> symbols)
+      : market_data_(std::move(market_data)), symbols_(std::move(symbols)) {
+    // Resolve names once; tasks index the store by id. Unknown symbols are
+    // interned and run as empty.
+    ids_.reserve(symbols_.size());
+    for (const auto &symbol : symbols_)
+      ids_.push_back(market_data_->intern(symbol));
+  }
+
+  const std::vector<std::string> &symbols() const { return symbols_; }
+
+  MultiSymbolResult run(unsigned num_threads = ThreadPool::default_threads()) {
+    MultiSymbolResult result;
+    result.threads = std::max(1u, num_threads);
+    result.per_symbol.resize(symbols_.size());
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    {
+      ThreadPool pool(result.threads);
+      pool.parallel_for(symbols_.size(), [&](size_t i) {
+        Engine engine(market_data_);
+        result.per_symbol[i] = engine.run_backtest(ids_[i]);
+      });
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.wall_ms =
+        std::chrono::duration_cast<std::chrono::microseconds>(end_time -
+                                                              start_time)
+            .count() /
+        1000.0;
+
+    merge(result);
+    return result;
+  }
+
+  /**
+   * @brief Same backtests as run(), with indicators batched across symbols.
+   *
+   * Symbols are split into groups of up to max_lanes; each group shares one
+   * BatchIndicatorRegistry (one lane per symbol, SoA state) and walks the
+   * union of its symbols' timestamps in order. Per timestamp the registry
+   * advances every lane that has a bar in one pass, then each of those
+   * symbols' Engine steps its LaneStrategyStack. Per-symbol results are
+   * identical to run(); groups run in parallel on the thread pool.
+   * BacktestResult::elapsed_ms is the group's event loop time. When the
+   * groups would be narrower than MIN_BATCH_LANES (few symbols per thread,
+   * or a small max_lanes) this is run(num_threads).
+   */
+  MultiSymbolResult
+  run_batched(unsigned num_threads = ThreadPool::default_threads(),
+              size_t max_lanes = DEFAULT_BATCH_LANES) {
+    MultiSymbolResult result;
+    result.threads = std::max(1u, num_threads);
+
+    // Enough groups to occupy every thread, each as wide as allowed
+    const size_t n = symbols_.size();
+    size_t lanes = std::max<size_t>(1, std::min(max_lanes,
+                                                (n + result.threads - 1) /
+                                                    result.threads));
+    if (lanes < MIN_BATCH_LANES)
+      return run(num_threads);
+    size_t groups = (n + lanes - 1) / lanes;
+    result.per_symbol.resize(n);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    {
+      ThreadPool pool(result.threads);
+      pool.parallel_for(groups, [&](size_t g) {
+        size_t first = g * lanes;
+        run_group(first, std::min(first + lanes, n), result.per_symbol);
+      });
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.wall_ms =
+        std::chrono::duration_cast<std::chrono::microseconds>(end_time -
+                                                              start_time)
+            .count() /
+        1000.0;
+
+    merge(result);
+    return result;
+  }
+
+  /**
+   * @brief Backtest every symbol against one shared Portfolio: each Engine
+   * starts with an equal sleeve of config.capital, sizes entries per
+   * config.sizing from the portfolio's equity and is clamped to its gross /
+   * net / per-symbol limits (see Portfolio.hpp).
+   *
+   * Symbols are split into one contiguous group per thread. Every worker
+   * steps its symbols through the bars of the current epoch (timestamps in
+   * [t, t + reconcile_seconds)), reports each symbol's PositionState into
+   * its own slot and arrives at a barrier; the barrier's completion step
+   * reconciles the portfolio and opens the next epoch at the earliest
+   * remaining timestamp. Workers share nothing else, and results do not
+   * depend on the thread count.
+   */
+  MultiSymbolResult
+  run_portfolio(const PortfolioConfig &config,
+                unsigned num_threads = ThreadPool::default_threads()) {
+    MultiSymbolResult result;
+    const size_t n = symbols_.size();
+    result.threads = static_cast<unsigned>(
+        std::clamp<size_t>(num_threads, 1, std::max<size_t>(1, n)));
+    result.per_symbol.resize(n);
+
+    Portfolio portfolio(config, n);
+    std::vector<std::span<const Bar>> bars(n);
+    std::vector<const SessionIndex *> sessions(n);
+    std::vector<Engine> engines;
+    std::vector<std::unique_ptr<StaticStrategyStack<>>> stacks;
+    engines.reserve(n);
+    stacks.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      bars[i] = market_data_->get_bars(ids_[i]);
+      sessions[i] = &market_data_->get_sessions(ids_[i]);
+      engines.emplace_back(market_data_);
+      engines[i].set_initial_capital(portfolio.sleeve_capital());
+      engines[i].set_position_sizing(config.sizing);
+      engines[i].set_portfolio_budget(&portfolio.budget(i));
+      engines[i].start_run();
+      stacks.push_back(std::make_unique<StaticStrategyStack<>>(
+          engines[i].strategy_params(), engines[i].regime_allocation()));
+      engines[i].bind_sizing(*stacks[i]);
+    }
+
+    std::vector<size_t> cursor(n, 0);
+    const size_t groups = result.threads;
+    const size_t per_group = n > 0 ? (n + groups - 1) / groups : 0;
+
+    // Earliest unprocessed timestamp; the epoch runs up to epoch_end
+    auto open_epoch = [&]() {
+      int64_t ts = std::numeric_limits<int64_t>::max();
+      for (size_t i = 0; i < n; ++i)
+        if (cursor[i] < bars[i].size())
+          ts = std::min<int64_t>(ts, bars[i][cursor[i]].timestamp);
+      return ts;
+    };
+    int64_t epoch_begin = open_epoch();
+    auto epoch_end = [&](int64_t begin) {
+      return begin + std::max<int64_t>(1, config.reconcile_seconds);
+    };
+    int64_t end = epoch_end(epoch_begin);
+    bool done = epoch_begin == std::numeric_limits<int64_t>::max();
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+
+    std::barrier sync(static_cast<std::ptrdiff_t>(groups), [&]() noexcept {
+      portfolio.reconcile();
+      epoch_begin = open_epoch();
+      end = epoch_end(epoch_begin);
+      done = failed.load() ||
+             epoch_begin == std::numeric_limits<int64_t>::max();
+    });
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    {
+      // One task per pool thread: every group must reach each barrier
+      ThreadPool pool(result.threads);
+      pool.parallel_for(groups, [&](size_t g) {
+        const size_t first = std::min(n, g * per_group);
+        const size_t last = std::min(n, first + per_group);
+        try {
+          while (!done) {
+            for (size_t i = first; i < last; ++i) {
+              size_t &c = cursor[i];
+              if (c >= bars[i].size() || bars[i][c].timestamp >= end)
+                continue;
+              for (; c < bars[i].size() && bars[i][c].timestamp < end; ++c)
+                engines[i].step(bars[i][c], (*sessions[i])[c], *stacks[i],
+                                result.per_symbol[i]);
+              portfolio.report(i,
+                               engines[i].position_state(bars[i][c - 1].close));
+            }
+            sync.arrive_and_wait();
+          }
+        } catch (...) {
+          if (!failed.exchange(true))
+            error = std::current_exception();
+          sync.arrive_and_drop();
+        }
+      });
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    if (error)
+      std::rethrow_exception(error);
+    result.wall_ms =
+        std::chrono::duration_cast<std::chrono::microseconds>(end_time -
+                                                              start_time)
+            .count() /
+        1000.0;
+
+    for (size_t i = 0; i < n; ++i) {
+      BacktestResult &r = result.per_symbol[i];
+      r.symbol = symbols_[i];
+      if (bars[i].empty())
+        continue;
+      r.elapsed_ms = result.wall_ms;
+      engines[i].finish_run(r, bars[i].back().close);
+    }
+    merge(result);
+    result.portfolio = portfolio.summary();
+    return result;
+  }
+
+  /**
+   * @brief Re-run the whole universe at 1, 2, 4, ... up to max_threads and
+   * report aggregate throughput per core count.
+   */
+  std::vector<ScalingPoint>
+  scaling_report(unsigned max_threads = ThreadPool::default_threads()) {
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < max_threads; t *= 2)
+      counts.push_back(t);
+    counts.push_back(std::max(1u, max_threads));
+
+    std::vector<ScalingPoint> points;
+    double base_rate = 0.0;
+    for (unsigned t : counts) {
+      MultiSymbolResult r = run(t);
+      if (points.empty())
+        base_rate = r.bars_per_sec;
+      double speedup = base_rate > 0 ? r.bars_per_sec / base_rate : 0.0;
+      points.push_back({t, r.wall_ms, r.bars_per_sec, speedup, speedup / t});
+    }
+    return points;
+  }
+
+  static void print_summary(const MultiSymbolResult &r,
+                            const std::vector<std::string> &symbols,
+                            std::ostream &out = std::cout) {
+    out << "\n------------------------------------------\n";
+    out << std::left << std::setw(14) << "Symbol" << std::right
+        << std::setw(10) << "Bars" << std::setw(9) << "Trades"
+        << std::setw(10) << "Return%" << std::setw(8) << "PF" << "\n";
+    out << "------------------------------------------\n";
+    for (size_t i = 0; i < r.per_symbol.size(); ++i) {
+      const auto &s = r.per_symbol[i];
+      out << std::left << std::setw(14) << symbols[i] << std::right
+          << std::setw(10) << s.bars_processed << std::setw(9)
+          << s.report.total_trades << std::setw(10) << std::fixed
+          << std::setprecision(2) << s.report.total_return_pct
+          << std::setw(8) << s.report.profit_factor << "\n";
+    }
+    out << "\n[BENCHMARK] Processed " << r.total_bars << " bars across "
+        << r.per_symbol.size() << " symbols on " << r.threads
+        << " threads in " << std::setprecision(3) << r.wall_ms << " ms ("
+        << std::setprecision(0) << r.bars_per_sec << " bars/sec)\n";
+    print_report(r.aggregate, out);
+    if (r.portfolio.reconciles > 0)
+      print_portfolio(r.portfolio, out);
+    print_regime_stats(r.regimes, out);
+  }
+
+  static void print_portfolio(const PortfolioSummary &p,
+                              std::ostream &out = std::cout) {
+    out << "\n[PORTFOLIO] Capital " << std::fixed << std::setprecision(2)
+        << p.initial_capital << " -> equity " << p.final_equity << " (cash "
+        << p.final_cash << ")\n"
+        << "[PORTFOLIO] Peak " << p.peak_equity << ", max drawdown "
+        << p.max_drawdown_pct << "%, max gross exposure "
+        << p.max_gross_exposure * 100.0 << "%\n"
+        << "[PORTFOLIO] " << p.reconciles << " reconciles"
+        << (p.halted ? ", halted by drawdown limit" : "") << "\n";
+  }
+
+  static void print_scaling(const std::vector<ScalingPoint> &points,
+                            std::ostream &out = std::cout) {
+    out << "\n[SCALING] threads   wall_ms      bars/sec  speedup  eff\n";
+    for (const auto &p : points) {
+      out << "[SCALING] " << std::setw(7) << p.threads << std::fixed
+          << std::setw(10) << std::setprecision(1) << p.wall_ms
+          << std::setw(14) << std::setprecision(0) << p.bars_per_sec
+          << std::setw(9) << std::setprecision(2) << p.speedup
+          << std::setw(5) << std::setprecision(2) << p.efficiency << "\n";
+    }
+  }
+
+private:
+  // One batched group: symbols [first, last) in lockstep over time.
+  void run_group(size_t first, size_t last,
+                 std::vector<BacktestResult> &results) {
+    const size_t lanes = last - first;
+    BatchIndicatorRegistry registry(lanes);
+
+    std::vector<std::span<const Bar>> bars(lanes);
+    std::vector<const SessionIndex *> sessions(lanes);
+    std::vector<Engine> engines;
+    std::vector<std::unique_ptr<LaneStrategyStack<>>> stacks;
+    engines.reserve(lanes);
+    stacks.reserve(lanes);
+    for (size_t l = 0; l < lanes; ++l) {
+      bars[l] = market_data_->get_bars(ids_[first + l]);
+      sessions[l] = &market_data_->get_sessions(ids_[first + l]);
+      engines.emplace_back(market_data_);
+      engines[l].start_run();
+      // All lanes register before the first update
+      stacks.push_back(std::make_unique<LaneStrategyStack<>>(
+          registry, l, engines[l].strategy_params(),
+          engines[l].regime_allocation()));
+      engines[l].bind_sizing(*stacks[l]);
+    }
+
+    std::vector<size_t> cursor(lanes, 0);
+    std::vector<double> high(lanes), low(lanes), close(lanes), volume(lanes);
+    std::vector<uint8_t> present(lanes);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    for (;;) {
+      // Next timestamp across the group (k-way merge of sorted series)
+      int64_t ts = std::numeric_limits<int64_t>::max();
+      for (size_t l = 0; l < lanes; ++l) {
+        if (cursor[l] < bars[l].size())
+          ts = std::min<int64_t>(ts, bars[l][cursor[l]].timestamp);
+      }
+      if (ts == std::numeric_limits<int64_t>::max())
+        break;
+
+      for (size_t l = 0; l < lanes; ++l) {
+        present[l] = cursor[l] < bars[l].size() &&
+                     bars[l][cursor[l]].timestamp == ts;
+        const Bar *bar = present[l] ? &bars[l][cursor[l]] : nullptr;
+        high[l] = bar ? bar->high : BATCH_MISSING;
+        low[l] = bar ? bar->low : BATCH_MISSING;
+        close[l] = bar ? bar->close : BATCH_MISSING;
+        volume[l] = bar ? bar->volume : BATCH_MISSING;
+      }
+
+      registry.update(high.data(), low.data(), close.data(), volume.data());
+
+      for (size_t l = 0; l < lanes; ++l) {
+        if (!present[l])
+          continue;
+        engines[l].step(bars[l][cursor[l]], (*sessions[l])[cursor[l]],
+                        *stacks[l], results[first + l]);
+        ++cursor[l];
+      }
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    double elapsed_ms =
+        std::chrono::duration_cast<std::chrono::microseconds>(end_time -
+                                                              start_time)
+            .count() /
+        1000.0;
+
+    for (size_t l = 0; l < lanes; ++l) {
+      BacktestResult &r = results[first + l];
+      r.symbol = symbols_[first + l];
+      if (bars[l].empty())
+        continue;
+      r.elapsed_ms = elapsed_ms;
+      engines[l].finish_run(r, bars[l].back().close);
+    }
+  }
+
+  // Merge per-symbol trade logs and reports into the aggregate view.
+  static void merge(MultiSymbolResult &r) {
+    size_t total_trades = 0;
+    for (const auto &s : r.per_symbol)
+      total_trades += s.trades.size();
+    r.trades.reserve(total_trades);
+
+    for (size_t i = 0; i < r.per_symbol.size(); ++i) {
+      const auto &s = r.per_symbol[i];
+      r.total_bars += s.bars_processed;
+      r.regimes.merge(s.regimes);
+      if (s.bars_processed == 0)
+        continue; // Symbol had no data; contributes no capital
+      r.aggregate.initial_capital += s.report.initial_capital;
+      r.aggregate.final_equity += s.report.final_equity;
+      for (const auto &t : s.trades) {
+        r.trades.push_back({static_cast<uint32_t>(i), t});
+        r.aggregate.add_trade(t);
+      }
+    }
+    r.aggregate.finalize();
+
+    std::stable_sort(r.trades.begin(), r.trades.end(),
+                     [](const SymbolTrade &a, const SymbolTrade &b) {
+                       return a.trade.exit_time < b.trade.exit_time;
+                     });
+
+    r.bars_per_sec = r.wall_ms > 0 ? r.total_bars / r.wall_ms * 1000.0 : 0.0;
+  }
+
+  std::shared_ptr<MarketDataManager> market_data_;
+  std::vector<std::string> symbols_;
+  std::vector<SymbolId> ids_; // Parallel to symbols_
+};
+
+} // namespace quant
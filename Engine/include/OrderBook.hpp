@@ -0,0 +1,343 @@
+#pragma once
+
+#include "Bar.hpp"
+#include "BarSeries.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace quant {
+
+enum class OrderType : uint8_t { Market, Limit, Stop };
+
+// How an order that can trade on a bar is priced.
+enum class FillPolicy : uint8_t {
+  Open,  // At the open; limit / stop orders only if the open satisfies them
+  Vwap,  // At the typical price (H+L+C)/3, clamped to the order's level
+         // (limits fill no worse, stops no better)
+  Touch, // Limit / stop at their level once the range touches it (at the
+         // open when the bar gaps through); market orders at the open
+};
+
+// Adverse price adjustment for market and stop fills (limit fills trade at
+// their level or better and are not slipped).
+struct SlippageModel {
+  double bps = 0.0;       // Basis points of the fill price
+  double per_share = 0.0; // Absolute, in price units
+
+  double apply(int side, double price) const {
+    return side == 1 ? price * (1.0 + bps * 1e-4) + per_share
+                     : price * (1.0 - bps * 1e-4) - per_share;
+  }
+};
+
+struct FeeModel {
+  double rate = 0.0;     // Fraction of notional, e.g. 0.0005 = 5 bps
+  double per_fill = 0.0; // Fixed, per (partial) fill
+
+  double operator()(double notional) const {
+    return notional * rate + per_fill;
+  }
+};
+
+/**
+ * @brief Fill simulation settings for ExecutionEngine. The defaults (open
+ * fills, no slippage, no fees, unlimited volume) reproduce the original
+ * next-bar-open market fills exactly.
+ */
+struct FillConfig {
+  FillPolicy policy = FillPolicy::Open;
+  SlippageModel slippage;
+  FeeModel fees;
+  // Max fraction of a bar's volume this book may trade per bar; the rest of
+  // an order stays working (partial fills). 0 = unlimited.
+  double max_participation = 0.0;
+};
+
+// A working order as reported by OrderBook::orders().
+struct Order {
+  int id;
+  int64_t timestamp; // Submission time
+  int side;          // 1=Buy, -1=Sell
+  double quantity;   // Remaining
+  double price;      // Limit / stop level; NaN for Market
+  OrderType type;
+};
+
+struct Fill {
+  int order_id;
+  int64_t timestamp;
+  int side;
+  double quantity;
+  double price; // Slippage included
+  OrderType type;
+  bool complete; // Order fully filled and removed from the book
+};
+
+/**
+ * @brief Working orders for one symbol, matched against each bar.
+ *
+ * Orders are split by what makes them tradeable: market orders; "below"
+ * orders (buy limits, sell stops) that trigger when the low reaches their
+ * level; and "above" orders (sell limits, buy stops) that trigger when the
+ * high does. Each lane is a set of flat parallel columns sorted by trigger
+ * key - level for above, -level for below - descending, so the orders the
+ * price reaches first sit at the back. match() walks a lane from the back
+ * and stops at the first order out of range: a bar costs O(1 + orders
+ * touched) however many orders rest away from the market, and filled orders
+ * are popped off the end. Equal levels keep time priority.
+ *
+ * Within a bar, market orders trade first, then below, then above (OHLC
+ * bars do not say whether the low or the high came first).
+ */
+class OrderBook {
+public:
+  explicit OrderBook(size_t reserve_per_lane = 16) {
+    for (Lane &lane : lanes_)
+      lane.reserve(reserve_per_lane);
+    lanes_[BELOW].sign = -1.0;
+  }
+
+  // Returns the order id (> 0), or 0 if quantity <= 0. `price` is ignored
+  // for market orders.
+  int submit(OrderType type, int side, double quantity, double price,
+             int64_t timestamp) {
+    if (!(quantity > 0.0))
+      return 0;
+    const int id = next_id_++;
+    Lane &lane = lanes_[lane_of(type, side)];
+    const double key = type == OrderType::Market
+                           ? -std::numeric_limits<double>::infinity()
+                           : lane.sign * price;
+    lane.insert(key, quantity, id, timestamp, static_cast<int8_t>(side),
+                type);
+    return id;
+  }
+
+  bool cancel(int id) {
+    for (Lane &lane : lanes_) {
+      auto it = std::find(lane.id.begin(), lane.id.end(), id);
+      if (it != lane.id.end()) {
+        lane.erase(static_cast<size_t>(it - lane.id.begin()));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void clear() {
+    for (Lane &lane : lanes_)
+      lane.clear();
+  }
+
+  size_t size() const {
+    return lanes_[MARKET].size() + lanes_[BELOW].size() + lanes_[ABOVE].size();
+  }
+  bool empty() const { return size() == 0; }
+
+  // Remaining quantity over every working order, either side.
+  double quantity() const {
+    double total = 0.0;
+    for (const Lane &lane : lanes_)
+      for (double q : lane.qty)
+        total += q;
+    return total;
+  }
+
+  // Working orders, market first then by trigger priority (allocates).
+  std::vector<Order> orders() const {
+    std::vector<Order> out;
+    out.reserve(size());
+    for (const Lane &lane : lanes_)
+      for (size_t i = lane.size(); i-- > 0;)
+        out.push_back({lane.id[i], lane.timestamp[i], lane.side[i],
+                       lane.qty[i], lane.level(i), lane.type[i]});
+    return out;
+  }
+
+  /**
+   * @brief Trade every order `bar` reaches; on_fill(const Fill &) is called
+   * once per (partial) fill in priority order and must not modify the book.
+   */
+  template <typename OnFill>
+  void match(const Bar &bar, const FillConfig &config, OnFill &&on_fill) {
+    double budget = config.max_participation > 0.0
+                        ? bar.volume * config.max_participation
+                        : std::numeric_limits<double>::infinity();
+    const double mid = (bar.high + bar.low + bar.close) / 3.0;
+
+    // Market orders: always in range
+    Lane &market = lanes_[MARKET];
+    if (!market.empty()) {
+      const double px = config.policy == FillPolicy::Vwap ? mid : bar.open;
+      match_lane(market, std::numeric_limits<double>::infinity(), bar, config,
+                 budget, [px](double) { return px; }, on_fill);
+    }
+
+    // Below: level >= low, i.e. key = -level <= -low
+    Lane &below = lanes_[BELOW];
+    if (!below.empty() && below.key.back() <= -bar.low) {
+      match_lane(below, -bar.low, bar, config, budget,
+                 [&](double level) {
+                   switch (config.policy) {
+                   case FillPolicy::Open:
+                     return bar.open <= level ? bar.open : NO_FILL;
+                   case FillPolicy::Vwap:
+                     return std::min(mid, level);
+                   case FillPolicy::Touch:
+                     break;
+                   }
+                   return std::min(bar.open, level);
+                 },
+                 on_fill);
+    }
+
+    // Above: level <= high
+    Lane &above = lanes_[ABOVE];
+    if (!above.empty() && above.key.back() <= bar.high) {
+      match_lane(above, bar.high, bar, config, budget,
+                 [&](double level) {
+                   switch (config.policy) {
+                   case FillPolicy::Open:
+                     return bar.open >= level ? bar.open : NO_FILL;
+                   case FillPolicy::Vwap:
+                     return std::max(mid, level);
+                   case FillPolicy::Touch:
+                     break;
+                   }
+                   return std::max(bar.open, level);
+                 },
+                 on_fill);
+    }
+  }
+
+private:
+  static constexpr double NO_FILL = std::numeric_limits<double>::quiet_NaN();
+  enum LaneIndex : size_t { MARKET = 0, BELOW = 1, ABOVE = 2 };
+
+  static size_t lane_of(OrderType type, int side) {
+    if (type == OrderType::Market)
+      return MARKET;
+    const bool buy = side == 1;
+    return (type == OrderType::Limit) == buy ? BELOW : ABOVE;
+  }
+
+  // Columns sorted by key descending; back() is the next order reached.
+  struct Lane {
+    double sign = 1.0; // level = sign * key
+    AlignedVector<double> key;
+    AlignedVector<double> qty;
+    std::vector<int> id;
+    std::vector<int64_t> timestamp;
+    std::vector<int8_t> side;
+    std::vector<OrderType> type;
+
+    size_t size() const { return key.size(); }
+    bool empty() const { return key.empty(); }
+
+    double level(size_t i) const {
+      return type[i] == OrderType::Market
+                 ? std::numeric_limits<double>::quiet_NaN()
+                 : sign * key[i];
+    }
+
+    void reserve(size_t n) {
+      key.reserve(n);
+      qty.reserve(n);
+      id.reserve(n);
+      timestamp.reserve(n);
+      side.reserve(n);
+      type.reserve(n);
+    }
+
+    // Ahead of existing orders at the same key, so older ones keep priority
+    void insert(double k, double q, int order_id, int64_t ts, int8_t s,
+                OrderType t) {
+      const size_t pos = static_cast<size_t>(
+          std::partition_point(key.begin(), key.end(),
+                               [k](double x) { return x > k; }) -
+          key.begin());
+      key.insert(key.begin() + pos, k);
+      qty.insert(qty.begin() + pos, q);
+      id.insert(id.begin() + pos, order_id);
+      timestamp.insert(timestamp.begin() + pos, ts);
+      side.insert(side.begin() + pos, s);
+      type.insert(type.begin() + pos, t);
+    }
+
+    void erase(size_t i) {
+      key.erase(key.begin() + i);
+      qty.erase(qty.begin() + i);
+      id.erase(id.begin() + i);
+      timestamp.erase(timestamp.begin() + i);
+      side.erase(side.begin() + i);
+      type.erase(type.begin() + i);
+    }
+
+    // Keep rows [begin, size()) with qty > 0, in order.
+    void compact_tail(size_t begin) {
+      size_t w = begin;
+      for (size_t r = begin; r < size(); ++r) {
+        if (qty[r] > 0.0) {
+          key[w] = key[r];
+          qty[w] = qty[r];
+          id[w] = id[r];
+          timestamp[w] = timestamp[r];
+          side[w] = side[r];
+          type[w] = type[r];
+          ++w;
+        }
+      }
+      key.resize(w);
+      qty.resize(w);
+      id.resize(w);
+      timestamp.resize(w);
+      side.resize(w);
+      type.resize(w);
+    }
+
+    void clear() {
+      key.clear();
+      qty.clear();
+      id.clear();
+      timestamp.clear();
+      side.clear();
+      type.clear();
+    }
+  };
+
+  // Fill orders from the back while key <= threshold. price_at(level)
+  // returns the unslipped fill price, NaN if the order cannot trade here.
+  template <typename PriceAt, typename OnFill>
+  static void match_lane(Lane &lane, double threshold, const Bar &bar,
+                         const FillConfig &config, double &budget,
+                         PriceAt &&price_at, OnFill &on_fill) {
+    size_t i = lane.size();
+    bool removed = false;
+    while (i > 0 && lane.key[i - 1] <= threshold && budget > 0.0) {
+      --i;
+      double px = price_at(lane.level(i));
+      if (std::isnan(px))
+        continue;
+      if (lane.type[i] != OrderType::Limit)
+        px = config.slippage.apply(lane.side[i], px);
+
+      const double q = std::min(lane.qty[i], budget);
+      budget -= q;
+      const bool complete = q == lane.qty[i];
+      lane.qty[i] = complete ? 0.0 : lane.qty[i] - q;
+      removed |= complete;
+      on_fill(Fill{lane.id[i], bar.timestamp, lane.side[i], q, px,
+                   lane.type[i], complete});
+    }
+    if (removed)
+      lane.compact_tail(i);
+  }
+
+  Lane lanes_[3];
+  int next_id_ = 1;
+};
+
+} // namespace quant
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "Engine.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Parameter Grid (cartesian product of named axes)
+// ---------------------------------------------------------
+struct ParamAxis {
+  std::string name; // StrategyParams field name, e.g. "bb_period"
+  std::vector<double> values;
+};
+
+class ParameterGrid {
+public:
+  ParameterGrid() = default;
+  explicit ParameterGrid(const StrategyParams &base) : base_(base) {}
+
+  // Throws std::invalid_argument for names StrategyParams does not know.
+  ParameterGrid &add(std::string name, std::vector<double> values) {
+    StrategyParams probe;
+    if (!probe.set(name, 0.0))
+      throw std::invalid_argument("Unknown strategy parameter: " + name);
+    if (values.empty())
+      throw std::invalid_argument("Empty axis: " + name);
+    axes_.push_back({std::move(name), std::move(values)});
+    return *this;
+  }
+
+  const std::vector<ParamAxis> &axes() const { return axes_; }
+
+  size_t size() const {
+    size_t n = 1;
+    for (const auto &axis : axes_)
+      n *= axis.values.size();
+    return n;
+  }
+
+  // Decode combination `index` (mixed radix, last axis fastest) without
+  // materializing the whole grid.
+  StrategyParams at(size_t index) const {
+    StrategyParams params = base_;
+    for (size_t a = axes_.size(); a-- > 0;) {
+      const auto &axis = axes_[a];
+      params.set(axis.name, axis.values[index % axis.values.size()]);
+      index /= axis.values.size();
+    }
+    return params;
+  }
+
+private:
+  StrategyParams base_;
+  std::vector<ParamAxis> axes_;
+};
+
+// ---------------------------------------------------------
+// Sweep Results
+// ---------------------------------------------------------
+enum class SweepMetric { TotalReturn, ProfitFactor, WinRate, Sharpe };
+
+struct SweepResult {
+  size_t combo_index;
+  StrategyParams params;
+  PerformanceReport report;
+};
+
+struct SweepReport {
+  std::vector<SweepResult> ranked; // Best first
+  size_t combos = 0;
+  size_t bars = 0; // Evaluated per combo (the window, if set)
+  unsigned threads = 1;
+  double wall_ms = 0.0;
+  double combos_per_sec = 0.0;
+  double bars_per_sec = 0.0; // combos x bars / wall time
+};
+
+inline double metric_value(const PerformanceReport &r, SweepMetric metric) {
+  switch (metric) {
+  case SweepMetric::ProfitFactor:
+    return r.profit_factor;
+  case SweepMetric::WinRate:
+    return r.win_rate_pct;
+  case SweepMetric::Sharpe:
+    return r.sharpe;
+  case SweepMetric::TotalReturn:
+  default:
+    return r.total_return_pct;
+  }
+}
+
+/**
+ * @brief Evaluates every grid combination over one shared, read-only bar
+ * series. Each task builds its own Engine (strategies, risk and execution
+ * state), and writes only its own result slot, so nothing mutable is shared.
+ */
+class ParameterSweep {
+public:
+  explicit ParameterSweep(std::span<const Bar> bars) : bars_(bars) {}
+
+  /**
+   * @brief Evaluate every combination on bars [begin, end) only, each
+   * warmed lazily on the bars before begin (Engine::run_window) instead of
+   * replayed from bar 0.
+   */
+  void set_window(size_t begin, size_t end, const WarmupConfig &config = {}) {
+    begin_ = std::min(begin, bars_.size());
+    end_ = std::clamp(end, begin_, bars_.size());
+    warmup_ = config;
+    windowed_ = true;
+  }
+
+  SweepReport run(const ParameterGrid &grid,
+                  unsigned num_threads = ThreadPool::default_threads(),
+                  SweepMetric metric = SweepMetric::TotalReturn) const {
+    SweepReport report;
+    report.combos = grid.size();
+    report.bars = windowed_ ? end_ - begin_ : bars_.size();
+    report.threads = std::max(1u, num_threads);
+
+    std::vector<SweepResult> results(report.combos);
+    auto start_time = std::chrono::high_resolution_clock::now();
+    {
+      ThreadPool pool(report.threads);
+      pool.parallel_for(report.combos, [&](size_t i) {
+        Engine engine(nullptr); // Runs on bars_ directly; no data store
+        engine.set_strategy_params(grid.at(i));
+        engine.set_warmup_config(warmup_);
+        BacktestResult r = windowed_ ? engine.run_window(bars_, begin_, end_)
+                                     : engine.run_backtest(bars_);
+        results[i] = {i, engine.strategy_params(), r.report};
+      });
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    report.wall_ms = std::chrono::duration_cast<std::chrono::microseconds>(
+                         end_time - start_time)
+                         .count() /
+                     1000.0;
+
+    std::stable_sort(results.begin(), results.end(),
+                     [metric](const SweepResult &a, const SweepResult &b) {
+                       return metric_value(a.report, metric) >
+                              metric_value(b.report, metric);
+                     });
+    report.ranked = std::move(results);
+
+    if (report.wall_ms > 0) {
+      report.combos_per_sec = report.combos / report.wall_ms * 1000.0;
+      report.bars_per_sec = static_cast<double>(report.combos) * report.bars /
+                            report.wall_ms * 1000.0;
+    }
+    return report;
+  }
+
+  static void print(const SweepReport &report, const ParameterGrid &grid,
+                    size_t top_n = 10, std::ostream &out = std::cout) {
+    out << "\n[SWEEP] Rank";
+    for (const auto &axis : grid.axes())
+      out << std::setw(std::max<int>(12, (int)axis.name.size() + 2))
+          << axis.name;
+    out << std::setw(10) << "Return%" << std::setw(8) << "PF"
+        << std::setw(8) << "Trades" << "\n";
+
+    size_t n = std::min(top_n, report.ranked.size());
+    for (size_t i = 0; i < n; ++i) {
+      const auto &r = report.ranked[i];
+      out << "[SWEEP] " << std::setw(4) << (i + 1);
+      for (const auto &axis : grid.axes())
+        out << std::setw(std::max<int>(12, (int)axis.name.size() + 2))
+            << std::defaultfloat << std::setprecision(6)
+            << r.params.get(axis.name);
+      out << std::fixed << std::setprecision(2) << std::setw(10)
+          << r.report.total_return_pct << std::setw(8)
+          << r.report.profit_factor << std::setw(8) << r.report.total_trades
+          << "\n";
+    }
+
+    out << "\n[BENCHMARK] Evaluated " << report.combos << " combos x "
+        << report.bars << " bars on " << report.threads << " threads in "
+        << std::setprecision(1) << report.wall_ms << " ms ("
+        << std::setprecision(2) << report.combos_per_sec << " combos/sec, "
+        << std::setprecision(0) << report.bars_per_sec << " bars/sec)\n";
+  }
+
+private:
+  std::span<const Bar> bars_;
+  bool windowed_ = false;
+  size_t begin_ = 0;
+  size_t end_ = 0;
+  WarmupConfig warmup_;
+};
+
+} // namespace quant
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "ExecutionEngine.hpp"
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Performance Summary (trade-level statistics)
+// ---------------------------------------------------------
+struct PerformanceReport {
+  double initial_capital = 0.0;
+  double final_equity = 0.0;
+  double total_return_pct = 0.0;
+  int total_trades = 0;
+  int winning_trades = 0;
+  double win_rate_pct = 0.0;
+  double profit_factor = 0.0;
+  double gross_profit = 0.0;
+  double gross_loss = 0.0; // Positive magnitude
+
+  // Equity-curve statistics (EquityTracker); NaN when not tracked, e.g. in
+  // an aggregate merged from several symbols' trade logs.
+  double max_drawdown_pct = std::numeric_limits<double>::quiet_NaN();
+  double sharpe = std::numeric_limits<double>::quiet_NaN();  // Annualized
+  double sortino = std::numeric_limits<double>::quiet_NaN(); // Annualized
+  bool halted = false; // max_drawdown_limit breached; trading stopped
+
+  // Accumulate one closed trade (used for both per-symbol and merged logs)
+  void add_trade(const Trade &t) {
+    total_trades++;
+    if (t.pnl > 0) {
+      winning_trades++;
+      gross_profit += t.pnl;
+    } else {
+      gross_loss += std::abs(t.pnl);
+    }
+  }
+
+  // Derive ratio fields from the accumulated totals
+  void finalize() {
+    total_return_pct = initial_capital > 0
+                           ? (final_equity - initial_capital) /
+                                 initial_capital * 100.0
+                           : 0.0;
+    win_rate_pct = total_trades > 0
+                       ? (double)winning_trades / total_trades * 100.0
+                       : 0.0;
+    profit_factor = gross_loss > 0 ? gross_profit / gross_loss : 99.9;
+  }
+};
+
+inline PerformanceReport summarize_trades(const std::vector<Trade> &trades,
+                                          double initial_capital,
+                                          double final_equity) {
+  PerformanceReport report;
+  report.initial_capital = initial_capital;
+  report.final_equity = final_equity;
+  for (const auto &t : trades)
+    report.add_trade(t);
+  report.finalize();
+  return report;
+}
+
+inline void print_report(const PerformanceReport &r,
+                         std::ostream &out = std::cout) {
+  out << "\n==========================================\n";
+  out << "          PERFORMANCE REPORT              \n";
+  out << "==========================================\n";
+  out << "Final Equity:   " << std::fixed << std::setprecision(2)
+      << r.final_equity << "\n";
+  out << "Total Return:   " << r.total_return_pct << "%\n";
+  out << "------------------------------------------\n";
+  out << "Total Trades:   " << r.total_trades << "\n";
+  out << "Win Rate:       " << r.win_rate_pct << "%\n";
+  out << "Profit Factor:  " << r.profit_factor << "\n";
+  out << "Gross Profit:   " << r.gross_profit << "\n";
+  out << "Gross Loss:     " << -r.gross_loss << "\n";
+  if (!std::isnan(r.max_drawdown_pct)) {
+    out << "------------------------------------------\n";
+    out << "Max Drawdown:   " << r.max_drawdown_pct << "%\n";
+    out << "Sharpe:         " << r.sharpe << "\n";
+    out << "Sortino:        " << r.sortino << "\n";
+    if (r.halted)
+      out << "Trading halted: drawdown limit breached\n";
+  }
+  out << "==========================================\n";
+}
+
+} // namespace quant
@@ -0,0 +1,309 @@
+#pragma once
+
+#include "Bar.hpp"
+#include "BatchIndicators.hpp"
+#include "IndicatorRegistry.hpp"
+#include "Regime.hpp"
+#include "StageTimer.hpp"
+#include "Strategies.hpp"
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <utility>
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Compile-time strategy composition
+// ---------------------------------------------------------
+// Anything with on_bar(const Bar&) and signal() qualifies; no base class or
+// virtual functions required.
+template <typename S>
+concept BarStrategy = requires(S s, const S cs, const Bar &bar) {
+  s.on_bar(bar);
+  { cs.signal() } -> std::convertible_to<int>;
+};
+
+/**
+ * @brief Fixed set of strategies held by value in a std::tuple.
+ * on_bar() expands to one direct call per strategy (a fold expression), so
+ * the whole per-bar pipeline is visible to the optimizer and inlines.
+ */
+template <BarStrategy... Strategies> class StrategyPipeline {
+public:
+  // Registry: IndicatorRegistry, or a BatchRegistryLane for lane stacks.
+  template <typename Registry>
+  StrategyPipeline(Registry &registry, const StrategyParams &params)
+      : strategies_(Strategies(registry, params)...) {}
+
+  void on_bar(const Bar &bar) {
+    if constexpr (STAGE_TIMING) {
+      on_bar_timed(bar, std::index_sequence_for<Strategies...>{});
+    } else {
+      std::apply([&bar](auto &...s) { (s.on_bar(bar), ...); }, strategies_);
+    }
+  }
+
+  // After copying the pipeline together with its registry: re-point every
+  // strategy that has rebind(Registry&) at `registry`.
+  template <typename Registry> void rebind(Registry &registry) {
+    std::apply(
+        [&registry](auto &...s) {
+          (
+              [&] {
+                if constexpr (requires { s.rebind(registry); })
+                  s.rebind(registry);
+              }(),
+              ...);
+        },
+        strategies_);
+  }
+
+  // Largest warmup_bars() of the strategies; UNBOUNDED_LOOKBACK if one
+  // does not provide it.
+  size_t warmup_bars() const {
+    return std::apply(
+        [](const auto &...s) {
+          size_t bars = 0;
+          (
+              [&] {
+                if constexpr (requires { s.warmup_bars(); })
+                  bars = std::max<size_t>(bars, s.warmup_bars());
+                else
+                  bars = UNBOUNDED_LOOKBACK;
+              }(),
+              ...);
+          return bars;
+        },
+        strategies_);
+  }
+
+  template <size_t I> auto &get() { return std::get<I>(strategies_); }
+  template <size_t I> const auto &get() const {
+    return std::get<I>(strategies_);
+  }
+
+  static constexpr size_t size() { return sizeof...(Strategies); }
+
+private:
+  template <size_t... I>
+  void on_bar_timed(const Bar &bar, std::index_sequence<I...>) {
+    (
+        [&] {
+          StageScope scope(strategy_stage(I));
+          std::get<I>(strategies_).on_bar(bar);
+        }(),
+        ...);
+  }
+
+  std::tuple<Strategies...> strategies_;
+};
+
+// ---------------------------------------------------------
+// Strategy stacks consumed by Engine's event loop
+// ---------------------------------------------------------
+// A stack owns the indicator registry plus a regime detector and one
+// strategy per allocation slot (trend, range); a RegimeAllocation table
+// picks the slot that trades in each regime. Engine::run_loop is a
+// template over the stack type, so each stack gets its own loop instance.
+//
+// Every stack also registers ATR(params.stop_atr_period) for the
+// RiskManager stop. It is one more slot of the same registry update that
+// already reads the bar's high / low / close, warms and snapshots with the
+// rest of the stack, and stop_atr() reads it back.
+
+// Value of a registry's ATR, NaN until it has a full period.
+template <typename Registry>
+double ready_atr(const Registry &registry, IndicatorHandle<ATR> handle) {
+  const auto &atr = registry.get(handle);
+  return atr.is_ready() ? atr.value()
+                        : std::numeric_limits<double>::quiet_NaN();
+}
+
+/**
+ * @brief Fully static stack: concrete (final) strategy types, no virtual
+ * calls on the hot path.
+ */
+template <typename RegimeT = RegimeStrategy, typename TrendT = MomentumStrategy,
+          typename RangeT = MeanReversionStrategy>
+class StaticStrategyStack {
+public:
+  explicit StaticStrategyStack(
+      const StrategyParams &params,
+      const RegimeAllocation &allocation = RegimeAllocation::legacy())
+      : pipeline_(registry_, params), allocation_(allocation),
+        stop_atr_(registry_.atr(params.stop_atr_period)) {}
+
+  // A copy is a snapshot: every indicator window / accumulator and strategy
+  // state is duplicated and the copy's strategies read the copy's registry.
+  // Assigning a snapshot back restores it. (Not movable: strategies hold a
+  // pointer into the stack.)
+  StaticStrategyStack(const StaticStrategyStack &other)
+      : registry_(other.registry_), pipeline_(other.pipeline_),
+        allocation_(other.allocation_), stop_atr_(other.stop_atr_) {
+    pipeline_.rebind(registry_);
+  }
+  StaticStrategyStack &operator=(const StaticStrategyStack &other) {
+    if (this != &other) {
+      registry_ = other.registry_;
+      pipeline_ = other.pipeline_;
+      allocation_ = other.allocation_;
+      stop_atr_ = other.stop_atr_;
+      pipeline_.rebind(registry_);
+    }
+    return *this;
+  }
+
+  void on_bar(const Bar &bar) {
+    {
+      QUANT_STAGE_SCOPE(Stage::Indicators);
+      registry_.update(bar);
+    }
+    pipeline_.on_bar(bar);
+  }
+
+  Regime regime() const { return pipeline_.template get<0>().regime(); }
+
+  int signal() const {
+    return allocation_.signal(regime(), pipeline_.template get<1>().signal(),
+                              pipeline_.template get<2>().signal());
+  }
+
+  IndicatorRegistry &registry() { return registry_; }
+  double stop_atr() const { return ready_atr(registry_, stop_atr_); }
+
+  // Lazy warm-up (Warmup.hpp): history the registry needs, bars the
+  // strategies need replayed after it, and the bulk registry seed.
+  size_t lookback(double tolerance) const {
+    return registry_.lookback(tolerance);
+  }
+  size_t warmup_bars() const { return pipeline_.warmup_bars(); }
+  void seed(std::span<const Bar> history) { registry_.seed(history); }
+
+private:
+  IndicatorRegistry registry_;
+  StrategyPipeline<RegimeT, TrendT, RangeT> pipeline_;
+  RegimeAllocation allocation_;
+  IndicatorHandle<ATR> stop_atr_;
+};
+
+/**
+ * @brief Static stack bound to one lane of a shared BatchIndicatorRegistry
+ * (cross-symbol batching). The registry is advanced once per timestamp for
+ * all lanes by the driver (MultiSymbolRunner::run_batched), so on_bar()
+ * only runs the strategies. Signals match StaticStrategyStack bit for bit.
+ */
+template <typename RegimeT = BasicRegimeStrategy<BatchRegistryLane>,
+          typename TrendT = BasicMomentumStrategy<BatchRegistryLane>,
+          typename RangeT = BasicMeanReversionStrategy<BatchRegistryLane>>
+class LaneStrategyStack {
+public:
+  LaneStrategyStack(BatchIndicatorRegistry &registry, size_t lane,
+                    const StrategyParams &params,
+                    const RegimeAllocation &allocation =
+                        RegimeAllocation::legacy())
+      : lane_(registry, lane), pipeline_(lane_, params),
+        allocation_(allocation),
+        stop_atr_(lane_.atr(params.stop_atr_period)) {}
+
+  // Strategies hold a pointer to lane_; keep the stack in place.
+  LaneStrategyStack(const LaneStrategyStack &) = delete;
+  LaneStrategyStack &operator=(const LaneStrategyStack &) = delete;
+
+  void on_bar(const Bar &bar) { pipeline_.on_bar(bar); }
+
+  Regime regime() const { return pipeline_.template get<0>().regime(); }
+
+  int signal() const {
+    return allocation_.signal(regime(), pipeline_.template get<1>().signal(),
+                              pipeline_.template get<2>().signal());
+  }
+
+  BatchRegistryLane &registry() { return lane_; }
+  double stop_atr() const { return ready_atr(lane_, stop_atr_); }
+
+private:
+  BatchRegistryLane lane_;
+  StrategyPipeline<RegimeT, TrendT, RangeT> pipeline_;
+  RegimeAllocation allocation_;
+  IndicatorHandle<ATR> stop_atr_;
+};
+
+// Factory used to plug a runtime-chosen Strategy into an allocation slot.
+using StrategyFactory = std::function<std::unique_ptr<Strategy>(
+    IndicatorRegistry &, const StrategyParams &)>;
+
+/**
+ * @brief Runtime-composed stack for plugins: trend/range slots are any
+ * Strategy implementation, called through the virtual interface.
+ */
+class DynamicStrategyStack {
+public:
+  DynamicStrategyStack(
+      const StrategyParams &params, const StrategyFactory &trend_factory,
+      const StrategyFactory &range_factory,
+      const RegimeAllocation &allocation = RegimeAllocation::legacy())
+      : regime_(std::make_unique<RegimeStrategy>(registry_, params)),
+        trend_(trend_factory
+                   ? trend_factory(registry_, params)
+                   : std::make_unique<MomentumStrategy>(registry_, params)),
+        range_(range_factory ? range_factory(registry_, params)
+                             : std::make_unique<MeanReversionStrategy>(
+                                   registry_, params)),
+        allocation_(allocation),
+        stop_atr_(registry_.atr(params.stop_atr_period)) {}
+
+  DynamicStrategyStack(const DynamicStrategyStack &) = delete;
+  DynamicStrategyStack &operator=(const DynamicStrategyStack &) = delete;
+
+  void on_bar(const Bar &bar) {
+    {
+      QUANT_STAGE_SCOPE(Stage::Indicators);
+      registry_.update(bar);
+    }
+    // Called through Strategy& so plugins and built-ins take the same path
+    {
+      QUANT_STAGE_SCOPE(Stage::Regime);
+      static_cast<Strategy &>(*regime_).on_bar(bar);
+    }
+    {
+      QUANT_STAGE_SCOPE(Stage::Trend);
+      trend_->on_bar(bar);
+    }
+    QUANT_STAGE_SCOPE(Stage::Range);
+    range_->on_bar(bar);
+  }
+
+  Regime regime() const { return regime_->regime(); }
+
+  int signal() const {
+    return allocation_.signal(regime(), trend_->signal(), range_->signal());
+  }
+
+  IndicatorRegistry &registry() { return registry_; }
+  double stop_atr() const { return ready_atr(registry_, stop_atr_); }
+
+  size_t lookback(double tolerance) const {
+    return registry_.lookback(tolerance);
+  }
+  size_t warmup_bars() const {
+    return std::max({regime_->warmup_bars(), trend_->warmup_bars(),
+                     range_->warmup_bars()});
+  }
+  void seed(std::span<const Bar> history) { registry_.seed(history); }
+
+private:
+  IndicatorRegistry registry_;
+  std::unique_ptr<RegimeStrategy> regime_;
+  std::unique_ptr<Strategy> trend_;
+  std::unique_ptr<Strategy> range_;
+  RegimeAllocation allocation_;
+  IndicatorHandle<ATR> stop_atr_;
+};
+
+} // namespace quant
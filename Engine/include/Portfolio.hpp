@@ -0,0 +1,173 @@
+#pragma once
+
+#include "PositionSizing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Shared Portfolio
+// ---------------------------------------------------------
+// Cash and positions stay in each symbol's Engine (its ExecutionEngine is
+// the symbol's sleeve of the portfolio's cash); the portfolio holds one slot
+// per symbol and reconciles them once per epoch (MultiSymbolRunner::
+// run_portfolio):
+//
+//   during an epoch   each worker steps its own symbols, which size entries
+//                     from their slot's PortfolioBudget, then reports their
+//                     PositionState into the same slot. One writer per slot,
+//                     slots a cache line apart: no locks, no shared writes.
+//   between epochs    reconcile() (one thread, at the barrier) sums cash,
+//                     exposure and equity, applies the limits and writes the
+//                     next epoch's budgets.
+//
+// Budgets only depend on the reconciled state, so results do not depend on
+// the thread count or on which worker reports first. Headroom under the
+// gross / net limits is split evenly over the symbols that are flat, so
+// entries taken in the same epoch can never overshoot it together.
+
+struct PortfolioConfig {
+  double capital = 1000000.0;
+  double max_gross_exposure = 1.0;   // Sum |notional| / equity
+  double max_net_exposure = 1.0;     // |long - short| / equity
+  double max_symbol_exposure = 0.25; // One position's notional / equity
+  double max_drawdown = 0.0;         // From peak; halts entries. 0 = off
+  // Epoch length: bars with timestamps in [t, t + reconcile_seconds) run
+  // between two reconciles. 0 = reconcile after every timestamp.
+  int64_t reconcile_seconds = 0;
+  SizingConfig sizing; // Per-symbol sizing against portfolio equity
+};
+
+struct PortfolioSummary {
+  double initial_capital = 0.0;
+  double final_equity = 0.0;
+  double final_cash = 0.0;
+  double peak_equity = 0.0;
+  double max_drawdown_pct = 0.0;
+  double max_gross_exposure = 0.0; // Largest reconciled gross / equity
+  size_t reconciles = 0;
+  bool halted = false;
+};
+
+class Portfolio {
+public:
+  Portfolio(const PortfolioConfig &config, size_t symbols)
+      : config_(config), slots_(symbols) {
+    const double sleeve = symbols > 0 ? config.capital / symbols : 0.0;
+    for (Slot &slot : slots_)
+      slot.state.cash = sleeve;
+    peak_ = config.capital;
+    reconcile();
+    reconciles_ = 0;
+  }
+
+  // Not copyable: engines hold pointers to the budgets.
+  Portfolio(const Portfolio &) = delete;
+  Portfolio &operator=(const Portfolio &) = delete;
+
+  const PortfolioConfig &config() const { return config_; }
+  size_t size() const { return slots_.size(); }
+
+  // Each symbol's starting cash (config.capital split evenly).
+  double sleeve_capital() const {
+    return slots_.empty() ? 0.0 : config_.capital / slots_.size();
+  }
+
+  // Worker side: only the worker that owns symbol i touches slot i.
+  const PortfolioBudget &budget(size_t i) const { return slots_[i].budget; }
+  void report(size_t i, const PositionState &state) {
+    slots_[i].state = state;
+  }
+
+  /**
+   * @brief Fold every slot's last report into cash / exposure / equity,
+   * update the drawdown halt and write the next epoch's budgets. O(symbols);
+   * call with no worker inside an epoch.
+   */
+  void reconcile() {
+    double cash = 0.0, net = 0.0, gross = 0.0;
+    size_t flat = 0;
+    for (const Slot &slot : slots_) {
+      const PositionState &s = slot.state;
+      const double notional = s.quantity * s.price;
+      cash += s.cash;
+      net += notional;
+      gross += std::abs(notional) + s.pending;
+      flat += s.quantity == 0 && s.pending == 0;
+    }
+    cash_ = cash;
+    net_ = net;
+    gross_ = gross;
+    equity_ = cash + net;
+    peak_ = std::max(peak_, equity_);
+    const double drawdown = peak_ > 0 ? 1.0 - equity_ / peak_ : 0.0;
+    max_drawdown_ = std::max(max_drawdown_, drawdown);
+    if (config_.max_drawdown > 0 && drawdown >= config_.max_drawdown)
+      halted_ = true;
+    if (equity_ > 0)
+      max_gross_ratio_ = std::max(max_gross_ratio_, gross_ / equity_);
+    ++reconciles_;
+
+    const double equity = std::max(0.0, equity_);
+    const double share = flat > 0 ? 1.0 / flat : 0.0;
+    const double gross_room =
+        std::max(0.0, config_.max_gross_exposure * equity - gross) * share;
+    const double net_limit = config_.max_net_exposure * equity;
+    const double symbol_cap = config_.max_symbol_exposure * equity;
+    PortfolioBudget budget;
+    budget.capital = equity;
+    budget.max_long = std::min(
+        {symbol_cap, gross_room, std::max(0.0, net_limit - net) * share});
+    budget.max_short = std::min(
+        {symbol_cap, gross_room, std::max(0.0, net_limit + net) * share});
+    budget.halted = halted_;
+    for (Slot &slot : slots_)
+      slot.budget = budget;
+  }
+
+  // As of the last reconcile()
+  double cash() const { return cash_; }
+  double equity() const { return equity_; }
+  double gross_exposure() const { return gross_; }
+  double net_exposure() const { return net_; }
+  bool halted() const { return halted_; }
+  const PositionState &position(size_t i) const { return slots_[i].state; }
+
+  PortfolioSummary summary() const {
+    PortfolioSummary s;
+    s.initial_capital = config_.capital;
+    s.final_equity = equity_;
+    s.final_cash = cash_;
+    s.peak_equity = peak_;
+    s.max_drawdown_pct = max_drawdown_ * 100.0;
+    s.max_gross_exposure = max_gross_ratio_;
+    s.reconciles = reconciles_;
+    s.halted = halted_;
+    return s;
+  }
+
+private:
+  // One cache line per symbol so workers never write the same line
+  struct alignas(64) Slot {
+    PositionState state;
+    PortfolioBudget budget;
+  };
+
+  PortfolioConfig config_;
+  std::vector<Slot> slots_;
+  double cash_ = 0.0;
+  double equity_ = 0.0;
+  double gross_ = 0.0;
+  double net_ = 0.0;
+  double peak_ = 0.0;
+  double max_drawdown_ = 0.0;
+  double max_gross_ratio_ = 0.0;
+  size_t reconciles_ = 0;
+  bool halted_ = false;
+};
+
+} // namespace quant
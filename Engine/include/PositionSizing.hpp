@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Bar.hpp"
+#include "IndicatorRegistry.hpp"
+#include "Indicators.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Position Sizing
+// ---------------------------------------------------------
+// Notional of a new entry, before the regime's size_scale:
+//
+//   FixedFraction     capital * fraction (the legacy 20% of capital)
+//   VolatilityTarget  capital * target_vol / sd(log returns, vol_period):
+//                     every position carries the same per-bar volatility
+//   AtrRisk           capital * risk_per_atr * close / ATR(atr_period):
+//                     one ATR against the position costs risk_per_atr of
+//                     capital (risk parity on ATR)
+//
+// The volatility modes give no size until their indicator is ready and are
+// capped at max_fraction of capital.
+enum class SizingMode : uint8_t { FixedFraction, VolatilityTarget, AtrRisk };
+
+struct SizingConfig {
+  SizingMode mode = SizingMode::FixedFraction;
+  double fraction = 0.20;
+  double target_vol = 0.0002; // ~20% of capital at 0.1% per-bar vol
+  int vol_period = 100;
+  double risk_per_atr = 0.002;
+  int atr_period = 14;
+  double max_fraction = 1.0;
+};
+
+/**
+ * @brief Per-symbol sizer: turns (capital, price, size scale) into an entry
+ * notional. The ATR / RollingStats its mode reads are not its own: bind()
+ * registers them in the strategy stack's indicator registry (an ATR with the
+ * stop's period is the stop's ATR), so they update, warm and snapshot with
+ * the rest of the stack. Nothing to bind for FixedFraction.
+ */
+class PositionSizer {
+public:
+  explicit PositionSizer(const SizingConfig &config = {}) : config_(config) {}
+
+  // Register the mode's indicator in `registry` (IndicatorRegistry or a
+  // BatchRegistryLane); notional() must then be given the same registry.
+  template <typename Registry> void bind(Registry &registry) {
+    switch (config_.mode) {
+    case SizingMode::FixedFraction:
+      break;
+    case SizingMode::VolatilityTarget:
+      vol_ = registry.rolling_stats(IndicatorInput::LogReturn,
+                                    config_.vol_period);
+      break;
+    case SizingMode::AtrRisk:
+      atr_ = registry.atr(config_.atr_period);
+      break;
+    }
+    bound_ = true;
+  }
+
+  // Entry notional at `price` for `capital`; 0 = no entry (also while the
+  // volatility modes are unbound).
+  template <typename Registry>
+  double notional(double capital, double price, double size_scale,
+                  const Registry &registry) const {
+    double fraction = 0.0;
+    switch (config_.mode) {
+    case SizingMode::FixedFraction:
+      return capital * config_.fraction * size_scale;
+    case SizingMode::VolatilityTarget: {
+      if (!bound_)
+        return 0.0;
+      const auto &vol = registry.get(vol_);
+      if (!vol.is_ready() || !(vol.std_dev() > 0))
+        return 0.0;
+      fraction = config_.target_vol / vol.std_dev();
+      break;
+    }
+    case SizingMode::AtrRisk: {
+      if (!bound_)
+        return 0.0;
+      const auto &atr = registry.get(atr_);
+      if (!atr.is_ready() || !(atr.value() > 0))
+        return 0.0;
+      fraction = config_.risk_per_atr * price / atr.value();
+      break;
+    }
+    }
+    return capital * std::min(fraction, config_.max_fraction) * size_scale;
+  }
+
+  const SizingConfig &config() const { return config_; }
+
+private:
+  SizingConfig config_;
+  IndicatorHandle<ATR> atr_;
+  IndicatorHandle<RollingStats> vol_;
+  bool bound_ = false;
+};
+
+// ---------------------------------------------------------
+// Portfolio budget (what one symbol's Engine sees)
+// ---------------------------------------------------------
+// Written by Portfolio::reconcile() between epochs and read by the symbol's
+// Engine during one, so it needs no synchronization of its own.
+struct PortfolioBudget {
+  double capital = 0.0;   // Portfolio equity to size against
+  double max_long = 0.0;  // Largest notional a new long may take
+  double max_short = 0.0; // Same for a new short
+  bool halted = false;    // Portfolio drawdown limit breached: no entries
+
+  double clamp(int side, double notional) const {
+    if (halted)
+      return 0.0;
+    return std::min(notional, side > 0 ? max_long : max_short);
+  }
+};
+
+// A symbol's book as reported to the portfolio at the end of an epoch.
+struct PositionState {
+  double cash = 0.0;
+  double quantity = 0.0; // Signed
+  double price = 0.0;    // Last close
+  double pending = 0.0;  // Notional of working entry orders while flat
+};
+
+} // namespace quant
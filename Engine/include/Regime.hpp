@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Market Regimes (Logic from regimes.py)
+// ---------------------------------------------------------
+// UNDEFINED until the detector's indicators are warm.
+enum class Regime : uint8_t { Undefined, LvTrend, HvTrend, LvRange, HvRange };
+
+constexpr size_t REGIME_COUNT = 5;
+
+constexpr size_t regime_index(Regime r) { return static_cast<size_t>(r); }
+
+// Names match the strings used by the Python research code (reporting only).
+constexpr const char *regime_name(Regime r) {
+  switch (r) {
+  case Regime::LvTrend:
+    return "LV_TREND";
+  case Regime::HvTrend:
+    return "HV_TREND";
+  case Regime::LvRange:
+    return "LV_RANGE";
+  case Regime::HvRange:
+    return "HV_RANGE";
+  case Regime::Undefined:
+  default:
+    return "UNDEFINED";
+  }
+}
+
+// ---------------------------------------------------------
+// Regime -> Strategy Dispatch Table (Logic from allocator.py)
+// ---------------------------------------------------------
+// Which strategy slot trades in each regime. Cash = flat.
+enum class AllocationSlot : uint8_t { Cash, Trend, Range };
+
+struct RegimeRoute {
+  AllocationSlot slot = AllocationSlot::Cash;
+  double size_scale = 1.0; // Multiplier on the base position size
+};
+
+class RegimeAllocation {
+public:
+  // allocate_signal(df, use_enhanced=False): trends -> momentum,
+  // LV_RANGE -> mean reversion, HV_RANGE -> cash.
+  static constexpr RegimeAllocation legacy() {
+    RegimeAllocation a;
+    a.set(Regime::LvTrend, AllocationSlot::Trend);
+    a.set(Regime::HvTrend, AllocationSlot::Trend);
+    a.set(Regime::LvRange, AllocationSlot::Range);
+    return a;
+  }
+
+  // allocate_signal(df, use_enhanced=True): mean reversion everywhere, at
+  // 40% size in trends and 50% in HV_RANGE.
+  static constexpr RegimeAllocation enhanced() {
+    RegimeAllocation a;
+    a.set(Regime::LvTrend, AllocationSlot::Range, 0.4);
+    a.set(Regime::HvTrend, AllocationSlot::Range, 0.4);
+    a.set(Regime::LvRange, AllocationSlot::Range, 1.0);
+    a.set(Regime::HvRange, AllocationSlot::Range, 0.5);
+    return a;
+  }
+
+  constexpr RegimeAllocation &set(Regime r, AllocationSlot slot,
+                                  double size_scale = 1.0) {
+    routes_[regime_index(r)] = {slot, size_scale};
+    return *this;
+  }
+
+  constexpr const RegimeRoute &operator[](Regime r) const {
+    return routes_[regime_index(r)];
+  }
+
+  // Signal of the strategy routed for this regime (0 when in cash).
+  constexpr int signal(Regime r, int trend_signal, int range_signal) const {
+    switch (routes_[regime_index(r)].slot) {
+    case AllocationSlot::Trend:
+      return trend_signal;
+    case AllocationSlot::Range:
+      return range_signal;
+    case AllocationSlot::Cash:
+    default:
+      return 0;
+    }
+  }
+
+private:
+  std::array<RegimeRoute, REGIME_COUNT> routes_{};
+};
+
+// ---------------------------------------------------------
+// Per-Regime Bar Counts / Time-in-Regime
+// ---------------------------------------------------------
+// Fed once per bar by the event loop: a counter increment and one compare.
+struct RegimeStats {
+  std::array<size_t, REGIME_COUNT> bars{};
+  std::array<size_t, REGIME_COUNT> episodes{};    // Entries into the regime
+  std::array<size_t, REGIME_COUNT> longest_run{}; // Bars, longest episode
+  size_t total_bars = 0;
+
+  void record(Regime r) {
+    size_t i = regime_index(r);
+    ++bars[i];
+    ++total_bars;
+    if (total_bars == 1 || r != last_) {
+      ++episodes[i];
+      run_ = 0;
+      last_ = r;
+    }
+    if (++run_ > longest_run[i])
+      longest_run[i] = run_;
+  }
+
+  double share_pct(Regime r) const {
+    return total_bars > 0
+               ? (double)bars[regime_index(r)] / total_bars * 100.0
+               : 0.0;
+  }
+
+  double mean_run(Regime r) const {
+    size_t i = regime_index(r);
+    return episodes[i] > 0 ? (double)bars[i] / episodes[i] : 0.0;
+  }
+
+  // Combine stats from independent runs (e.g. one per symbol). Episodes are
+  // summed; runs are not joined across series.
+  void merge(const RegimeStats &other) {
+    for (size_t i = 0; i < REGIME_COUNT; ++i) {
+      bars[i] += other.bars[i];
+      episodes[i] += other.episodes[i];
+      if (other.longest_run[i] > longest_run[i])
+        longest_run[i] = other.longest_run[i];
+    }
+    total_bars += other.total_bars;
+  }
+
+private:
+  Regime last_ = Regime::Undefined;
+  size_t run_ = 0;
+};
+
+inline void print_regime_stats(const RegimeStats &s,
+                               std::ostream &out = std::cout) {
+  out << "\n[REGIME] " << std::left << std::setw(10) << "Regime" << std::right
+      << std::setw(10) << "Bars" << std::setw(9) << "Time%" << std::setw(10)
+      << "Episodes" << std::setw(10) << "MeanRun" << std::setw(9) << "MaxRun"
+      << "\n";
+  for (size_t i = 0; i < REGIME_COUNT; ++i) {
+    Regime r = static_cast<Regime>(i);
+    out << "[REGIME] " << std::left << std::setw(10) << regime_name(r)
+        << std::right << std::setw(10) << s.bars[i] << std::fixed
+        << std::setprecision(2) << std::setw(9) << s.share_pct(r)
+        << std::setw(10) << s.episodes[i] << std::setprecision(1)
+        << std::setw(10) << s.mean_run(r) << std::setw(9)
+        << s.longest_run[i] << "\n";
+  }
+}
+
+} // namespace quant
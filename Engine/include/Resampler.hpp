@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Bar.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace quant {
+
+/**
+ * @brief Incremental OHLCV resampler: base bars in, higher-timeframe bars
+ * out, in one streaming pass. Holds only the bar being built.
+ *
+ * Buckets are [origin + k * period, origin + (k + 1) * period) in UTC
+ * seconds; each output bar is stamped with its bucket start (the input
+ * convention: timestamp = bar open). origin = 0 aligns to the clock, e.g.
+ * 5m bars at :00, :05, ...; pass a session open (e.g. 09:15 IST) to align
+ * hourly bars to it.
+ *
+ * A bucket completes on the base bar that reaches its end (timestamp +
+ * base step >= bucket end), so a 5m bar is out on the same update as its
+ * last 1m bar. The base step is given or inferred as the smallest gap seen.
+ * A bucket whose final base bars are missing (e.g. the session's last,
+ * partial hour) completes when a bar of a later bucket arrives instead; that
+ * update can then complete two buckets.
+ */
+class BarResampler {
+public:
+  explicit BarResampler(int64_t period_seconds, int64_t origin = 0,
+                        int64_t base_seconds = 0)
+      : period_(period_seconds), origin_(origin), step_(base_seconds),
+        infer_step_(base_seconds <= 0) {
+    if (period_seconds <= 0)
+      throw std::invalid_argument("BarResampler: period must be > 0");
+  }
+
+  /**
+   * @brief Add one base bar (timestamps increasing). Returns how many
+   * buckets it completed (0-2); completed(0 .. n-1) returns them, oldest
+   * first, until the next update().
+   */
+  int update(const Bar &bar) {
+    int done = 0;
+    const int64_t bucket = bucket_of(bar.timestamp);
+    if (open_ && bucket != bucket_) {
+      completed_[done++] = partial_;
+      open_ = false;
+    }
+
+    if (infer_step_ && has_last_) {
+      int64_t gap = bar.timestamp - last_ts_;
+      if (gap > 0 && (step_ <= 0 || gap < step_))
+        step_ = gap;
+    }
+    last_ts_ = bar.timestamp;
+    has_last_ = true;
+
+    if (!open_) {
+      bucket_ = bucket;
+      partial_ = bar;
+      partial_.timestamp = origin_ + bucket * period_;
+      open_ = true;
+    } else {
+      partial_.high = std::max(partial_.high, bar.high);
+      partial_.low = std::min(partial_.low, bar.low);
+      partial_.close = bar.close;
+      partial_.volume += bar.volume;
+    }
+
+    if (step_ > 0 && bar.timestamp + step_ >= partial_.timestamp + period_) {
+      completed_[done++] = partial_;
+      open_ = false;
+    }
+    return done;
+  }
+
+  // Complete the bucket in progress (end of data). Returns 0 or 1.
+  int flush() {
+    if (!open_)
+      return 0;
+    completed_[0] = partial_;
+    open_ = false;
+    return 1;
+  }
+
+  const Bar &completed(int i = 0) const { return completed_[i]; }
+
+  // Bucket in progress, if any (e.g. to show the forming bar live)
+  bool has_partial() const { return open_; }
+  const Bar &partial() const { return partial_; }
+
+  int64_t period() const { return period_; }
+  int64_t origin() const { return origin_; }
+  int64_t base_step() const { return step_; } // 0 until inferred
+
+private:
+  int64_t bucket_of(int64_t ts) const {
+    const int64_t t = ts - origin_;
+    return t / period_ - (t % period_ < 0);
+  }
+
+  int64_t period_;
+  int64_t origin_;
+  int64_t step_;
+  bool infer_step_;
+
+  int64_t bucket_ = 0;
+  bool open_ = false;
+  Bar partial_;
+  Bar completed_[2];
+
+  int64_t last_ts_ = 0;
+  bool has_last_ = false;
+};
+
+// Whole-series form (research / export): every bucket, the last one
+// possibly partial.
+inline std::vector<Bar> resample(std::span<const Bar> bars,
+                                 int64_t period_seconds, int64_t origin = 0) {
+  BarResampler resampler(period_seconds, origin);
+  std::vector<Bar> out;
+  for (const Bar &bar : bars) {
+    int n = resampler.update(bar);
+    for (int i = 0; i < n; ++i)
+      out.push_back(resampler.completed(i));
+  }
+  if (resampler.flush())
+    out.push_back(resampler.completed());
+  return out;
+}
+
+} // namespace quant
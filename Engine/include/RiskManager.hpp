@@ -2,9 +2,12 @@
 
 #include "Bar.hpp"
 #include <algorithm>
-#include <ctime>
+#include <cstdint>
 #include <iostream>
 #include <optional>
+#include <span>
+#include <utility>
+#include <vector>
 
 namespace quant {
 
@@ -18,6 +21,57 @@ struct RiskConfig {
   int cooldown_bars = 5;            // Cooldown after loss
 };
 
+// ---------------------------------------------------------
+// Stop path (per-bar stop levels of open positions)
+// ---------------------------------------------------------
+// One row per bar a position is open: the stop in force after that bar (the
+// level that was hit on the bar that stops out). `trade` indexes the trade
+// log record the position closes into, so each trade's rows are contiguous.
+struct StopPoint {
+  int64_t timestamp;
+  uint32_t trade;
+  double stop;
+};
+
+class StopPath {
+public:
+  void reserve(size_t n) {
+    timestamp_.reserve(n);
+    trade_.reserve(n);
+    stop_.reserve(n);
+  }
+
+  void push_back(int64_t ts, uint32_t trade, double stop) {
+    timestamp_.push_back(ts);
+    trade_.push_back(trade);
+    stop_.push_back(stop);
+  }
+
+  size_t size() const { return stop_.size(); }
+  bool empty() const { return stop_.empty(); }
+
+  StopPoint operator[](size_t i) const {
+    return {timestamp_[i], trade_[i], stop_[i]};
+  }
+
+  // Rows [first, last) of one trade.
+  std::pair<size_t, size_t> rows(uint32_t trade) const {
+    auto lo = std::lower_bound(trade_.begin(), trade_.end(), trade);
+    auto hi = std::upper_bound(lo, trade_.end(), trade);
+    return {static_cast<size_t>(lo - trade_.begin()),
+            static_cast<size_t>(hi - trade_.begin())};
+  }
+
+  std::span<const int64_t> timestamps() const { return timestamp_; }
+  std::span<const uint32_t> trades() const { return trade_; }
+  std::span<const double> stops() const { return stop_; }
+
+private:
+  std::vector<int64_t> timestamp_;
+  std::vector<uint32_t> trade_;
+  std::vector<double> stop_;
+};
+
 // ---------------------------------------------------------
 // Risk Manager Logic
 // ---------------------------------------------------------
@@ -25,14 +79,17 @@ class RiskManager {
 public:
   explicit RiskManager(RiskConfig config) : config_(config) {}
 
-  // Check if we can enter a new trade
-  bool can_enter(int64_t current_time) {
+  // Check if we can enter a new trade. session_day: exchange-local day
+  // number of the bar (SessionInfo::day), so the daily limit is an integer
+  // compare, not a per-bar calendar conversion.
+  bool can_enter(int32_t session_day) {
+    if (halted_)
+      return false;
+
     // Reset daily trades if day changes
-    if (is_new_day(current_time)) {
+    if (session_day != current_day_) {
       trades_today_ = 0;
-      last_trade_day_ = current_time;
-      // Note: strictly we should store 'current day', but tracking change is
-      // enough
+      current_day_ = session_day;
     }
 
     if (trades_today_ >= config_.max_trades_per_day)
@@ -43,7 +100,8 @@ public:
     return true;
   }
 
-  // Initialize risk parameters for a new position
+  // Initialize risk parameters for a new position. atr_value: the stop
+  // distance unit, ATR(stop_atr_period) as of the signal bar.
   void on_entry(double price, double atr_value, int side) {
     entry_price_ = price;
     highest_price_ = price;
@@ -57,6 +115,7 @@ public:
     } else { // Short
       stop_loss_ = price + (atr_at_entry_ * config_.atr_stop_multiplier);
     }
+    initial_stop_ = stop_loss_;
 
     trades_today_++;
   }
@@ -107,42 +166,45 @@ public:
       cooldown_counter_--;
   }
 
-private:
-  bool is_new_day(int64_t current_time) {
-    // Helper to check if current_time day != last_trade_day_ day
-    std::time_t t1 = static_cast<std::time_t>(current_time);
-    std::time_t t2 = static_cast<std::time_t>(last_trade_day_);
-
-    std::tm *tm1 = std::localtime(&t1);
-    int day1 = tm1->tm_mday;
-    int year1 = tm1->tm_year;
-    int mon1 = tm1->tm_mon;
-
-    std::tm *tm2 = std::localtime(&t2);
-    int day2 = tm2->tm_mday;
-    int year2 = tm2->tm_year;
-    int mon2 = tm2->tm_mon;
-
-    if (year1 != year2 || mon1 != mon2 || day1 != day2) {
-      return true;
-    }
-    return false;
+  /**
+   * @brief Feed the current drawdown (fraction below the equity peak).
+   * Returns true on the bar max_drawdown_limit is first breached; from then
+   * on can_enter() refuses every entry. A limit <= 0 disables the check.
+   */
+  bool check_drawdown(double drawdown) {
+    if (halted_ || config_.max_drawdown_limit <= 0.0 ||
+        drawdown < config_.max_drawdown_limit)
+      return false;
+    halted_ = true;
+    return true;
   }
 
+  bool halted() const { return halted_; }
+
+  // Open position's stops: as placed at entry, and the current (trailed)
+  // level. Kept after on_exit() until the next entry.
+  bool active() const { return side_ != 0; }
+  double initial_stop() const { return initial_stop_; }
+  double stop() const { return stop_loss_; }
+  double atr_at_entry() const { return atr_at_entry_; }
+
+private:
   RiskConfig config_;
 
   // Position State
   int side_ = 0; // 0=Flat, 1=Long, -1=Short
   double entry_price_ = 0.0;
   double stop_loss_ = 0.0;
+  double initial_stop_ = 0.0;
   double highest_price_ = 0.0;
   double lowest_price_ = 0.0;
   double atr_at_entry_ = 0.0;
 
   // Globals
   int trades_today_ = 0;
-  int64_t last_trade_day_ = 0;
+  int32_t current_day_ = 0; // Day the trade count applies to
   int cooldown_counter_ = 0;
+  bool halted_ = false; // Drawdown limit hit
 };
 
 } // namespace quant
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+namespace quant {
+
+// Sliding updates between exact recomputations of the window moments.
+// Re-anchoring costs O(window), so amortized it is < 1 op per update for
+// any window up to this size, while bounding accumulated rounding drift.
+inline constexpr size_t ROLLING_REANCHOR_INTERVAL = 4096;
+
+/**
+ * @brief O(1) mean / variance of a sliding window (Welford-style updates).
+ *
+ * Unlike running sum / sum-of-squares, the update never subtracts two large
+ * nearly-equal quantities, so it stays accurate for inputs with a large
+ * offset (prices, volume). Inputs are shifted by an anchor near the window
+ * mean, so the running mean stays small and keeps its precision. The caller
+ * owns the window values and passes them to reanchor() (exact recompute,
+ * new anchor) whenever due_for_reanchor() reports so.
+ *
+ * Window: anything with size() and operator[] (e.g. a CircularBuffer or a
+ * std::span). Element order does not matter.
+ */
+class RollingMoments {
+public:
+  // Grow the window by one value.
+  void add(double x) {
+    if (count_ == 0)
+      anchor_ = x;
+    x -= anchor_;
+    ++count_;
+    double delta = x - mean_;
+    mean_ += delta / count_;
+    m2_ += delta * (x - mean_);
+  }
+
+  // Slide a full window: x_old leaves, x_new enters (count unchanged).
+  void replace(double x_old, double x_new) {
+    x_old -= anchor_;
+    x_new -= anchor_;
+    double delta = x_new - x_old;
+    double old_mean = mean_;
+    mean_ += delta / count_;
+    m2_ += delta * ((x_new - mean_) + (x_old - old_mean));
+    ++updates_since_anchor_;
+  }
+
+  bool due_for_reanchor() const {
+    return updates_since_anchor_ >= ROLLING_REANCHOR_INTERVAL;
+  }
+
+  // Exact two-pass recomputation from the current window contents.
+  template <typename Window> void reanchor(const Window &window) {
+    count_ = window.size();
+    updates_since_anchor_ = 0;
+    if (count_ == 0) {
+      anchor_ = mean_ = m2_ = 0.0;
+      return;
+    }
+    double sum = 0.0;
+    for (size_t i = 0; i < count_; ++i)
+      sum += window[i];
+    anchor_ = sum / count_;
+    mean_ = 0.0;
+    double m2 = 0.0;
+    for (size_t i = 0; i < count_; ++i) {
+      double d = window[i] - anchor_;
+      m2 += d * d;
+    }
+    m2_ = m2;
+  }
+
+  void clear() { *this = RollingMoments(); }
+
+  size_t count() const { return count_; }
+  double mean() const { return anchor_ + mean_; }
+
+  // Population variance (divide by n), as used by the indicators and the
+  // batch rolling_std / zscore.
+  double variance() const {
+    return count_ > 0 && m2_ > 0.0 ? m2_ / count_ : 0.0;
+  }
+  double std_dev() const { return std::sqrt(variance()); }
+
+private:
+  size_t count_ = 0;
+  size_t updates_since_anchor_ = 0;
+  double anchor_ = 0.0; // Shift applied to inputs; reset on reanchor()
+  double mean_ = 0.0;   // Mean of the shifted values
+  double m2_ = 0.0;     // Sum of squared deviations from the mean
+};
+
+} // namespace quant
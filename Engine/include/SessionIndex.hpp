@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Bar.hpp"
+#include "BarSeries.hpp"
+#include "TimeUtils.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace quant {
+
+/**
+ * @brief Exchange-local trading day of one bar, plus session-boundary flags.
+ * Day = days since 1970-01-01 in exchange local time (session_day()).
+ */
+struct SessionInfo {
+  static constexpr uint8_t FIRST_OF_DAY = 1;
+  static constexpr uint8_t LAST_OF_DAY = 2;
+
+  int32_t day = 0;
+  uint8_t flags = 0;
+
+  bool first_of_day() const { return flags & FIRST_OF_DAY; }
+  bool last_of_day() const { return flags & LAST_OF_DAY; }
+};
+
+/**
+ * @brief Per-bar session index, derived once from a timestamp column with
+ * a fixed exchange UTC offset (integer arithmetic only, no TZ database).
+ *
+ * Consumers compare day numbers instead of calling localtime per bar, and
+ * know in advance which bar closes each day (LAST_OF_DAY: the next bar falls
+ * on a later day, or there is none), e.g. to flatten at the close.
+ */
+class SessionIndex {
+public:
+  SessionIndex() = default;
+
+  SessionIndex(std::span<const int64_t> timestamps, int64_t utc_offset)
+      : utc_offset_(utc_offset) {
+    build(timestamps.size(), [&](size_t i) { return timestamps[i]; });
+  }
+
+  // Same from row-layout bars, without gathering a timestamp column first.
+  static SessionIndex from_bars(std::span<const Bar> bars, int64_t utc_offset) {
+    SessionIndex index;
+    index.utc_offset_ = utc_offset;
+    index.build(bars.size(), [&](size_t i) { return bars[i].timestamp; });
+    return index;
+  }
+
+  size_t size() const { return day_.size(); }
+  bool empty() const { return day_.empty(); }
+  int64_t utc_offset() const { return utc_offset_; }
+
+  SessionInfo operator[](size_t i) const { return {day_[i], flags_[i]}; }
+
+  std::span<const int32_t> days() const { return day_; }
+
+  // Number of distinct trading days
+  size_t day_count() const {
+    size_t n = 0;
+    for (uint8_t f : flags_)
+      n += (f & SessionInfo::FIRST_OF_DAY) != 0;
+    return n;
+  }
+
+private:
+  // Day numbers and flags for n bars; timestamp_of(i) is bar i's timestamp.
+  template <typename TimestampOf>
+  void build(size_t n, TimestampOf timestamp_of) {
+    day_.resize(n);
+    flags_.resize(n);
+    for (size_t i = 0; i < n; ++i)
+      day_[i] = session_day(timestamp_of(i), utc_offset_);
+    for (size_t i = 0; i < n; ++i) {
+      uint8_t f = 0;
+      if (i == 0 || day_[i] != day_[i - 1])
+        f |= SessionInfo::FIRST_OF_DAY;
+      if (i + 1 == n || day_[i + 1] != day_[i])
+        f |= SessionInfo::LAST_OF_DAY;
+      flags_[i] = f;
+    }
+  }
+
+  int64_t utc_offset_ = 0;
+  AlignedVector<int32_t> day_;
+  std::vector<uint8_t> flags_;
+};
+
+/**
+ * @brief Incremental counterpart for live bars: assigns the day number and
+ * FIRST_OF_DAY as bars arrive. LAST_OF_DAY needs the next bar (or the feed's
+ * own session calendar), so it is never set here.
+ */
+class SessionTracker {
+public:
+  explicit SessionTracker(int64_t utc_offset = 0) : utc_offset_(utc_offset) {}
+
+  SessionInfo next(int64_t timestamp) {
+    SessionInfo s{session_day(timestamp, utc_offset_), 0};
+    if (!started_ || s.day != last_day_)
+      s.flags = SessionInfo::FIRST_OF_DAY;
+    started_ = true;
+    last_day_ = s.day;
+    return s;
+  }
+
+private:
+  int64_t utc_offset_;
+  int32_t last_day_ = 0;
+  bool started_ = false;
+};
+
+} // namespace quant
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+namespace quant {
+
+/**
+ * @brief Bounded single-producer / single-consumer lock-free ring.
+ *
+ * Storage is allocated once in the constructor (capacity rounded up to a
+ * power of two); push/pop never allocate or lock. Head and tail live on
+ * separate cache lines, and each side keeps a cached copy of the other's
+ * index so it only touches the shared line when the ring looks full/empty.
+ *
+ * Exactly one thread may call try_push() and exactly one thread try_pop().
+ */
+template <typename T> class SpscQueue {
+public:
+  explicit SpscQueue(size_t capacity)
+      : mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+        slots_(mask_ + 1) {}
+
+  SpscQueue(const SpscQueue &) = delete;
+  SpscQueue &operator=(const SpscQueue &) = delete;
+
+  // Producer side. Returns false (value not queued) if the ring is full.
+  bool try_push(const T &value) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ > mask_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ > mask_)
+        return false;
+    }
+    slots_[tail & mask_] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns false (out untouched) if the ring is empty.
+  bool try_pop(T &out) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_)
+        return false;
+    }
+    out = slots_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t capacity() const { return mask_ + 1; }
+
+  // Racy snapshot; exact only when both sides are idle.
+  size_t size_approx() const {
+    return tail_.load(std::memory_order_acquire) -
+           head_.load(std::memory_order_acquire);
+  }
+
+private:
+  // Consumer-owned line
+  alignas(64) std::atomic<size_t> head_{0};
+  size_t tail_cache_ = 0;
+
+  // Producer-owned line
+  alignas(64) std::atomic<size_t> tail_{0};
+  size_t head_cache_ = 0;
+
+  alignas(64) const size_t mask_;
+  std::vector<T> slots_;
+};
+
+} // namespace quant
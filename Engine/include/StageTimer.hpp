@@ -0,0 +1,372 @@
+#pragma once
+
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(QUANT_STAGE_TIMING) && !defined(QUANT_STAGE_CLOCK_STEADY) &&     \
+    (defined(__x86_64__) || defined(_M_X64))
+#define QUANT_STAGE_CLOCK_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Per-stage hot-path timing (compile-time optional)
+// ---------------------------------------------------------
+// Built with QUANT_STAGE_TIMING (CMake option of the same name), Engine::step
+// and the strategy stacks time each stage of every bar into a StageProfile:
+// a LatencyHistogram per stage plus an optional sampled trace. Otherwise
+// QUANT_STAGE_SCOPE expands to nothing and no profile exists, so the hot
+// loop is unchanged. Ticks are the TSC on x86-64 (QUANT_STAGE_CLOCK=steady
+// selects std::chrono::steady_clock) and are converted to ns for reporting.
+
+#ifdef QUANT_STAGE_TIMING
+inline constexpr bool STAGE_TIMING = true;
+#else
+inline constexpr bool STAGE_TIMING = false;
+#endif
+
+// Stages of Engine::step, in order. The stack stages are attributed inside
+// the stacks (registry update, then each strategy's on_bar).
+enum class Stage : uint8_t {
+  Fills,      // ExecutionEngine::on_bar_open (order book match)
+  RiskExit,   // RiskManager::check_exit and the stop close
+  Indicators, // IndicatorRegistry::update
+  Regime,     // Strategy 0 (regime detector) on_bar
+  Trend,      // Strategy 1 (trend slot) on_bar
+  Range,      // Strategy 2 (range slot) on_bar
+  Signal,     // regime() / signal() allocation dispatch
+  Orders,     // Entry / exit decisions, session flatten, cooldown
+  Equity,     // Mark to market, drawdown check
+  COUNT
+};
+
+inline const char *stage_name(Stage stage) {
+  static constexpr const char *names[] = {
+      "fills",         "check_exit",    "indicators",
+      "regime.on_bar", "trend.on_bar",  "range.on_bar",
+      "signal",        "orders",        "equity"};
+  return names[static_cast<size_t>(stage)];
+}
+
+// Stage of the I-th strategy of a pipeline (extra strategies count as range).
+constexpr Stage strategy_stage(size_t index) {
+  return static_cast<Stage>(static_cast<size_t>(Stage::Regime) +
+                            (index < 2 ? index : 2));
+}
+
+inline uint64_t stage_clock_now() {
+#ifdef QUANT_STAGE_CLOCK_TSC
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+
+// Clock name and ns per tick (measured once for the TSC, over ~20 ms).
+inline const char *stage_clock_name() {
+#ifdef QUANT_STAGE_CLOCK_TSC
+  return "tsc";
+#else
+  return "steady_clock";
+#endif
+}
+
+inline double stage_ns_per_tick() {
+#ifdef QUANT_STAGE_CLOCK_TSC
+  static const double ns_per_tick = [] {
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t c0 = __rdtsc();
+    while (std::chrono::steady_clock::now() - t0 <
+           std::chrono::milliseconds(20)) {
+    }
+    uint64_t c1 = __rdtsc();
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - t0)
+                    .count();
+    return c1 > c0 ? ns / static_cast<double>(c1 - c0) : 1.0;
+  }();
+  return ns_per_tick;
+#else
+  return 1.0;
+#endif
+}
+
+// Ticks one stage_clock_now() call costs: the fastest of many back-to-back
+// pairs, measured once.
+inline double stage_clock_overhead_ticks() {
+  static const double ticks = [] {
+    uint64_t best = ~uint64_t{0};
+    for (int i = 0; i < 10000; ++i) {
+      const uint64_t t0 = stage_clock_now();
+      const uint64_t t1 = stage_clock_now();
+      best = std::min(best, t1 - t0);
+    }
+    return static_cast<double>(best);
+  }();
+  return ticks;
+}
+
+/**
+ * @brief Per-stage tick histograms for one run (one Engine), plus the whole
+ * step per bar. With enable_trace(), every nth bar's stages are also kept
+ * as slices, up to a preallocated event budget, for write_chrome_trace().
+ */
+class StageProfile {
+public:
+  static constexpr size_t STAGES = static_cast<size_t>(Stage::COUNT);
+
+  // Keep slices for every `every_nth_bar`-th bar until `max_events` slices
+  // (stages plus one per bar) are stored. Allocates here, not per bar.
+  void enable_trace(size_t max_events, size_t every_nth_bar = 1) {
+    trace_every_ = every_nth_bar ? every_nth_bar : 1;
+    trace_.clear();
+    trace_.reserve(max_events);
+  }
+
+  void reset() {
+    for (auto &h : stages_)
+      h.reset();
+    bars_.reset();
+    bar_index_ = 0;
+    tracing_ = false;
+    trace_.clear();
+  }
+
+  // Engine::step brackets each bar with these.
+  void begin_bar() {
+    tracing_ = trace_.capacity() > 0 && bar_index_ % trace_every_ == 0 &&
+               trace_.size() + STAGES + 1 <= trace_.capacity();
+  }
+  void end_bar(uint64_t start, uint64_t end) {
+    bars_.record(end - start);
+    if (tracing_)
+      trace_.push_back({start, end, bar_index_, EVENT_BAR});
+    ++bar_index_;
+  }
+
+  void record(Stage stage, uint64_t start, uint64_t end) {
+    stages_[static_cast<size_t>(stage)].record(end - start);
+    if (tracing_)
+      trace_.push_back({start, end, bar_index_, static_cast<uint8_t>(stage)});
+  }
+
+  const LatencyHistogram &stage(Stage stage) const {
+    return stages_[static_cast<size_t>(stage)];
+  }
+  // Whole Engine::step per bar (stages + untimed glue + timer overhead).
+  const LatencyHistogram &bars() const { return bars_; }
+
+  /**
+   * @brief Breakdown table: calls, total, share of step time and ns
+   * percentiles per stage; "other" is step time outside any stage: loop
+   * glue plus the timers themselves. Every scope reads the clock twice and
+   * roughly one read per scope lands outside it, so on short stages the
+   * timers are a large part of "other" (and of the step); the "timers"
+   * row estimates that part from the measured cost of a clock read. Stage
+   * totals are comparable with each other, but the step time of a timing
+   * build is not that of a normal build.
+   */
+  void print(std::ostream &out = std::cout) const {
+    const double scale = stage_ns_per_tick();
+    const double total = bars_.mean() * static_cast<double>(bars_.count());
+    std::ios state(nullptr);
+    state.copyfmt(out);
+
+    out << "\n[STAGES] " << bars_.count() << " bars, clock "
+        << stage_clock_name() << "\n"
+        << "[STAGES] " << std::left << std::setw(15) << "Stage" << std::right
+        << std::setw(11) << "Calls" << std::setw(11) << "Total ms"
+        << std::setw(8) << "Step%" << std::setw(9) << "Mean ns"
+        << std::setw(8) << "p50" << std::setw(8) << "p99" << std::setw(10)
+        << "Max" << "\n";
+
+    double staged = 0.0;
+    double reads = 2.0 * static_cast<double>(bars_.count());
+    auto row = [&](const char *name, const LatencyHistogram &h,
+                   double sum_ticks) {
+      out << "[STAGES] " << std::left << std::setw(15) << name << std::right
+          << std::setw(11) << h.count() << std::fixed << std::setprecision(2)
+          << std::setw(11) << sum_ticks * scale / 1e6 << std::setprecision(1)
+          << std::setw(8) << (total > 0 ? 100.0 * sum_ticks / total : 0.0)
+          << std::setw(9) << h.mean() * scale << std::setprecision(0)
+          << std::setw(8) << h.percentile(0.5) * scale << std::setw(8)
+          << h.percentile(0.99) * scale << std::setw(10) << h.max() * scale
+          << "\n";
+    };
+    for (size_t i = 0; i < STAGES; ++i) {
+      const auto &h = stages_[i];
+      if (h.count() == 0)
+        continue;
+      double sum = h.mean() * static_cast<double>(h.count());
+      staged += sum;
+      reads += 2.0 * static_cast<double>(h.count());
+      row(stage_name(static_cast<Stage>(i)), h, sum);
+    }
+    out << "[STAGES] " << std::left << std::setw(15) << "other" << std::right
+        << std::setw(11) << "" << std::fixed << std::setprecision(2)
+        << std::setw(11) << (total - staged) * scale / 1e6
+        << std::setprecision(1) << std::setw(8)
+        << (total > 0 ? 100.0 * (total - staged) / total : 0.0) << "\n";
+    // About one clock read per scope falls outside every stage
+    const double timers =
+        std::min(total - staged, reads / 2.0 * stage_clock_overhead_ticks());
+    out << "[STAGES] " << std::left << std::setw(15) << "  timers (est.)"
+        << std::right << std::setw(11) << "" << std::setprecision(2)
+        << std::setw(11) << timers * scale / 1e6 << std::setprecision(1)
+        << std::setw(8) << (total > 0 ? 100.0 * timers / total : 0.0) << "\n";
+    row("step", bars_, total);
+    out.copyfmt(state);
+  }
+
+  /**
+   * @brief Write the traced slices as Chrome trace-event JSON (load in
+   * chrome://tracing or ui.perfetto.dev): one "bar" slice per traced bar
+   * with its stages nested inside. Timestamps are relative to the earliest
+   * slice start (a bar's slice is stored after its stages). Returns false
+   * if the file can't be written.
+   */
+  bool write_chrome_trace(const std::string &path, int thread_id = 1) const {
+    std::ofstream out(path);
+    if (!out)
+      return false;
+    const double us_per_tick = stage_ns_per_tick() / 1000.0;
+    uint64_t origin = ~uint64_t{0};
+    for (const TraceEvent &e : trace_)
+      origin = std::min(origin, e.start);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n" << std::fixed
+        << std::setprecision(3);
+    for (size_t i = 0; i < trace_.size(); ++i) {
+      const TraceEvent &e = trace_[i];
+      const char *name = e.stage == EVENT_BAR
+                             ? "bar"
+                             : stage_name(static_cast<Stage>(e.stage));
+      out << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread_id
+          << ",\"ts\":" << static_cast<double>(e.start - origin) * us_per_tick
+          << ",\"dur\":" << static_cast<double>(e.end - e.start) * us_per_tick
+          << ",\"args\":{\"bar\":" << e.bar << "}}"
+          << (i + 1 < trace_.size() ? ",\n" : "\n");
+    }
+    out << "]}\n";
+    return static_cast<bool>(out);
+  }
+
+  size_t trace_events() const { return trace_.size(); }
+
+private:
+  static constexpr uint8_t EVENT_BAR = 0xff;
+
+  struct TraceEvent {
+    uint64_t start;
+    uint64_t end;
+    uint64_t bar;
+    uint8_t stage; // Stage, or EVENT_BAR for the whole step
+  };
+
+  std::array<LatencyHistogram, STAGES> stages_{};
+  LatencyHistogram bars_;
+
+  uint64_t bar_index_ = 0;
+  size_t trace_every_ = 1;
+  bool tracing_ = false;
+  std::vector<TraceEvent> trace_;
+};
+
+// Profile the calling thread's stage scopes record into (set per step by
+// Engine, so interleaved engines on one thread each get their own).
+inline StageProfile *&current_stage_profile() {
+  thread_local StageProfile *profile = nullptr;
+  return profile;
+}
+
+// Binds `profile` to this thread for its lifetime, restoring the previous
+// binding after.
+class StageProfileBinding {
+public:
+  explicit StageProfileBinding(StageProfile *profile)
+      : previous_(current_stage_profile()) {
+    current_stage_profile() = profile;
+  }
+  ~StageProfileBinding() { current_stage_profile() = previous_; }
+
+  StageProfileBinding(const StageProfileBinding &) = delete;
+  StageProfileBinding &operator=(const StageProfileBinding &) = delete;
+
+private:
+  StageProfile *previous_;
+};
+
+// One Engine::step: binds `profile` to the thread and records the whole
+// step as a bar. A null profile binds nothing, so no stage is timed.
+class StageStep {
+public:
+  explicit StageStep(StageProfile *profile)
+      : binding_(profile), profile_(profile) {
+    if (profile_) {
+      profile_->begin_bar();
+      start_ = stage_clock_now();
+    }
+  }
+  ~StageStep() {
+    if (profile_)
+      profile_->end_bar(start_, stage_clock_now());
+  }
+
+  StageStep(const StageStep &) = delete;
+  StageStep &operator=(const StageStep &) = delete;
+
+private:
+  StageProfileBinding binding_;
+  StageProfile *profile_;
+  uint64_t start_ = 0;
+};
+
+// Times its enclosing scope as `stage` into the bound profile, if any.
+class StageScope {
+public:
+  explicit StageScope(Stage stage)
+      : profile_(current_stage_profile()), stage_(stage),
+        start_(profile_ ? stage_clock_now() : 0) {}
+  ~StageScope() {
+    if (profile_)
+      profile_->record(stage_, start_, stage_clock_now());
+  }
+
+  StageScope(const StageScope &) = delete;
+  StageScope &operator=(const StageScope &) = delete;
+
+private:
+  StageProfile *profile_;
+  Stage stage_;
+  uint64_t start_;
+};
+
+} // namespace quant
+
+#define QUANT_STAGE_CONCAT_(a, b) a##b
+#define QUANT_STAGE_CONCAT(a, b) QUANT_STAGE_CONCAT_(a, b)
+
+// QUANT_STAGE_SCOPE(Stage::Fills); times the rest of the enclosing block.
+#ifdef QUANT_STAGE_TIMING
+#define QUANT_STAGE_SCOPE(stage)                                               \
+  ::quant::StageScope QUANT_STAGE_CONCAT(quant_stage_scope_, __LINE__)(stage)
+#else
+#define QUANT_STAGE_SCOPE(stage) static_cast<void>(0)
+#endif
@@ -1,9 +1,15 @@
 #pragma once
 
 #include "Bar.hpp"
+#include "IndicatorRegistry.hpp"
 #include "Indicators.hpp"
+#include "Regime.hpp"
+#include <array>
+#include <cmath>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <variant>
 
 namespace quant {
 
@@ -31,6 +37,122 @@ constexpr int TREND_SMA = 300; // ~5 hours trend
 constexpr double TREND_THRESHOLD =
     0.005; // Lower threshold slightly for 1-min noise
 
+// Risk
+constexpr int STOP_ATR_PERIOD = 14; // Wilder ATR behind the stop distance
+
+// ---------------------------------------------------------
+// Runtime Strategy Parameters
+// ---------------------------------------------------------
+// Defaults reproduce the constants above; sweeps and bindings override them
+// per Engine without recompiling.
+struct StrategyParams {
+  // Momentum
+  int momentum_period = MOMENTUM_PERIOD;
+  int ranking_period = RANKING_PERIOD;
+  double momentum_entry_threshold = MOMENTUM_ENTRY_THRESHOLD;
+  double momentum_exit_zscore = 0.3;
+  int ema_fast = 12;
+  int ema_slow = 26;
+  int volume_avg_period = 20;
+  int momentum_rsi_period = 14;
+  double momentum_rsi_upper = 75.0;
+  double momentum_rsi_lower = 25.0;
+
+  // Mean Reversion
+  int bb_period = BB_PERIOD;
+  double bb_std_dev = BB_STD_DEV;
+  int rsi_period = RSI_PERIOD;
+  double mr_bb_threshold = BB_SHORT_THRESHOLD;
+  double mr_rsi_low = RSI_LONG_THRESHOLD;
+  double mr_rsi_high = RSI_SHORT_THRESHOLD;
+  double mr_exit_threshold = 0.1;
+  int mr_vol_short = 20;
+  int mr_vol_long = 60;
+
+  // Regime
+  int vol_short = VOL_SHORT;
+  int vol_long = VOL_LONG;
+  int trend_sma = TREND_SMA;
+  double trend_threshold = TREND_THRESHOLD;
+
+  // Risk: ATR behind the RiskManager stop (registered by every stack)
+  int stop_atr_period = STOP_ATR_PERIOD;
+
+  /**
+   * @brief Set a parameter by name (e.g. "bb_period"). Integer fields are
+   * rounded. Returns false for unknown names.
+   */
+  bool set(std::string_view name, double value);
+
+  /// Read a parameter by name (NaN for unknown names).
+  double get(std::string_view name) const;
+};
+
+namespace detail {
+
+using ParamField = std::variant<int StrategyParams::*, double StrategyParams::*>;
+
+struct ParamEntry {
+  std::string_view name;
+  ParamField field;
+};
+
+inline const std::array<ParamEntry, 24> &param_table() {
+  static const std::array<ParamEntry, 24> table = {{
+      {"momentum_period", &StrategyParams::momentum_period},
+      {"ranking_period", &StrategyParams::ranking_period},
+      {"momentum_entry_threshold", &StrategyParams::momentum_entry_threshold},
+      {"momentum_exit_zscore", &StrategyParams::momentum_exit_zscore},
+      {"ema_fast", &StrategyParams::ema_fast},
+      {"ema_slow", &StrategyParams::ema_slow},
+      {"volume_avg_period", &StrategyParams::volume_avg_period},
+      {"momentum_rsi_period", &StrategyParams::momentum_rsi_period},
+      {"momentum_rsi_upper", &StrategyParams::momentum_rsi_upper},
+      {"momentum_rsi_lower", &StrategyParams::momentum_rsi_lower},
+      {"bb_period", &StrategyParams::bb_period},
+      {"bb_std_dev", &StrategyParams::bb_std_dev},
+      {"rsi_period", &StrategyParams::rsi_period},
+      {"mr_bb_threshold", &StrategyParams::mr_bb_threshold},
+      {"mr_rsi_low", &StrategyParams::mr_rsi_low},
+      {"mr_rsi_high", &StrategyParams::mr_rsi_high},
+      {"mr_exit_threshold", &StrategyParams::mr_exit_threshold},
+      {"mr_vol_short", &StrategyParams::mr_vol_short},
+      {"mr_vol_long", &StrategyParams::mr_vol_long},
+      {"vol_short", &StrategyParams::vol_short},
+      {"vol_long", &StrategyParams::vol_long},
+      {"trend_sma", &StrategyParams::trend_sma},
+      {"trend_threshold", &StrategyParams::trend_threshold},
+      {"stop_atr_period", &StrategyParams::stop_atr_period},
+  }};
+  return table;
+}
+
+} // namespace detail
+
+inline bool StrategyParams::set(std::string_view name, double value) {
+  for (const auto &entry : detail::param_table()) {
+    if (entry.name != name)
+      continue;
+    if (auto *f = std::get_if<int StrategyParams::*>(&entry.field))
+      this->*(*f) = static_cast<int>(std::lround(value));
+    else
+      this->*std::get<double StrategyParams::*>(entry.field) = value;
+    return true;
+  }
+  return false;
+}
+
+inline double StrategyParams::get(std::string_view name) const {
+  for (const auto &entry : detail::param_table()) {
+    if (entry.name != name)
+      continue;
+    if (auto *f = std::get_if<int StrategyParams::*>(&entry.field))
+      return this->*(*f);
+    return this->*std::get<double StrategyParams::*>(entry.field);
+  }
+  return std::nan("");
+}
+
 // ---------------------------------------------------------
 // Base Strategy Interface
 // ---------------------------------------------------------
@@ -38,7 +160,9 @@ class Strategy {
 public:
   virtual ~Strategy() = default;
 
-  // Called once per bar with the latest data
+  // Called once per bar with the latest data. Strategies that read shared
+  // indicators from an IndicatorRegistry expect registry.update(bar) to have
+  // run for this bar already.
   virtual void on_bar(const Bar &bar) = 0;
 
   // Returns the current signal (-1, 0, 1)
@@ -46,50 +170,66 @@ public:
 
   // Returns the current regime logic name (for debugging)
   virtual std::string name() const = 0;
+
+  // Bars this strategy must see through on_bar() to rebuild the state it
+  // keeps outside the registry (private indicators, previous values), once
+  // the registry is warm. Lazy warm-up (Warmup.hpp) replays that many bars
+  // before the evaluation window; UNBOUNDED_LOOKBACK (the default, for
+  // strategies that do not say) replays the whole history.
+  virtual size_t warmup_bars() const { return UNBOUNDED_LOOKBACK; }
 };
 
+// The built-in strategies are templates over the registry they read from:
+// an IndicatorRegistry (one symbol) or a BatchRegistryLane (one lane of a
+// cross-symbol BatchIndicatorRegistry). Both offer the same registration
+// calls and get(handle); the plain names below are the single-symbol forms.
+// They hold handles plus one registry pointer, so a strategy copies with its
+// registry; rebind() points the copy at the copied registry.
+
 // ---------------------------------------------------------
 // Regime Detector Strategy (Logic from regimes.py)
 // ---------------------------------------------------------
-class RegimeStrategy : public Strategy {
+template <typename Registry = IndicatorRegistry>
+class BasicRegimeStrategy final : public Strategy {
 public:
-  RegimeStrategy()
-      : vol_short_(VOL_SHORT), vol_long_(VOL_LONG), sma_trend_(TREND_SMA),
-        last_close_(0.0), current_regime_("UNDEFINED") {}
+  explicit BasicRegimeStrategy(Registry &registry,
+                               const StrategyParams &params = {})
+      : registry_(&registry),
+        // Volatility requires log returns.
+        vol_short_(registry.rolling_stats(IndicatorInput::LogReturn,
+                                          params.vol_short)),
+        vol_long_(registry.rolling_stats(IndicatorInput::LogReturn,
+                                         params.vol_long)),
+        sma_trend_(registry.sma(IndicatorInput::Close, params.trend_sma)),
+        trend_threshold_(params.trend_threshold) {}
 
   void on_bar(const Bar &bar) override {
-    // Update Indicators
-    // Volatility requires log returns.
-    if (last_close_ > 0) {
-      double log_ret = std::log(bar.close / last_close_);
-      vol_short_.update(log_ret);
-      vol_long_.update(log_ret);
-    }
-    last_close_ = bar.close;
-
-    sma_trend_.update(bar.close);
+    // Indicators were advanced by the registry for this bar.
+    const auto &vol_short = registry_->get(vol_short_);
+    const auto &vol_long = registry_->get(vol_long_);
+    const auto &sma_trend = registry_->get(sma_trend_);
 
-    if (!vol_long_.is_ready() || !sma_trend_.is_ready()) {
+    if (!vol_long.is_ready() || !sma_trend.is_ready()) {
       return;
     }
 
     // Logic Replicated from regimes.py
     // low_vol = vol_20 < vol_60
-    bool low_vol = vol_short_.std_dev() < vol_long_.std_dev();
+    bool low_vol = vol_short.std_dev() < vol_long.std_dev();
 
     // trend_strength = abs(close - sma_60) / sma_60
-    double sma_val = sma_trend_.value();
+    double sma_val = sma_trend.value();
     double trend_strength = std::abs(bar.close - sma_val) / sma_val;
-    bool trending = trend_strength > TREND_THRESHOLD;
+    bool trending = trend_strength > trend_threshold_;
 
     if (low_vol && trending)
-      current_regime_ = "LV_TREND";
+      current_regime_ = Regime::LvTrend;
     else if (!low_vol && trending)
-      current_regime_ = "HV_TREND";
+      current_regime_ = Regime::HvTrend;
     else if (low_vol && !trending)
-      current_regime_ = "LV_RANGE";
+      current_regime_ = Regime::LvRange;
     else
-      current_regime_ = "HV_RANGE";
+      current_regime_ = Regime::HvRange;
   }
 
   int signal() const override {
@@ -97,56 +237,76 @@ public:
               // architecture
   }
 
-  std::string regime() const { return current_regime_; }
+  Regime regime() const { return current_regime_; }
+  // e.g. "LV_TREND" (reporting only)
+  const char *regime_name() const { return quant::regime_name(current_regime_); }
   std::string name() const override { return "RegimeDetector"; }
+  // Recomputed from the registry every bar
+  size_t warmup_bars() const override { return 0; }
+
+  void rebind(Registry &registry) { registry_ = &registry; }
 
 private:
-  RollingStats vol_short_; // To get std_dev of returns
-  RollingStats vol_long_;
-  SimpleMovingAverage sma_trend_;
-  double last_close_;
-  std::string current_regime_;
+  Registry *registry_;
+  IndicatorHandle<RollingStats> vol_short_; // To get std_dev of returns
+  IndicatorHandle<RollingStats> vol_long_;
+  IndicatorHandle<SimpleMovingAverage> sma_trend_;
+  double trend_threshold_;
+  Regime current_regime_ = Regime::Undefined;
 };
 
+using RegimeStrategy = BasicRegimeStrategy<>;
+
 // ---------------------------------------------------------
 // Momentum Strategy (Logic from momentum.py)
 // ---------------------------------------------------------
 // ---------------------------------------------------------
 // Momentum Strategy (Logic from momentum.py - Enhanced)
 // ---------------------------------------------------------
-class MomentumStrategy : public Strategy {
+template <typename Registry = IndicatorRegistry>
+class BasicMomentumStrategy final : public Strategy {
 public:
-  MomentumStrategy()
-      : roc_(MOMENTUM_PERIOD), roc_zscore_(RANKING_PERIOD), ema_12_(12),
-        ema_26_(26), vol_avg_(20), rsi_(14), current_signal_(0),
+  explicit BasicMomentumStrategy(Registry &registry,
+                                 const StrategyParams &params = {})
+      : registry_(&registry),
+        roc_(registry.roc(IndicatorInput::Close, params.momentum_period)),
+        roc_zscore_(params.ranking_period),
+        ranking_period_(static_cast<size_t>(params.ranking_period)),
+        ema_12_(registry.ema(IndicatorInput::Close, params.ema_fast)),
+        ema_26_(registry.ema(IndicatorInput::Close, params.ema_slow)),
+        vol_avg_(registry.sma(IndicatorInput::Volume, params.volume_avg_period)),
+        rsi_(registry.rsi(IndicatorInput::Close, params.momentum_rsi_period)),
+        entry_threshold_(params.momentum_entry_threshold),
+        exit_zscore_(params.momentum_exit_zscore),
+        rsi_upper_(params.momentum_rsi_upper),
+        rsi_lower_(params.momentum_rsi_lower), current_signal_(0),
         last_zscore_(0.0) {}
 
   void on_bar(const Bar &bar) override {
-    // 1. Update Core Indicators
-    double mom = roc_.update(bar.close);
-    roc_zscore_.update(mom);
-
-    // 2. Update Enhanced Filters
-    ema_12_.update(bar.close);
-    ema_26_.update(bar.close);
-    vol_avg_.update(bar.volume);
-    rsi_.update(bar.close);
-
-    if (!roc_zscore_.is_ready() || !ema_26_.is_ready() ||
-        !vol_avg_.is_ready() || !rsi_.is_ready())
+    // 1. Core Indicators (ROC is shared; its z-score is private to us)
+    roc_zscore_.update(registry_->get(roc_).value());
+
+    // 2. Enhanced Filters (shared, already updated for this bar)
+    const auto &ema_12 = registry_->get(ema_12_);
+    const auto &ema_26 = registry_->get(ema_26_);
+    const auto &vol_avg = registry_->get(vol_avg_);
+    const auto &rsi = registry_->get(rsi_);
+
+    if (!roc_zscore_.is_ready() || !ema_26.is_ready() ||
+        !vol_avg.is_ready() || !rsi.is_ready())
       return;
 
     // 3. Logic (Replicating momentum_signal_enhanced from python)
     double z = roc_zscore_.zscore();
-    double rsi_val = rsi_.value();
+    double rsi_val = rsi.value();
 
-    bool trend_up = ema_12_.value() > ema_26_.value();
-    bool trend_down = ema_12_.value() < ema_26_.value();
+    bool trend_up = ema_12.value() > ema_26.value();
+    bool trend_down = ema_12.value() < ema_26.value();
 
-    bool high_volume = bar.volume > vol_avg_.value();
+    bool high_volume = bar.volume > vol_avg.value();
 
-    bool rsi_not_extreme_high = rsi_val < 75.0;
-    bool rsi_not_extreme_low = rsi_val > 25.0;
+    bool rsi_not_extreme_high = rsi_val < rsi_upper_;
+    bool rsi_not_extreme_low = rsi_val > rsi_lower_;
 
     // Momentum Acceleration (zscore increasing/decreasing)
     bool momentum_accel = (z > last_zscore_); // Long case
@@ -154,14 +314,13 @@ public:
     last_zscore_ = z;
 
     // Entry Logic
-    bool long_entry = (z > MOMENTUM_ENTRY_THRESHOLD) && trend_up &&
-                      high_volume && rsi_not_extreme_high && momentum_accel;
-    bool short_entry = (z < -MOMENTUM_ENTRY_THRESHOLD) && trend_down &&
-                       high_volume && rsi_not_extreme_low && momentum_decel;
+    bool long_entry = (z > entry_threshold_) && trend_up && high_volume &&
+                      rsi_not_extreme_high && momentum_accel;
+    bool short_entry = (z < -entry_threshold_) && trend_down && high_volume &&
+                       rsi_not_extreme_low && momentum_decel;
 
     // Exit Condition (Momentum Weakening - exit_zscore default 0.3)
-    double exit_zscore = 0.3;
-    bool momentum_weak = std::abs(z) < exit_zscore;
+    bool momentum_weak = std::abs(z) < exit_zscore_;
 
     if (long_entry) {
       current_signal_ = 1;
@@ -175,55 +334,76 @@ public:
 
   int signal() const override { return current_signal_; }
   std::string name() const override { return "MomentumEnhanced"; }
+  // The ROC z-score window, plus the previous z-score
+  size_t warmup_bars() const override { return ranking_period_ + 1; }
+
+  void rebind(Registry &registry) { registry_ = &registry; }
 
 private:
-  RateOfChange roc_;
-  RollingStats roc_zscore_;
+  Registry *registry_;
+  IndicatorHandle<RateOfChange> roc_;
+  RollingStats roc_zscore_; // Fed from roc_, not a raw input series
+  size_t ranking_period_;
 
   // Enhanced Filters
-  ExponentialMovingAverage ema_12_;
-  ExponentialMovingAverage ema_26_;
-  SimpleMovingAverage vol_avg_;
-  RSI rsi_;
+  IndicatorHandle<ExponentialMovingAverage> ema_12_;
+  IndicatorHandle<ExponentialMovingAverage> ema_26_;
+  IndicatorHandle<SimpleMovingAverage> vol_avg_;
+  IndicatorHandle<RSI> rsi_;
+
+  double entry_threshold_;
+  double exit_zscore_;
+  double rsi_upper_;
+  double rsi_lower_;
 
   int current_signal_;
   double last_zscore_;
 };
 
+using MomentumStrategy = BasicMomentumStrategy<>;
+
 // ---------------------------------------------------------
 // Mean Reversion Strategy (Logic from mean_reversion.py)
 // ---------------------------------------------------------
 // ---------------------------------------------------------
 // Mean Reversion Strategy (Logic from mean_reversion.py - Enhanced)
 // ---------------------------------------------------------
-class MeanReversionStrategy : public Strategy {
+template <typename Registry = IndicatorRegistry>
+class BasicMeanReversionStrategy final : public Strategy {
 public:
-  MeanReversionStrategy()
-      : bb_(BB_PERIOD, BB_STD_DEV), rsi_(RSI_PERIOD), vol_20_(20), vol_60_(60),
-        current_signal_(0) {}
+  explicit BasicMeanReversionStrategy(Registry &registry,
+                                      const StrategyParams &params = {})
+      : registry_(&registry),
+        bb_(registry.bollinger(IndicatorInput::Close, params.bb_period,
+                               params.bb_std_dev)),
+        rsi_(registry.rsi(IndicatorInput::Close, params.rsi_period)),
+        // Volatility filters need log returns
+        vol_20_(registry.rolling_stats(IndicatorInput::LogReturn,
+                                       params.mr_vol_short)),
+        vol_60_(registry.rolling_stats(IndicatorInput::LogReturn,
+                                       params.mr_vol_long)),
+        bb_std_dev_(params.bb_std_dev), bb_threshold_(params.mr_bb_threshold),
+        rsi_low_(params.mr_rsi_low), rsi_high_(params.mr_rsi_high),
+        exit_threshold_(params.mr_exit_threshold), current_signal_(0) {}
 
   void on_bar(const Bar &bar) override {
-    // 1. Update Indicators
-    BBResult bb_res = bb_.update(bar.close);
-    double rsi_val = rsi_.update(bar.close);
-
-    // Update Volatility (needs log returns)
-    // Assuming simple return approx or tracking last close
-    if (last_close_ > 0) {
-      double log_ret = std::log(bar.close / last_close_);
-      vol_20_.update(log_ret);
-      vol_60_.update(log_ret);
-    }
-    last_close_ = bar.close;
+    // 1. Read Indicators (updated by the registry for this bar)
+    const auto &bb = registry_->get(bb_);
+    const auto &rsi = registry_->get(rsi_);
+    const auto &vol_20 = registry_->get(vol_20_);
+    const auto &vol_60 = registry_->get(vol_60_);
 
-    if (!bb_.is_ready() || !rsi_.is_ready() || !vol_60_.is_ready())
+    if (!bb.is_ready() || !rsi.is_ready() || !vol_60.is_ready())
       return;
 
+    BBResult bb_res = bb.value();
+    double rsi_val = rsi.value();
+
     // 2. Calculate Derived Values
-    double std_dev = (bb_res.upper - bb_res.middle) / BB_STD_DEV;
+    double std_dev = (bb_res.upper - bb_res.middle) / bb_std_dev_;
     double bb_pos = 0.0;
     if (std_dev > 0) {
-      bb_pos = (bar.close - bb_res.middle) / (BB_STD_DEV * std_dev);
+      bb_pos = (bar.close - bb_res.middle) / (bb_std_dev_ * std_dev);
     }
 
     // 3. Logic Matching mean_reversion_signal_enhanced
@@ -232,24 +412,21 @@ public:
     // rsi_oversold = 35, rsi_overbought = 65
     // use_volatility_filter = True (vol_20 < vol_60)
 
-    const double FILTER_BB_THRESH = 0.8; // Stricter (was 0.6)
-    const double FILTER_RSI_LOW = 30.0;  // Stricter (was 35.0)
-    const double FILTER_RSI_HIGH = 70.0; // Stricter (was 65.0)
-
-    bool low_vol_regime = vol_20_.std_dev() < vol_60_.std_dev();
+    // Filter thresholds (StrategyParams::mr_*): defaults are stricter than
+    // Python (bb 0.8 was 0.6, rsi 30/70 was 35/65).
+    bool low_vol_regime = vol_20.std_dev() < vol_60.std_dev();
 
     // Entry Conditions
-    bool long_entry = (bb_pos < -FILTER_BB_THRESH) &&
-                      (rsi_val < FILTER_RSI_LOW) && low_vol_regime;
-    bool short_entry = (bb_pos > FILTER_BB_THRESH) &&
-                       (rsi_val > FILTER_RSI_HIGH) && low_vol_regime;
+    bool long_entry = (bb_pos < -bb_threshold_) && (rsi_val < rsi_low_) &&
+                      low_vol_regime;
+    bool short_entry = (bb_pos > bb_threshold_) && (rsi_val > rsi_high_) &&
+                       low_vol_regime;
 
     // Exit Conditions (Mean Reversion complete)
     // Exit near middle band (bb_pos < 0.1 approx or cross 0)
     // Python: bb_pos > take_profit_target (0.1) for Long Exit
-    const double EXIT_THRESH = 0.1;
-    bool exit_long = bb_pos > EXIT_THRESH;
-    bool exit_short = bb_pos < -EXIT_THRESH;
+    bool exit_long = bb_pos > exit_threshold_;
+    bool exit_short = bb_pos < -exit_threshold_;
 
     if (long_entry) {
       current_signal_ = 1;
@@ -268,17 +445,94 @@ public:
 
   int signal() const override { return current_signal_; }
   std::string name() const override { return "MeanReversionEnhanced"; }
+  // Reads only registry indicators
+  size_t warmup_bars() const override { return 0; }
+
+  void rebind(Registry &registry) { registry_ = &registry; }
 
 private:
-  BollingerBands bb_;
-  RSI rsi_;
+  Registry *registry_;
+  IndicatorHandle<BollingerBands> bb_;
+  IndicatorHandle<RSI> rsi_;
 
   // Enhanced Volatility Filters
-  RollingStats vol_20_;
-  RollingStats vol_60_;
-  double last_close_ = 0.0;
+  IndicatorHandle<RollingStats> vol_20_;
+  IndicatorHandle<RollingStats> vol_60_;
+
+  double bb_std_dev_;
+  double bb_threshold_;
+  double rsi_low_;
+  double rsi_high_;
+  double exit_threshold_;
 
   int current_signal_;
 };
 
+using MeanReversionStrategy = BasicMeanReversionStrategy<>;
+
+// ---------------------------------------------------------
+// Higher-Timeframe Adapter
+// ---------------------------------------------------------
+/**
+ * @brief Runs `Inner` on `seconds` bars resampled from the base series
+ * (IndicatorRegistry::timeframe), inside the base-bar loop. Inner's
+ * indicators live in the timeframe child; its on_bar() sees each completed
+ * bar once, on the base bar that completes it, and its signal holds in
+ * between. E.g. trend on 5m bars, range and regime on 1m:
+ *
+ *   StaticStrategyStack<RegimeStrategy, OnTimeframe<300, MomentumStrategy>>
+ *
+ * or, for a runtime slot, a StrategyFactory returning
+ * std::make_unique<TimeframeStrategy<MomentumStrategy>>(registry, p, 300).
+ * When one base bar completes two buckets (a gap in the data), both reach
+ * the indicators but on_bar() only sees the later one.
+ */
+template <typename Inner> class TimeframeStrategy : public Strategy {
+public:
+  TimeframeStrategy(IndicatorRegistry &registry, const StrategyParams &params,
+                    int64_t seconds, int64_t origin = 0)
+      : child_(&registry.timeframe(seconds, origin)), inner_(*child_, params),
+        seconds_(seconds), origin_(origin) {}
+
+  void on_bar(const Bar &) override {
+    if (child_->fresh())
+      inner_.on_bar(child_->bar());
+  }
+
+  int signal() const override { return inner_.signal(); }
+  std::string name() const override {
+    return inner_.name() + "@" + std::to_string(seconds_) + "s";
+  }
+
+  Regime regime() const
+    requires requires(const Inner &s) { s.regime(); }
+  {
+    return inner_.regime();
+  }
+
+  // The copied registry has a copy of the timeframe child; find it again.
+  void rebind(IndicatorRegistry &registry) {
+    child_ = &registry.timeframe(seconds_, origin_);
+    inner_.rebind(*child_);
+  }
+
+  const Inner &inner() const { return inner_; }
+
+private:
+  IndicatorRegistry *child_;
+  Inner inner_;
+  int64_t seconds_;
+  int64_t origin_;
+};
+
+// TimeframeStrategy with the timeframe fixed at compile time, constructible
+// like the built-ins (registry, params) for StaticStrategyStack slots.
+template <int64_t Seconds, typename Inner>
+class OnTimeframe final : public TimeframeStrategy<Inner> {
+public:
+  explicit OnTimeframe(IndicatorRegistry &registry,
+                       const StrategyParams &params = {})
+      : TimeframeStrategy<Inner>(registry, params, Seconds) {}
+};
+
 } // namespace quant
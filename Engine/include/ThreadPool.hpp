@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace quant {
+
+/**
+ * @brief Fixed-size worker pool for coarse-grained jobs (one backtest, one
+ * file, one parameter set per task). Tasks are expected to be long enough that
+ * a single mutex-protected queue is never the bottleneck.
+ */
+class ThreadPool {
+public:
+  explicit ThreadPool(unsigned num_threads = default_threads()) {
+    num_threads = std::max(1u, num_threads);
+    workers_.reserve(num_threads);
+    for (unsigned i = 0; i < num_threads; ++i) {
+      workers_.emplace_back([this] { worker_loop(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto &w : workers_)
+      w.join();
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  static unsigned default_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  size_t size() const { return workers_.size(); }
+
+  template <typename F> auto submit(F &&fn) -> std::future<decltype(fn())> {
+    using R = decltype(fn());
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+    std::future<R> result = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.emplace([task] { (*task)(); });
+    }
+    cv_.notify_one();
+    return result;
+  }
+
+  /**
+   * @brief Run fn(i) for i in [0, n) across the pool and wait for all.
+   * Indices are handed out dynamically (work stealing via an atomic counter),
+   * so uneven task sizes balance automatically. Waits for every task, then
+   * rethrows the first exception. Must not be called from a pool worker.
+   */
+  template <typename F> void parallel_for(size_t n, F &&fn) {
+    if (n == 0)
+      return;
+    std::atomic<size_t> next{0};
+    size_t num_tasks = std::min(n, workers_.size());
+    std::vector<std::future<void>> done;
+    done.reserve(num_tasks);
+    for (size_t t = 0; t < num_tasks; ++t) {
+      done.push_back(submit([&next, n, &fn] {
+        for (size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1))
+          fn(i);
+      }));
+    }
+    std::exception_ptr first_error;
+    for (auto &f : done) {
+      try {
+        f.get();
+      } catch (...) {
+        if (!first_error)
+          first_error = std::current_exception();
+        next.store(n); // Stop handing out further indices
+      }
+    }
+    if (first_error)
+      std::rethrow_exception(first_error);
+  }
+
+private:
+  void worker_loop() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+        if (stopping_ && tasks_.empty())
+          return;
+        task = std::move(tasks_.front());
+        tasks_.pop();
+      }
+      task();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+};
+
+} // namespace quant
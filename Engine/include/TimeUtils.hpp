@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace quant {
+
+constexpr int64_t SECONDS_PER_DAY = 86400;
+
+/**
+ * @brief Days since 1970-01-01 for a proleptic Gregorian date.
+ * Pure arithmetic (H. Hinnant's days_from_civil): no locale, no TZ database.
+ */
+constexpr int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  const int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+constexpr bool is_leap_year(int64_t y) {
+  return y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+}
+
+// Days in month m (1..12) of year y
+constexpr unsigned days_in_month(int64_t y, unsigned m) {
+  return m == 2 ? 28 + is_leap_year(y) : 30 + ((m + (m > 7)) & 1);
+}
+
+/**
+ * @brief Exchange-local calendar day (days since 1970-01-01) of a UTC epoch
+ * timestamp, for an exchange `utc_offset_seconds` ahead of UTC. Floors, so
+ * pre-1970 timestamps land on the right day too.
+ */
+constexpr int32_t session_day(int64_t utc_seconds, int64_t utc_offset_seconds) {
+  const int64_t local = utc_seconds + utc_offset_seconds;
+  const int64_t q = local / SECONDS_PER_DAY;
+  return static_cast<int32_t>(q - (local % SECONDS_PER_DAY < 0));
+}
+
+// Seconds since exchange-local midnight
+constexpr int64_t session_seconds(int64_t utc_seconds, int64_t utc_offset_seconds) {
+  const int64_t local = utc_seconds + utc_offset_seconds;
+  return local - int64_t{session_day(utc_seconds, utc_offset_seconds)} *
+                     SECONDS_PER_DAY;
+}
+
+namespace detail {
+
+// Value of n ASCII digits starting at p. `ok` is cleared (not branched on)
+// when any character is not a digit, so callers validate once at the end.
+inline unsigned parse_digits(const char *p, int n, bool &ok) {
+  unsigned value = 0;
+  for (int i = 0; i < n; ++i) {
+    unsigned digit = static_cast<unsigned char>(p[i]) - '0';
+    ok &= digit <= 9;
+    value = value * 10 + digit;
+  }
+  return value;
+}
+
+} // namespace detail
+
+/**
+ * @brief Parse a timestamp field into UTC epoch seconds.
+ *
+ * Accepted forms:
+ *   - Unix seconds:             "1704100500"
+ *   - Date only:                "2024-01-01"
+ *   - Date and time:            "2024-01-01 09:15:00", "2024-01-01T09:15"
+ *   - Fractional seconds:       "2024-01-01 09:15:00.250" (truncated)
+ *   - Explicit UTC offset:      "...Z", "...+05:30", "...+0530", "...-04"
+ *
+ * Wall-clock times without an explicit offset are interpreted as exchange
+ * local time `utc_offset_seconds` ahead of UTC (e.g. +19800 for IST). An
+ * explicit suffix in the string takes precedence. Unix seconds are returned
+ * as-is.
+ *
+ * @return false if the field is not one of the formats above, or its date
+ * or time does not exist (2024-02-30, 2023-02-29, 24:00)
+ */
+inline bool parse_timestamp(std::string_view s, int64_t utc_offset_seconds,
+                            int64_t &out) {
+  const size_t n = s.size();
+  if (n == 0)
+    return false;
+
+  // Fixed layout: YYYY-MM-DD. Anything shorter or without dashes at 4/7 is
+  // treated as a plain integer epoch.
+  if (n < 10 || s[4] != '-' || s[7] != '-') {
+    int64_t value = 0;
+    for (char c : s) {
+      unsigned digit = static_cast<unsigned char>(c) - '0';
+      if (digit > 9)
+        return false;
+      value = value * 10 + digit;
+    }
+    out = value;
+    return true;
+  }
+
+  const char *p = s.data();
+  bool ok = true;
+  const unsigned year = detail::parse_digits(p, 4, ok);
+  const unsigned month = detail::parse_digits(p + 5, 2, ok);
+  const unsigned day = detail::parse_digits(p + 8, 2, ok);
+  ok &= (month - 1) < 12 && (day - 1) < days_in_month(year, month);
+
+  unsigned hour = 0, minute = 0, second = 0;
+  size_t pos = 10;
+  if (n >= 16 && (s[10] == ' ' || s[10] == 'T') && s[13] == ':') {
+    hour = detail::parse_digits(p + 11, 2, ok);
+    minute = detail::parse_digits(p + 14, 2, ok);
+    pos = 16;
+    if (n >= 19 && s[16] == ':') {
+      second = detail::parse_digits(p + 17, 2, ok);
+      pos = 19;
+      if (pos < n && (s[pos] == '.' || s[pos] == ',')) {
+        ++pos; // Sub-second precision is dropped (bars are >= 1s)
+        while (pos < n && static_cast<unsigned>(s[pos] - '0') <= 9)
+          ++pos;
+      }
+    }
+    ok &= hour < 24 && minute < 60 && second < 61;
+  }
+
+  int64_t offset = utc_offset_seconds;
+  if (pos < n) {
+    const char tz = s[pos];
+    if (tz == 'Z' && pos + 1 == n) {
+      offset = 0;
+    } else if ((tz == '+' || tz == '-') && pos + 3 <= n) {
+      unsigned off_h = detail::parse_digits(p + pos + 1, 2, ok);
+      unsigned off_m = 0;
+      size_t rest = pos + 3;
+      if (rest < n) {
+        rest += s[rest] == ':';
+        ok &= rest + 2 == n;
+        if (rest + 2 == n)
+          off_m = detail::parse_digits(p + rest, 2, ok);
+      }
+      offset = (tz == '-' ? -1 : 1) * static_cast<int64_t>(off_h * 3600 +
+                                                           off_m * 60);
+    } else {
+      return false;
+    }
+  }
+
+  if (!ok)
+    return false;
+
+  out = days_from_civil(year, month, day) * SECONDS_PER_DAY +
+        static_cast<int64_t>(hour * 3600 + minute * 60 + second) - offset;
+  return true;
+}
+
+} // namespace quant
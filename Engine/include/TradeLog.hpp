@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace quant {
+
+struct Trade {
+  int64_t entry_time;
+  int64_t exit_time;
+  double entry_price;
+  double exit_price;
+  int side;
+  double pnl; // Net of fees
+  double quantity;
+  double fees; // Entry share + exit
+  double initial_stop; // Risk stop at entry (NaN without a RiskManager)
+  double exit_stop;    // Last trailed stop level
+};
+
+/**
+ * @brief Closed-trade log for ExecutionEngine.
+ *
+ * Default: unbounded, grows like a std::vector. With a capacity the records
+ * live in a buffer preallocated up front, so push_back() never allocates;
+ * when the buffer fills it is appended to spill_path as raw Trade records
+ * (unbuffered fwrite, no heap use) and reused. Without a spill path a full
+ * fixed log falls back to growing.
+ *
+ * to_vector() returns every record in order (spilled ones are read back);
+ * call it after the run, it allocates.
+ */
+class TradeLog {
+public:
+  TradeLog() = default;
+
+  explicit TradeLog(size_t capacity, const std::string &spill_path = {})
+      : capacity_(capacity) {
+    records_.reserve(capacity);
+    if (!spill_path.empty()) {
+      spill_ = std::fopen(spill_path.c_str(), "wb+");
+      if (!spill_)
+        throw std::runtime_error("TradeLog: cannot open spill file " +
+                                 spill_path);
+      std::setvbuf(spill_, nullptr, _IONBF, 0);
+    }
+  }
+
+  ~TradeLog() {
+    if (spill_)
+      std::fclose(spill_);
+  }
+
+  TradeLog(const TradeLog &) = delete;
+  TradeLog &operator=(const TradeLog &) = delete;
+
+  TradeLog(TradeLog &&other) noexcept { *this = std::move(other); }
+  TradeLog &operator=(TradeLog &&other) noexcept {
+    if (this != &other) {
+      if (spill_)
+        std::fclose(spill_);
+      records_ = std::move(other.records_);
+      capacity_ = other.capacity_;
+      spilled_ = other.spilled_;
+      spill_ = other.spill_;
+      other.spill_ = nullptr;
+      other.spilled_ = 0;
+    }
+    return *this;
+  }
+
+  void push_back(const Trade &t) {
+    if (capacity_ > 0 && records_.size() == capacity_ && spill_)
+      spill();
+    records_.push_back(t);
+  }
+
+  size_t size() const { return spilled_ + records_.size(); }
+  bool empty() const { return size() == 0; }
+
+  size_t capacity() const { return capacity_; } // 0 = unbounded
+  size_t spilled() const { return spilled_; }
+
+  // Records not yet spilled (the most recent ones).
+  std::span<const Trade> in_memory() const { return records_; }
+
+  std::vector<Trade> to_vector() const {
+    std::vector<Trade> all(spilled_);
+    if (spilled_ > 0) {
+      std::fflush(spill_);
+      std::rewind(spill_);
+      if (std::fread(all.data(), sizeof(Trade), spilled_, spill_) != spilled_)
+        throw std::runtime_error("TradeLog: short read from spill file");
+      std::fseek(spill_, 0, SEEK_END);
+    }
+    all.insert(all.end(), records_.begin(), records_.end());
+    return all;
+  }
+
+private:
+  void spill() {
+    if (std::fwrite(records_.data(), sizeof(Trade), records_.size(), spill_) !=
+        records_.size())
+      throw std::runtime_error("TradeLog: spill write failed");
+    spilled_ += records_.size();
+    records_.clear(); // keeps the buffer
+  }
+
+  std::vector<Trade> records_;
+  size_t capacity_ = 0;
+  size_t spilled_ = 0;
+  std::FILE *spill_ = nullptr;
+};
+
+} // namespace quant
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "Engine.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Walk-Forward Windows
+// ---------------------------------------------------------
+struct WalkForwardConfig {
+  size_t train_bars = 0; // 0 = test windows only
+  size_t test_bars = 0;
+  size_t step_bars = 0;  // Offset between windows; 0 = test_bars
+  bool anchored = false; // Train from bar 0 (expanding) instead of rolling
+};
+
+// Train = [train_begin, test_begin), test = [test_begin, test_end).
+struct WalkForwardWindow {
+  size_t train_begin;
+  size_t test_begin;
+  size_t test_end;
+};
+
+// Windows over n bars; the last test window may be shorter than test_bars.
+// Throws std::invalid_argument when test_bars is 0.
+inline std::vector<WalkForwardWindow>
+walk_forward_windows(size_t n, const WalkForwardConfig &config) {
+  if (config.test_bars == 0)
+    throw std::invalid_argument("walk-forward: test_bars must be > 0");
+  const size_t step = config.step_bars ? config.step_bars : config.test_bars;
+  std::vector<WalkForwardWindow> windows;
+  for (size_t start = 0; start + config.train_bars < n; start += step) {
+    size_t test_begin = start + config.train_bars;
+    windows.push_back({config.anchored ? 0 : start, test_begin,
+                       std::min(n, test_begin + config.test_bars)});
+  }
+  return windows;
+}
+
+// ---------------------------------------------------------
+// Walk-Forward Results
+// ---------------------------------------------------------
+struct WalkForwardResult {
+  WalkForwardWindow window;
+  BacktestResult train; // Empty when train_bars == 0
+  BacktestResult test;
+};
+
+struct WalkForwardReport {
+  std::vector<WalkForwardResult> windows; // In window order
+  // Out-of-sample: every test trade, each window starting at
+  // INITIAL_CAPITAL; final equity sums the windows' P&L.
+  PerformanceReport combined_test;
+  size_t bars = 0;
+  size_t window_bars = 0; // Bars run through engines, over all windows
+  unsigned threads = 1;
+  double wall_ms = 0.0;
+  double bars_per_sec = 0.0; // window_bars / wall time
+};
+
+/**
+ * @brief Splits one read-only bar series into train / test windows and
+ * backtests each, in parallel.
+ *
+ * Indicator and strategy state depends only on the bars seen, so instead of
+ * re-warming every window from cold, one sequential pass runs the stack
+ * (StaticStrategyStack, no trading) over the series and copies it at each
+ * window's train start; that snapshot is the exact state a single run from
+ * bar 0 would have there. Each window task restores its snapshot and runs
+ * train then test on it, with fresh risk / execution / equity state for
+ * each segment. Tasks are submitted as soon as their snapshot exists, so the
+ * snapshot pass overlaps with window runs; windows share nothing mutable.
+ */
+class WalkForward {
+public:
+  WalkForward(std::span<const Bar> bars, WalkForwardConfig config)
+      : bars_(bars), config_(config) {}
+
+  void set_risk_config(const RiskConfig &config) { risk_config_ = config; }
+  void set_fill_config(const FillConfig &config) { fill_config_ = config; }
+  void set_session_utc_offset(int64_t seconds) { session_offset_ = seconds; }
+  void set_allocation(const RegimeAllocation &allocation) {
+    allocation_ = allocation;
+  }
+
+  std::vector<WalkForwardWindow> windows() const {
+    return walk_forward_windows(bars_.size(), config_);
+  }
+
+  WalkForwardReport
+  run(const StrategyParams &params = {},
+      unsigned num_threads = ThreadPool::default_threads()) const {
+    using Stack = StaticStrategyStack<>;
+
+    WalkForwardReport report;
+    report.bars = bars_.size();
+    report.threads = std::max(1u, num_threads);
+    const auto windows = this->windows();
+    report.windows.resize(windows.size());
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    {
+      ThreadPool pool(report.threads);
+      std::vector<std::future<void>> done;
+      done.reserve(windows.size());
+
+      Stack warm(params, allocation_);
+      size_t cursor = 0;
+      for (size_t w = 0; w < windows.size(); ++w) {
+        while (cursor < windows[w].train_begin)
+          warm.on_bar(bars_[cursor++]);
+        auto snapshot = std::make_shared<Stack>(warm);
+        done.push_back(pool.submit([this, &report, &windows, w, snapshot] {
+          run_window(windows[w], *snapshot, report.windows[w]);
+        }));
+      }
+      for (auto &f : done)
+        f.get(); // Rethrows a window's exception
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    report.wall_ms = std::chrono::duration_cast<std::chrono::microseconds>(
+                         end_time - start_time)
+                         .count() /
+                     1000.0;
+
+    std::vector<Trade> test_trades;
+    double test_pnl = 0.0;
+    for (const auto &r : report.windows) {
+      report.window_bars += r.window.test_end - r.window.train_begin;
+      test_trades.insert(test_trades.end(), r.test.trades.begin(),
+                         r.test.trades.end());
+      test_pnl += r.test.report.final_equity - INITIAL_CAPITAL;
+    }
+    report.combined_test = summarize_trades(test_trades, INITIAL_CAPITAL,
+                                            INITIAL_CAPITAL + test_pnl);
+    if (report.wall_ms > 0)
+      report.bars_per_sec = report.window_bars / report.wall_ms * 1000.0;
+    return report;
+  }
+
+  static void print(const WalkForwardReport &report,
+                    std::ostream &out = std::cout) {
+    out << "\n[WALK] Window" << std::setw(10) << "Train" << std::setw(10)
+        << "Test" << std::setw(10) << "Bars" << std::setw(11) << "TrainRet%"
+        << std::setw(10) << "TestRet%" << std::setw(8) << "Trades"
+        << std::setw(8) << "PF" << "\n";
+    for (size_t i = 0; i < report.windows.size(); ++i) {
+      const auto &r = report.windows[i];
+      out << "[WALK] " << std::setw(6) << (i + 1) << std::setw(10)
+          << r.window.train_begin << std::setw(10) << r.window.test_begin
+          << std::setw(10) << (r.window.test_end - r.window.test_begin)
+          << std::fixed << std::setprecision(2) << std::setw(11)
+          << r.train.report.total_return_pct << std::setw(10)
+          << r.test.report.total_return_pct << std::setw(8)
+          << r.test.report.total_trades << std::setw(8)
+          << r.test.report.profit_factor << "\n";
+    }
+    const auto &oos = report.combined_test;
+    out << "[WALK] Out-of-sample: " << oos.total_trades << " trades, return "
+        << std::setprecision(2) << oos.total_return_pct << "%, win rate "
+        << oos.win_rate_pct << "%, PF " << oos.profit_factor << "\n"
+        << "\n[BENCHMARK] " << report.windows.size() << " windows, "
+        << report.window_bars << " window bars on " << report.threads
+        << " threads in " << std::setprecision(1) << report.wall_ms << " ms ("
+        << std::setprecision(0) << report.bars_per_sec << " bars/sec)\n";
+  }
+
+private:
+  template <typename Stack>
+  void run_window(const WalkForwardWindow &window, Stack &stack,
+                  WalkForwardResult &result) const {
+    Engine engine(nullptr); // Runs on bars_ directly; no data store
+    engine.set_risk_config(risk_config_);
+    engine.set_fill_config(fill_config_);
+    engine.set_session_utc_offset(session_offset_);
+
+    result.window = window;
+    result.train = engine.run_backtest(
+        bars_.subspan(window.train_begin,
+                      window.test_begin - window.train_begin),
+        stack);
+    result.test = engine.run_backtest(
+        bars_.subspan(window.test_begin, window.test_end - window.test_begin),
+        stack);
+  }
+
+  std::span<const Bar> bars_;
+  WalkForwardConfig config_;
+  RiskConfig risk_config_ = DEFAULT_RISK_CONFIG;
+  FillConfig fill_config_;
+  int64_t session_offset_ = 0;
+  RegimeAllocation allocation_ = RegimeAllocation::legacy();
+};
+
+} // namespace quant
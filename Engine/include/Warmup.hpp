@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Bar.hpp"
+#include "Indicators.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Lazy Warm-up
+// ---------------------------------------------------------
+// Long windows (TREND_SMA = 300, VOL_LONG = 200, ...) keep every signal off
+// for hundreds of bars, and a stack evaluated on a short window late in a
+// series would otherwise replay everything before it. The planner instead
+// starts work only as far back as the stack's indicators can see:
+//
+//   [seed_begin, replay_begin)  registry seeded in bulk (stack.seed())
+//   [replay_begin, begin)       replayed through stack.on_bar(), no trading:
+//                               the strategies' own state, then settle_bars
+//                               so held signals reach their full-run values
+//   [begin, end)                evaluated
+//
+// Stacks provide lookback(tolerance), warmup_bars() and seed(history)
+// (StaticStrategyStack, DynamicStrategyStack). A stack that cannot bound
+// either (timeframe children, strategies without warmup_bars()) replays
+// from bar 0, which is exactly the full run.
+
+struct WarmupConfig {
+  // Weight an EMA / Wilder average may still put on bars before its
+  // lookback (see Indicators.hpp). 0 = replay from bar 0.
+  double tolerance = 1e-9;
+  // Extra bars replayed before the window: entries hold until their exit
+  // condition, so a signal can depend on bars older than any window.
+  size_t settle_bars = 500;
+  // false: replay the registry's lookback bar by bar instead of seeding it.
+  bool seed = true;
+};
+
+struct WarmupPlan {
+  size_t seed_begin = 0;
+  size_t replay_begin = 0;
+  size_t begin = 0;
+
+  size_t seeded_bars() const { return replay_begin - seed_begin; }
+  size_t replayed_bars() const { return begin - replay_begin; }
+  // Bars of history before `begin` the plan touches at all.
+  size_t history_bars() const { return begin - seed_begin; }
+};
+
+/**
+ * @brief Warm-up for evaluating `stack` from bar `begin` of a series, per
+ * `config`. With tolerance 0 or an unbounded stack, everything before begin
+ * is replayed (seed_begin = replay_begin = 0).
+ */
+template <typename Stack>
+WarmupPlan plan_warmup(const Stack &stack, size_t begin,
+                       const WarmupConfig &config = {}) {
+  WarmupPlan plan;
+  plan.begin = begin;
+  const size_t lookback = stack.lookback(config.tolerance);
+  const size_t strategy_bars = stack.warmup_bars();
+  if (lookback == UNBOUNDED_LOOKBACK || strategy_bars == UNBOUNDED_LOOKBACK)
+    return plan; // Replay everything
+
+  const size_t replay =
+      std::min(begin, strategy_bars + std::min(config.settle_bars, begin));
+  plan.replay_begin = begin - replay;
+  plan.seed_begin = plan.replay_begin - std::min(plan.replay_begin, lookback);
+  if (!config.seed)
+    plan.replay_begin = plan.seed_begin;
+  return plan;
+}
+
+// Run the plan on a fresh `stack` over `bars` (the whole series that
+// plan.begin indexes into). The stack is then as of bar plan.begin - 1.
+template <typename Stack>
+void warm_up(Stack &stack, std::span<const Bar> bars, const WarmupPlan &plan) {
+  if (plan.seeded_bars() > 0)
+    stack.seed(bars.subspan(plan.seed_begin, plan.seeded_bars()));
+  for (size_t i = plan.replay_begin; i < plan.begin; ++i)
+    stack.on_bar(bars[i]);
+}
+
+} // namespace quant
@@ -1,51 +1,161 @@
 #pragma once
 
+#include "BarSeries.hpp"
 #include <vector>
 #include <cmath>
+#include <span>
+#include <string>
+#include <string_view>
 
 namespace quant {
 
+// All inputs are read-only column views: pass a std::vector<double>, or a
+// BarSeries column (e.g. series.close()) to avoid copying out of the bars.
+
 /**
  * Calculate Simple Moving Average
  */
-std::vector<double> sma(const std::vector<double>& prices, int period);
+std::vector<double> sma(std::span<const double> prices, int period);
 
 /**
  * Calculate Exponential Moving Average
  */
-std::vector<double> ema(const std::vector<double>& prices, int period);
+std::vector<double> ema(std::span<const double> prices, int period);
 
 /**
  * Calculate RSI (Relative Strength Index)
  */
-std::vector<double> rsi(const std::vector<double>& prices, int period = 14);
+std::vector<double> rsi(std::span<const double> prices, int period = 14);
 
 /**
  * Calculate ATR (Average True Range)
  */
 std::vector<double> atr(
-    const std::vector<double>& high,
-    const std::vector<double>& low,
-    const std::vector<double>& close,
+    std::span<const double> high,
+    std::span<const double> low,
+    std::span<const double> close,
     int period = 14
 );
 
+/**
+ * Calculate ATR directly from a BarSeries' high/low/close columns
+ */
+std::vector<double> atr(const BarSeries& bars, int period = 14);
+
 /**
  * Calculate momentum (rate of change)
  */
-std::vector<double> momentum(const std::vector<double>& prices, int period);
+std::vector<double> momentum(std::span<const double> prices, int period);
 
 /**
  * Calculate rolling standard deviation
  */
-std::vector<double> rolling_std(const std::vector<double>& values, int period);
+std::vector<double> rolling_std(std::span<const double> values, int period);
 
 /**
  * Calculate z-score
  */
 std::vector<double> zscore(
-    const std::vector<double>& values,
+    std::span<const double> values,
     int period
 );
 
+// ---------------------------------------------------------
+// In-place variants
+// ---------------------------------------------------------
+// Same results as above, written into a caller-owned `out` of the input's
+// length (e.g. a preallocated NumPy array). Warm-up entries are set to NaN;
+// a size mismatch leaves `out` all NaN.
+
+void sma(std::span<const double> prices, int period, std::span<double> out);
+void ema(std::span<const double> prices, int period, std::span<double> out);
+void rsi(std::span<const double> prices, int period, std::span<double> out);
+void atr(std::span<const double> high, std::span<const double> low,
+         std::span<const double> close, int period, std::span<double> out);
+void momentum(std::span<const double> prices, int period, std::span<double> out);
+void rolling_std(std::span<const double> values, int period, std::span<double> out);
+void zscore(std::span<const double> values, int period, std::span<double> out);
+
+// ---------------------------------------------------------
+// Full feature set (Research/src/features.py)
+// ---------------------------------------------------------
+
+/**
+ * Periods used by compute_features. Defaults are generate_features() in
+ * features.py; column names follow its naming (vol_20, ema_12, ...).
+ */
+struct FeatureConfig {
+    int vol_short = 20;
+    int vol_long = 60;
+    int sma_short = 20;
+    int sma_long = 60;
+    std::vector<int> ema_periods = {12, 26};
+    int rsi_period = 14;
+    int macd_fast = 12;
+    int macd_slow = 26;
+    int macd_signal = 9;
+    std::vector<int> momentum_periods = {10, 20};
+    int bb_period = 20;
+    double bb_num_std = 2.0;
+    int atr_period = 14;
+    int zscore_period = 20; // Mean window; scaled by vol_short (vol_20)
+};
+
+/**
+ * Named feature columns over one contiguous, 64-byte aligned buffer
+ * (column-major: each column is a contiguous span of rows()).
+ */
+class FeatureFrame {
+public:
+    FeatureFrame() = default;
+    FeatureFrame(size_t rows, std::vector<std::string> names);
+
+    size_t rows() const { return rows_; }
+    size_t columns() const { return names_.size(); }
+    const std::vector<std::string>& names() const { return names_; }
+
+    std::span<double> column(size_t i) {
+        return {data_.data() + i * stride_, rows_};
+    }
+    std::span<const double> column(size_t i) const {
+        return {data_.data() + i * stride_, rows_};
+    }
+    // Throws std::out_of_range for unknown names.
+    std::span<double> column(std::string_view name);
+    std::span<const double> column(std::string_view name) const;
+
+private:
+    size_t index_of(std::string_view name) const;
+
+    size_t rows_ = 0;
+    size_t stride_ = 0; // rows_ rounded up to a cache line of doubles
+    std::vector<std::string> names_;
+    AlignedVector<double> data_;
+};
+
+/**
+ * Every column features.py's generate_features() adds, in one call:
+ * log_return, vol_*, sma_*, ema_*, rsi_*, macd_line/signal/histogram,
+ * momentum_* and momentum_zscore_*, bb_middle/upper/lower/width/position,
+ * atr_* and zscore_*. Semantics follow pandas: rolling std is the sample
+ * std (ddof = 1), EWMs use adjust=False (RSI / ATR with alpha = 1/period and
+ * min_periods = period), and the ffill clean-ups of features.py are
+ * applied. Rows are not dropped; warm-up rows hold NaN (dropna() is the
+ * caller's choice).
+ *
+ * Shared intermediates (log returns, EMAs, rolling moments) are computed
+ * once. Rolling windows use the SIMD kernels. Throws std::invalid_argument
+ * if the columns differ in length or a period is not positive.
+ */
+FeatureFrame compute_features(
+    std::span<const double> open,
+    std::span<const double> high,
+    std::span<const double> low,
+    std::span<const double> close,
+    std::span<const double> volume,
+    const FeatureConfig& config = {}
+);
+
+FeatureFrame compute_features(const BarSeries& bars, const FeatureConfig& config = {});
+
 } // namespace quant
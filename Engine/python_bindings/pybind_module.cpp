@@ -1,41 +1,688 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "BarSeries.hpp"
+#include "Engine.hpp"
+#include "FeatureKernels.hpp"
+#include "MarketDataManager.hpp"
+#include "MonteCarlo.hpp"
+#include "WalkForward.hpp"
 #include "features.hpp"
 
 namespace py = pybind11;
 
+namespace {
+
+// Read-only NumPy view over a BarSeries column; `owner` (the Python-side
+// BarSeries) is kept alive by the array, so no data is copied.
+template <typename T>
+py::array column_view(std::span<const T> column, py::handle owner) {
+    py::array_t<T> arr({static_cast<py::ssize_t>(column.size())},
+                       {static_cast<py::ssize_t>(sizeof(T))}, column.data(), owner);
+    py::detail::array_proxy(arr.ptr())->flags &=
+        ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    return arr;
+}
+
+std::span<const double> series_column(const quant::BarSeries& s,
+                                      const std::string& name) {
+    if (name == "close") return s.close();
+    if (name == "open") return s.open();
+    if (name == "high") return s.high();
+    if (name == "low") return s.low();
+    if (name == "volume") return s.volume();
+    throw std::invalid_argument("Unknown BarSeries column: " + name);
+}
+
+
+// Float64 C-contiguous arrays are read in place; anything else (lists, other
+// dtypes, strided views) is converted once by pybind11.
+using InputArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+std::span<const double> as_span(const InputArray& a, const char* name) {
+    if (a.ndim() != 1) {
+        throw std::invalid_argument(std::string(name) + " must be 1-D");
+    }
+    return {a.data(), static_cast<size_t>(a.size())};
+}
+
+// Caller-supplied `out` is written in place and must already be a writeable,
+// C-contiguous float64 array of length n that does not overlap any input;
+// None allocates a fresh array.
+py::array_t<double> output_array(const py::object& out, size_t n,
+                                 std::initializer_list<std::span<const double>> inputs) {
+    if (out.is_none()) {
+        return py::array_t<double>(static_cast<py::ssize_t>(n));
+    }
+    if (!py::isinstance<py::array>(out)) {
+        throw std::invalid_argument("out must be a numpy array");
+    }
+    auto arr = py::reinterpret_borrow<py::array>(out);
+    if (!arr.dtype().is(py::dtype::of<double>()) || arr.ndim() != 1 ||
+        !(arr.flags() & py::array::c_style) || !arr.writeable() ||
+        static_cast<size_t>(arr.size()) != n) {
+        throw std::invalid_argument(
+            "out must be a writeable, C-contiguous float64 array of length " +
+            std::to_string(n));
+    }
+    const auto* begin = static_cast<const double*>(arr.data());
+    for (auto in : inputs) {
+        if (begin < in.data() + in.size() && in.data() < begin + n) {
+            throw std::invalid_argument("out must not overlap the inputs");
+        }
+    }
+    return py::reinterpret_borrow<py::array_t<double>>(arr);
+}
+
+// f(input, period, out) on NumPy buffers with the GIL released.
+template <typename Fn>
+py::array_t<double> unary_feature(Fn fn, const InputArray& x, int period,
+                                  const py::object& out) {
+    auto in = as_span(x, "values");
+    auto result = output_array(out, in.size(), {in});
+    std::span<double> dst(result.mutable_data(), in.size());
+    {
+        py::gil_scoped_release release;
+        fn(in, period, dst);
+    }
+    return result;
+}
+
+// Columns of a FeatureFrame as read-only arrays sharing its buffer; the frame
+// lives as long as any of them does.
+py::dict feature_dict(quant::FeatureFrame&& computed) {
+    auto* frame = new quant::FeatureFrame(std::move(computed));
+    py::capsule owner(frame, [](void* p) { delete static_cast<quant::FeatureFrame*>(p); });
+    py::dict columns;
+    for (size_t i = 0; i < frame->columns(); ++i) {
+        std::span<const double> column = std::as_const(*frame).column(i);
+        columns[py::str(frame->names()[i])] = column_view(column, owner);
+    }
+    return columns;
+}
+
+
+using TimestampArray = py::array_t<int64_t, py::array::c_style | py::array::forcecast>;
+
+// Bars for Engine.run straight from NumPy / pandas columns (no row copy).
+quant::BarColumns bar_columns(const TimestampArray& timestamp, const InputArray& open,
+                              const InputArray& high, const InputArray& low,
+                              const InputArray& close, const InputArray& volume) {
+    if (timestamp.ndim() != 1) {
+        throw std::invalid_argument("timestamp must be 1-D");
+    }
+    quant::BarColumns bars{
+        {timestamp.data(), static_cast<size_t>(timestamp.size())},
+        as_span(open, "open"), as_span(high, "high"), as_span(low, "low"),
+        as_span(close, "close"), as_span(volume, "volume")};
+    if (!bars.consistent()) {
+        throw std::invalid_argument("bar columns differ in length");
+    }
+    return bars;
+}
+
+} // namespace
+
 PYBIND11_MODULE(quant_engine, m) {
     m.doc() = "Quantitative Trading Engine - C++ Implementation";
-    
+
+    PYBIND11_NUMPY_DTYPE(quant::Trade, entry_time, exit_time, entry_price, exit_price,
+                         side, pnl, quantity, fees, initial_stop, exit_stop);
+    PYBIND11_NUMPY_DTYPE(quant::EquityPoint, timestamp, equity, drawdown);
+    PYBIND11_NUMPY_DTYPE(quant::StopPoint, timestamp, trade, stop);
+
+    // Data layer
+    py::class_<quant::BarSeries>(m, "BarSeries",
+                                 "Columnar (structure-of-arrays) bar storage")
+        .def("__len__", &quant::BarSeries::size)
+        .def_property_readonly("timestamp", [](py::object self) {
+            return column_view(self.cast<const quant::BarSeries&>().timestamps(), self);
+        })
+        .def_property_readonly("open", [](py::object self) {
+            return column_view(self.cast<const quant::BarSeries&>().open(), self);
+        })
+        .def_property_readonly("high", [](py::object self) {
+            return column_view(self.cast<const quant::BarSeries&>().high(), self);
+        })
+        .def_property_readonly("low", [](py::object self) {
+            return column_view(self.cast<const quant::BarSeries&>().low(), self);
+        })
+        .def_property_readonly("close", [](py::object self) {
+            return column_view(self.cast<const quant::BarSeries&>().close(), self);
+        })
+        .def_property_readonly("volume", [](py::object self) {
+            return column_view(self.cast<const quant::BarSeries&>().volume(), self);
+        });
+
+    py::class_<quant::LoadReport>(m, "LoadReport")
+        .def_readonly("files", &quant::LoadReport::files)
+        .def_readonly("loaded", &quant::LoadReport::loaded)
+        .def_readonly("from_cache", &quant::LoadReport::from_cache)
+        .def_readonly("failed", &quant::LoadReport::failed)
+        .def_readonly("bytes", &quant::LoadReport::bytes)
+        .def_readonly("read_bytes", &quant::LoadReport::read_bytes)
+        .def_readonly("threads", &quant::LoadReport::threads)
+        .def_readonly("wall_ms", &quant::LoadReport::wall_ms)
+        .def_readonly("mb_per_sec", &quant::LoadReport::mb_per_sec);
+
+    py::class_<quant::MarketDataManager>(m, "MarketDataManager")
+        .def(py::init<>())
+        .def("load_csv", &quant::MarketDataManager::load_csv,
+             py::arg("symbol"), py::arg("filepath"))
+        .def("load_files", &quant::MarketDataManager::load_files,
+             "Load [(symbol, path), ...] in parallel, one file per worker",
+             py::arg("files"), py::arg("num_threads") = 0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("load_directory", &quant::MarketDataManager::load_directory,
+             "Load every *.csv in a directory in parallel (symbol = file stem)",
+             py::arg("directory"), py::arg("num_threads") = 0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("intern", &quant::MarketDataManager::intern, py::arg("symbol"))
+        .def("symbol_id", &quant::MarketDataManager::symbol_id, py::arg("symbol"))
+        .def("symbol_name", &quant::MarketDataManager::symbol_name, py::arg("id"))
+        .def("symbol_count", &quant::MarketDataManager::symbol_count)
+        .def("set_utc_offset", &quant::MarketDataManager::set_utc_offset,
+             py::arg("symbol"), py::arg("offset_seconds"))
+        .def("set_cache_enabled", &quant::MarketDataManager::set_cache_enabled,
+             py::arg("enabled"))
+        .def("get_series",
+             static_cast<const quant::BarSeries &(quant::MarketDataManager::*)(
+                 const std::string &) const>(&quant::MarketDataManager::get_series),
+             "Columnar bars for a symbol (views stay valid while the manager lives)",
+             py::return_value_policy::reference_internal, py::arg("symbol"));
+
+    // Backtest engine
+    py::class_<quant::RiskConfig>(m, "RiskConfig")
+        .def(py::init([](double atr_stop_multiplier, double max_drawdown_limit,
+                         int max_trades_per_day, int cooldown_bars) {
+                 return quant::RiskConfig{atr_stop_multiplier, max_drawdown_limit,
+                                          max_trades_per_day, cooldown_bars};
+             }),
+             py::arg("atr_stop_multiplier") = quant::DEFAULT_RISK_CONFIG.atr_stop_multiplier,
+             py::arg("max_drawdown_limit") = quant::DEFAULT_RISK_CONFIG.max_drawdown_limit,
+             py::arg("max_trades_per_day") = quant::DEFAULT_RISK_CONFIG.max_trades_per_day,
+             py::arg("cooldown_bars") = quant::DEFAULT_RISK_CONFIG.cooldown_bars)
+        .def_readwrite("atr_stop_multiplier", &quant::RiskConfig::atr_stop_multiplier)
+        .def_readwrite("max_drawdown_limit", &quant::RiskConfig::max_drawdown_limit)
+        .def_readwrite("max_trades_per_day", &quant::RiskConfig::max_trades_per_day)
+        .def_readwrite("cooldown_bars", &quant::RiskConfig::cooldown_bars);
+
+    py::enum_<quant::FillPolicy>(m, "FillPolicy")
+        .value("Open", quant::FillPolicy::Open)
+        .value("Vwap", quant::FillPolicy::Vwap)
+        .value("Touch", quant::FillPolicy::Touch);
+
+    py::class_<quant::FillConfig>(m, "FillConfig")
+        .def(py::init([](quant::FillPolicy policy, double slippage_bps,
+                         double slippage_per_share, double fee_rate, double fee_per_fill,
+                         double max_participation) {
+                 quant::FillConfig c;
+                 c.policy = policy;
+                 c.slippage = {slippage_bps, slippage_per_share};
+                 c.fees = {fee_rate, fee_per_fill};
+                 c.max_participation = max_participation;
+                 return c;
+             }),
+             py::arg("policy") = quant::FillPolicy::Open, py::arg("slippage_bps") = 0.0,
+             py::arg("slippage_per_share") = 0.0, py::arg("fee_rate") = 0.0,
+             py::arg("fee_per_fill") = 0.0, py::arg("max_participation") = 0.0)
+        .def_readwrite("policy", &quant::FillConfig::policy)
+        .def_property(
+            "slippage_bps", [](const quant::FillConfig& c) { return c.slippage.bps; },
+            [](quant::FillConfig& c, double v) { c.slippage.bps = v; })
+        .def_property(
+            "slippage_per_share", [](const quant::FillConfig& c) { return c.slippage.per_share; },
+            [](quant::FillConfig& c, double v) { c.slippage.per_share = v; })
+        .def_property(
+            "fee_rate", [](const quant::FillConfig& c) { return c.fees.rate; },
+            [](quant::FillConfig& c, double v) { c.fees.rate = v; })
+        .def_property(
+            "fee_per_fill", [](const quant::FillConfig& c) { return c.fees.per_fill; },
+            [](quant::FillConfig& c, double v) { c.fees.per_fill = v; })
+        .def_readwrite("max_participation", &quant::FillConfig::max_participation);
+
+    // One property per StrategyParams::param_table() entry, plus
+    // StrategyParams(**overrides).
+    auto params = py::class_<quant::StrategyParams>(m, "StrategyParams")
+        .def(py::init([](const py::kwargs& overrides) {
+            quant::StrategyParams p;
+            for (auto [key, value] : overrides) {
+                auto name = key.cast<std::string>();
+                if (!p.set(name, value.cast<double>())) {
+                    throw py::key_error("Unknown strategy parameter: " + name);
+                }
+            }
+            return p;
+        }))
+        .def("set", &quant::StrategyParams::set, py::arg("name"), py::arg("value"))
+        .def("get", &quant::StrategyParams::get, py::arg("name"));
+    for (const auto& entry : quant::detail::param_table()) {
+        std::visit([&](auto field) {
+            params.def_readwrite(entry.name.data(), field); // names are literals
+        }, entry.field);
+    }
+
+    py::class_<quant::PerformanceReport>(m, "PerformanceReport")
+        .def_readonly("initial_capital", &quant::PerformanceReport::initial_capital)
+        .def_readonly("final_equity", &quant::PerformanceReport::final_equity)
+        .def_readonly("total_return_pct", &quant::PerformanceReport::total_return_pct)
+        .def_readonly("total_trades", &quant::PerformanceReport::total_trades)
+        .def_readonly("winning_trades", &quant::PerformanceReport::winning_trades)
+        .def_readonly("win_rate_pct", &quant::PerformanceReport::win_rate_pct)
+        .def_readonly("profit_factor", &quant::PerformanceReport::profit_factor)
+        .def_readonly("gross_profit", &quant::PerformanceReport::gross_profit)
+        .def_readonly("gross_loss", &quant::PerformanceReport::gross_loss)
+        .def_readonly("max_drawdown_pct", &quant::PerformanceReport::max_drawdown_pct)
+        .def_readonly("sharpe", &quant::PerformanceReport::sharpe)
+        .def_readonly("sortino", &quant::PerformanceReport::sortino)
+        .def_readonly("halted", &quant::PerformanceReport::halted);
+
+    // trades is a structured array viewing the result's trade vector; the
+    // columnar equity curve is interleaved into a fresh structured array
+    // (dtype fields = quant::Trade / quant::EquityPoint members); so is the
+    // stop path (quant::StopPoint).
+    py::class_<quant::BacktestResult>(m, "BacktestResult")
+        .def_readonly("symbol", &quant::BacktestResult::symbol)
+        .def_readonly("bars_processed", &quant::BacktestResult::bars_processed)
+        .def_readonly("elapsed_ms", &quant::BacktestResult::elapsed_ms)
+        .def_readonly("report", &quant::BacktestResult::report)
+        .def_property_readonly("trades", [](py::object self) {
+            const auto& r = self.cast<const quant::BacktestResult&>();
+            return column_view(std::span<const quant::Trade>(r.trades), self);
+        })
+        .def_property_readonly("equity_curve", [](const quant::BacktestResult& r) {
+            const auto& curve = r.equity_curve;
+            py::array_t<quant::EquityPoint> arr(static_cast<py::ssize_t>(curve.size()));
+            quant::EquityPoint* rows = arr.mutable_data();
+            for (size_t i = 0; i < curve.size(); ++i) {
+                rows[i] = curve[i];
+            }
+            return arr;
+        })
+        .def_property_readonly("stop_path", [](const quant::BacktestResult& r) {
+            const auto& path = r.stop_path;
+            py::array_t<quant::StopPoint> arr(static_cast<py::ssize_t>(path.size()));
+            quant::StopPoint* rows = arr.mutable_data();
+            for (size_t i = 0; i < path.size(); ++i) {
+                rows[i] = path[i];
+            }
+            return arr;
+        });
+
+    py::class_<quant::WarmupConfig>(m, "WarmupConfig")
+        .def(py::init<>())
+        .def_readwrite("tolerance", &quant::WarmupConfig::tolerance)
+        .def_readwrite("settle_bars", &quant::WarmupConfig::settle_bars)
+        .def_readwrite("seed", &quant::WarmupConfig::seed);
+
+    py::enum_<quant::SizingMode>(m, "SizingMode")
+        .value("FixedFraction", quant::SizingMode::FixedFraction)
+        .value("VolatilityTarget", quant::SizingMode::VolatilityTarget)
+        .value("AtrRisk", quant::SizingMode::AtrRisk);
+
+    py::class_<quant::SizingConfig>(m, "SizingConfig")
+        .def(py::init<>())
+        .def_readwrite("mode", &quant::SizingConfig::mode)
+        .def_readwrite("fraction", &quant::SizingConfig::fraction)
+        .def_readwrite("target_vol", &quant::SizingConfig::target_vol)
+        .def_readwrite("vol_period", &quant::SizingConfig::vol_period)
+        .def_readwrite("risk_per_atr", &quant::SizingConfig::risk_per_atr)
+        .def_readwrite("atr_period", &quant::SizingConfig::atr_period)
+        .def_readwrite("max_fraction", &quant::SizingConfig::max_fraction);
+
+    // run() releases the GIL; give each Python thread its own Engine.
+    py::class_<quant::Engine>(m, "Engine")
+        .def(py::init<>())
+        .def("load_data", &quant::Engine::load_data, py::arg("symbol"), py::arg("filepath"))
+        .def_property("strategy_params", &quant::Engine::strategy_params,
+                      &quant::Engine::set_strategy_params)
+        .def_property("risk_config", &quant::Engine::risk_config,
+                      &quant::Engine::set_risk_config)
+        .def_property("fill_config", &quant::Engine::fill_config,
+                      &quant::Engine::set_fill_config)
+        .def_property("initial_capital", &quant::Engine::initial_capital,
+                      &quant::Engine::set_initial_capital)
+        .def_property("position_sizing", &quant::Engine::position_sizing,
+                      &quant::Engine::set_position_sizing)
+        .def("set_record_equity", &quant::Engine::set_record_equity, py::arg("enabled"))
+        .def("set_record_stops", &quant::Engine::set_record_stops, py::arg("enabled"))
+        .def("set_journal",
+             [](quant::Engine& e, std::string path, uint32_t snapshot_every) {
+                 quant::JournalConfig config;
+                 config.snapshot_every = snapshot_every;
+                 e.set_journal(std::move(path), config);
+             },
+             py::arg("path"), py::arg("snapshot_every") = 4096)
+        .def_property("session_utc_offset", &quant::Engine::session_utc_offset,
+                      &quant::Engine::set_session_utc_offset)
+        .def("set_flatten_at_close", &quant::Engine::set_flatten_at_close, py::arg("enabled"))
+        .def("run",
+             [](quant::Engine& e, const TimestampArray& timestamp, const InputArray& open,
+                const InputArray& high, const InputArray& low, const InputArray& close,
+                const InputArray& volume) {
+                 quant::BarColumns bars = bar_columns(timestamp, open, high, low, close, volume);
+                 py::gil_scoped_release release;
+                 return e.run_backtest(bars);
+             },
+             "Backtest over bar columns (timestamp in Unix seconds)",
+             py::arg("timestamp"), py::arg("open"), py::arg("high"), py::arg("low"),
+             py::arg("close"), py::arg("volume"))
+        .def("run",
+             [](quant::Engine& e, const quant::BarSeries& s) {
+                 py::gil_scoped_release release;
+                 return e.run_backtest(s.columns());
+             },
+             py::arg("series"))
+        .def("run",
+             [](quant::Engine& e, const std::string& symbol) {
+                 py::gil_scoped_release release;
+                 return e.run_backtest(symbol);
+             },
+             "Backtest a symbol loaded with load_data()", py::arg("symbol"))
+        .def_property("warmup_config", &quant::Engine::warmup_config,
+                      &quant::Engine::set_warmup_config)
+        .def("run_window",
+             [](quant::Engine& e, const std::string& symbol, size_t begin, size_t end) {
+                 py::gil_scoped_release release;
+                 return e.run_window(e.market_data().get_bars(symbol), begin, end);
+             },
+             "Backtest bars [begin, end) of a loaded symbol, warmed lazily on the bars before",
+             py::arg("symbol"), py::arg("begin"), py::arg("end"));
+
+    // Walk-forward validation
+    py::class_<quant::WalkForwardConfig>(m, "WalkForwardConfig")
+        .def(py::init([](size_t train_bars, size_t test_bars, size_t step_bars, bool anchored) {
+                 return quant::WalkForwardConfig{train_bars, test_bars, step_bars, anchored};
+             }),
+             py::arg("train_bars"), py::arg("test_bars"), py::arg("step_bars") = 0,
+             py::arg("anchored") = false)
+        .def_readwrite("train_bars", &quant::WalkForwardConfig::train_bars)
+        .def_readwrite("test_bars", &quant::WalkForwardConfig::test_bars)
+        .def_readwrite("step_bars", &quant::WalkForwardConfig::step_bars)
+        .def_readwrite("anchored", &quant::WalkForwardConfig::anchored);
+
+    py::class_<quant::WalkForwardResult>(m, "WalkForwardResult")
+        .def_property_readonly("train_begin",
+                               [](const quant::WalkForwardResult& r) { return r.window.train_begin; })
+        .def_property_readonly("test_begin",
+                               [](const quant::WalkForwardResult& r) { return r.window.test_begin; })
+        .def_property_readonly("test_end",
+                               [](const quant::WalkForwardResult& r) { return r.window.test_end; })
+        .def_readonly("train", &quant::WalkForwardResult::train)
+        .def_readonly("test", &quant::WalkForwardResult::test);
+
+    py::class_<quant::WalkForwardReport>(m, "WalkForwardReport")
+        .def_readonly("windows", &quant::WalkForwardReport::windows)
+        .def_readonly("combined_test", &quant::WalkForwardReport::combined_test)
+        .def_readonly("window_bars", &quant::WalkForwardReport::window_bars)
+        .def_readonly("threads", &quant::WalkForwardReport::threads)
+        .def_readonly("wall_ms", &quant::WalkForwardReport::wall_ms)
+        .def_readonly("bars_per_sec", &quant::WalkForwardReport::bars_per_sec);
+
+    m.def("walk_forward",
+          [](const quant::MarketDataManager& data, const std::string& symbol,
+             const quant::WalkForwardConfig& config, const quant::StrategyParams& params,
+             const quant::RiskConfig& risk, unsigned threads) {
+              quant::WalkForward walk(data.get_bars(symbol), config);
+              walk.set_risk_config(risk);
+              walk.set_session_utc_offset(data.utc_offset_seconds(symbol));
+              py::gil_scoped_release release;
+              return walk.run(params, threads);
+          },
+          "Train/test windows over a loaded symbol, in parallel, from indicator snapshots",
+          py::arg("data"), py::arg("symbol"), py::arg("config"),
+          py::arg("params") = quant::StrategyParams{},
+          py::arg("risk_config") = quant::DEFAULT_RISK_CONFIG,
+          py::arg("threads") = quant::ThreadPool::default_threads());
+
+    py::enum_<quant::Resampling>(m, "Resampling")
+        .value("TradeShuffle", quant::Resampling::TradeShuffle)
+        .value("TradeBootstrap", quant::Resampling::TradeBootstrap)
+        .value("ReturnBootstrap", quant::Resampling::ReturnBootstrap);
+
+    py::class_<quant::MonteCarloConfig>(m, "MonteCarloConfig")
+        .def(py::init<>())
+        .def_readwrite("paths", &quant::MonteCarloConfig::paths)
+        .def_readwrite("block_length", &quant::MonteCarloConfig::block_length)
+        .def_readwrite("path_length", &quant::MonteCarloConfig::path_length)
+        .def_readwrite("seed", &quant::MonteCarloConfig::seed);
+
+    // `values` is trade P&L (e.g. result.trades["pnl"]) for the trade methods,
+    // per-bar returns for ReturnBootstrap. Returns (final_return, max_drawdown),
+    // one entry per path, written into `out_return` / `out_drawdown` when given.
+    m.def("monte_carlo",
+          [](const InputArray& values, quant::Resampling method,
+             const quant::MonteCarloConfig& config, double capital, unsigned threads,
+             py::object out_return, py::object out_drawdown) {
+              auto in = as_span(values, "values");
+              auto ret = output_array(out_return, config.paths, {in});
+              auto dd = output_array(out_drawdown, config.paths,
+                                     {in, std::span<const double>(ret.data(), config.paths)});
+              quant::MonteCarloOut out{{ret.mutable_data(), config.paths},
+                                       {dd.mutable_data(), config.paths}};
+              {
+                  py::gil_scoped_release release;
+                  quant::MonteCarlo(config).run(method, in, capital, out, threads);
+              }
+              return py::make_tuple(ret, dd);
+          },
+          "Resampled paths (trade shuffle / bootstrap, block bootstrap of returns), in parallel",
+          py::arg("values"), py::arg("method"),
+          py::arg("config") = quant::MonteCarloConfig{},
+          py::arg("capital") = quant::INITIAL_CAPITAL,
+          py::arg("threads") = quant::ThreadPool::default_threads(),
+          py::arg("out_return") = py::none(), py::arg("out_drawdown") = py::none());
+
     // Features module
     py::module_ features = m.def_submodule("features", "Technical indicators");
-    
-    features.def("sma", &quant::sma,
+
+    features.def("simd_level",
+                 [] { return std::string(quant::simd_level_name(quant::simd_level())); },
+                 "Instruction set used by the batch kernels (scalar, avx2, avx512)");
+
+    // BarSeries overloads read the C++ columns in place (no list/array copy).
+    // NumPy overloads come next so arrays never fall through to the
+    // std::vector ones: they compute with the GIL released and, given `out`,
+    // write into a preallocated array instead of returning a new one.
+    features.def("sma",
+                 [](const quant::BarSeries& s, int period, const std::string& column) {
+                     return quant::sma(series_column(s, column), period);
+                 },
+                 py::arg("series"), py::arg("period"), py::arg("column") = "close");
+    features.def("sma",
+                 [](const InputArray& values, int period, py::object out) {
+                     return unary_feature(
+                         [](std::span<const double> x, int p, std::span<double> o) {
+                             quant::sma(x, p, o);
+                         },
+                         values, period, out);
+                 },
+                 py::arg("values"), py::arg("period"), py::arg("out") = py::none());
+    features.def("sma",
+                 [](const std::vector<double>& prices, int period) {
+                     return quant::sma(prices, period);
+                 },
                  "Simple Moving Average",
                  py::arg("prices"), py::arg("period"));
-    
-    features.def("ema", &quant::ema,
+
+    features.def("ema",
+                 [](const quant::BarSeries& s, int period, const std::string& column) {
+                     return quant::ema(series_column(s, column), period);
+                 },
+                 py::arg("series"), py::arg("period"), py::arg("column") = "close");
+    features.def("ema",
+                 [](const InputArray& values, int period, py::object out) {
+                     return unary_feature(
+                         [](std::span<const double> x, int p, std::span<double> o) {
+                             quant::ema(x, p, o);
+                         },
+                         values, period, out);
+                 },
+                 py::arg("values"), py::arg("period"), py::arg("out") = py::none());
+    features.def("ema",
+                 [](const std::vector<double>& prices, int period) {
+                     return quant::ema(prices, period);
+                 },
                  "Exponential Moving Average",
                  py::arg("prices"), py::arg("period"));
-    
-    features.def("rsi", &quant::rsi,
+
+    features.def("rsi",
+                 [](const quant::BarSeries& s, int period, const std::string& column) {
+                     return quant::rsi(series_column(s, column), period);
+                 },
+                 py::arg("series"), py::arg("period") = 14, py::arg("column") = "close");
+    features.def("rsi",
+                 [](const InputArray& values, int period, py::object out) {
+                     return unary_feature(
+                         [](std::span<const double> x, int p, std::span<double> o) {
+                             quant::rsi(x, p, o);
+                         },
+                         values, period, out);
+                 },
+                 py::arg("values"), py::arg("period") = 14, py::arg("out") = py::none());
+    features.def("rsi",
+                 [](const std::vector<double>& prices, int period) {
+                     return quant::rsi(prices, period);
+                 },
                  "Relative Strength Index",
                  py::arg("prices"), py::arg("period") = 14);
-    
-    features.def("atr", &quant::atr,
+
+    features.def("atr",
+                 [](const quant::BarSeries& s, int period) {
+                     return quant::atr(s, period);
+                 },
+                 py::arg("series"), py::arg("period") = 14);
+    features.def("atr",
+                 [](const InputArray& high, const InputArray& low,
+                    const InputArray& close, int period, py::object out) {
+                     auto h = as_span(high, "high");
+                     auto l = as_span(low, "low");
+                     auto c = as_span(close, "close");
+                     if (h.size() != c.size() || l.size() != c.size()) {
+                         throw std::invalid_argument("high, low and close differ in length");
+                     }
+                     auto result = output_array(out, c.size(), {h, l, c});
+                     std::span<double> dst(result.mutable_data(), c.size());
+                     {
+                         py::gil_scoped_release release;
+                         quant::atr(h, l, c, period, dst);
+                     }
+                     return result;
+                 },
+                 py::arg("high"), py::arg("low"), py::arg("close"), py::arg("period") = 14,
+                 py::arg("out") = py::none());
+    features.def("atr",
+                 [](const std::vector<double>& high, const std::vector<double>& low,
+                    const std::vector<double>& close, int period) {
+                     return quant::atr(high, low, close, period);
+                 },
                  "Average True Range",
                  py::arg("high"), py::arg("low"), py::arg("close"), py::arg("period") = 14);
-    
-    features.def("momentum", &quant::momentum,
+
+    features.def("momentum",
+                 [](const quant::BarSeries& s, int period, const std::string& column) {
+                     return quant::momentum(series_column(s, column), period);
+                 },
+                 py::arg("series"), py::arg("period"), py::arg("column") = "close");
+    features.def("momentum",
+                 [](const InputArray& values, int period, py::object out) {
+                     return unary_feature(
+                         [](std::span<const double> x, int p, std::span<double> o) {
+                             quant::momentum(x, p, o);
+                         },
+                         values, period, out);
+                 },
+                 py::arg("values"), py::arg("period"), py::arg("out") = py::none());
+    features.def("momentum",
+                 [](const std::vector<double>& prices, int period) {
+                     return quant::momentum(prices, period);
+                 },
                  "Momentum (Rate of Change)",
                  py::arg("prices"), py::arg("period"));
-    
-    features.def("rolling_std", &quant::rolling_std,
+
+    features.def("rolling_std",
+                 [](const InputArray& values, int period, py::object out) {
+                     return unary_feature(
+                         [](std::span<const double> x, int p, std::span<double> o) {
+                             quant::rolling_std(x, p, o);
+                         },
+                         values, period, out);
+                 },
+                 py::arg("values"), py::arg("period"), py::arg("out") = py::none());
+    features.def("rolling_std",
+                 [](const std::vector<double>& values, int period) {
+                     return quant::rolling_std(values, period);
+                 },
                  "Rolling Standard Deviation",
                  py::arg("values"), py::arg("period"));
-    
-    features.def("zscore", &quant::zscore,
+
+    features.def("zscore",
+                 [](const InputArray& values, int period, py::object out) {
+                     return unary_feature(
+                         [](std::span<const double> x, int p, std::span<double> o) {
+                             quant::zscore(x, p, o);
+                         },
+                         values, period, out);
+                 },
+                 py::arg("values"), py::arg("period"), py::arg("out") = py::none());
+    features.def("zscore",
+                 [](const std::vector<double>& values, int period) {
+                     return quant::zscore(values, period);
+                 },
                  "Z-Score",
                  py::arg("values"), py::arg("period"));
+
+    // Full features.py column set in one pass
+    py::class_<quant::FeatureConfig>(features, "FeatureConfig",
+                                     "Windows used by compute_features (features.py defaults)")
+        .def(py::init<>())
+        .def_readwrite("vol_short", &quant::FeatureConfig::vol_short)
+        .def_readwrite("vol_long", &quant::FeatureConfig::vol_long)
+        .def_readwrite("sma_short", &quant::FeatureConfig::sma_short)
+        .def_readwrite("sma_long", &quant::FeatureConfig::sma_long)
+        .def_readwrite("ema_periods", &quant::FeatureConfig::ema_periods)
+        .def_readwrite("rsi_period", &quant::FeatureConfig::rsi_period)
+        .def_readwrite("macd_fast", &quant::FeatureConfig::macd_fast)
+        .def_readwrite("macd_slow", &quant::FeatureConfig::macd_slow)
+        .def_readwrite("macd_signal", &quant::FeatureConfig::macd_signal)
+        .def_readwrite("momentum_periods", &quant::FeatureConfig::momentum_periods)
+        .def_readwrite("bb_period", &quant::FeatureConfig::bb_period)
+        .def_readwrite("bb_num_std", &quant::FeatureConfig::bb_num_std)
+        .def_readwrite("atr_period", &quant::FeatureConfig::atr_period)
+        .def_readwrite("zscore_period", &quant::FeatureConfig::zscore_period);
+
+    features.def("compute_features",
+                 [](const quant::BarSeries& s, const quant::FeatureConfig& config) {
+                     quant::FeatureFrame frame;
+                     {
+                         py::gil_scoped_release release;
+                         frame = quant::compute_features(s, config);
+                     }
+                     return feature_dict(std::move(frame));
+                 },
+                 py::arg("series"), py::arg("config") = quant::FeatureConfig{});
+    features.def("compute_features",
+                 [](const InputArray& open, const InputArray& high, const InputArray& low,
+                    const InputArray& close, const InputArray& volume,
+                    const quant::FeatureConfig& config) {
+                     auto o = as_span(open, "open");
+                     auto h = as_span(high, "high");
+                     auto l = as_span(low, "low");
+                     auto c = as_span(close, "close");
+                     auto v = as_span(volume, "volume");
+                     quant::FeatureFrame frame;
+                     {
+                         py::gil_scoped_release release;
+                         frame = quant::compute_features(o, h, l, c, v, config);
+                     }
+                     return feature_dict(std::move(frame));
+                 },
+                 "Every features.py column as {name: ndarray}; warm-up rows are NaN",
+                 py::arg("open"), py::arg("high"), py::arg("low"), py::arg("close"),
+                 py::arg("volume"), py::arg("config") = quant::FeatureConfig{});
 }
@@ -0,0 +1,241 @@
+#include "BarCache.hpp"
+#include "MappedFile.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <system_error>
+
+namespace quant {
+
+namespace {
+
+// Four independent multiply-xor lanes over 64-bit words: cheap enough to
+// verify hundreds of MB at memory bandwidth, strong enough to catch
+// truncation and corruption. Not cryptographic.
+class Checksum64 {
+public:
+  void update(const uint64_t *words, size_t n) {
+    for (size_t i = 0; i < n; ++i, ++index_) {
+      uint64_t &lane = lanes_[index_ & 3];
+      lane = (lane ^ words[i]) * 0x9E3779B97F4A7C15ULL;
+      lane ^= lane >> 29;
+    }
+  }
+
+  uint64_t digest() const {
+    uint64_t h = index_;
+    for (uint64_t lane : lanes_)
+      h = (h ^ lane) * 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 31);
+  }
+
+private:
+  uint64_t lanes_[4] = {0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL,
+                        0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL};
+  uint64_t index_ = 0;
+};
+
+size_t padded_column_bytes(uint64_t bar_count) {
+  size_t bytes = static_cast<size_t>(bar_count) * sizeof(double);
+  return (bytes + QBAR_ALIGNMENT - 1) / QBAR_ALIGNMENT * QBAR_ALIGNMENT;
+}
+
+template <typename T>
+const uint64_t *as_words(std::span<const T> column) {
+  static_assert(sizeof(T) == sizeof(uint64_t));
+  return reinterpret_cast<const uint64_t *>(column.data());
+}
+
+// "<cache>.<random hex>.tmp" next to the cache, so concurrent writers of
+// one cache never share a temp file and the final rename stays on one
+// filesystem.
+std::string unique_tmp_path(const std::string &cache_path) {
+  std::random_device device;
+  std::uniform_int_distribution<uint64_t> pick;
+  std::string path;
+  do {
+    char suffix[22];
+    std::snprintf(suffix, sizeof(suffix), ".%016llx.tmp",
+                  static_cast<unsigned long long>(pick(device)));
+    path = cache_path + suffix;
+  } while (std::filesystem::exists(path));
+  return path;
+}
+
+// A mapped, validated .qbar: the header plus typed pointers to its columns.
+// Sections are 64-byte aligned relative to a page-aligned mapping, so the
+// columns can be read as typed arrays directly.
+struct QBarView {
+  QBarHeader header;
+  const char *base = nullptr;
+
+  size_t size() const { return static_cast<size_t>(header.bar_count); }
+  template <typename T = double> const T *column(size_t col) const {
+    return reinterpret_cast<const T *>(base + col * header.column_stride);
+  }
+};
+
+// Schema and size checks only; offset, source size and checksum are left to
+// the caller.
+bool map_qbar(const std::string &cache_path, MappedFile &file,
+              QBarView &view) {
+  if (!file.open(cache_path) || file.size() < sizeof(QBarHeader))
+    return false;
+  std::memcpy(&view.header, file.data(), sizeof(QBarHeader));
+  const QBarHeader &header = view.header;
+  if (header.magic != QBAR_MAGIC || header.version != QBAR_VERSION ||
+      header.column_stride != padded_column_bytes(header.bar_count) ||
+      file.size() != sizeof(QBarHeader) + QBAR_COLUMNS * header.column_stride)
+    return false;
+  view.base = file.data() + sizeof(QBarHeader);
+  return true;
+}
+
+// map_qbar() plus the offset / source-size match and the checksum pass.
+bool map_verified_qbar(const std::string &cache_path,
+                       int64_t expected_utc_offset,
+                       uint64_t expected_source_size, MappedFile &file,
+                       QBarView &view) {
+  if (!map_qbar(cache_path, file, view) ||
+      view.header.utc_offset != expected_utc_offset ||
+      view.header.source_size != expected_source_size)
+    return false;
+  Checksum64 checksum;
+  for (size_t col = 0; col < QBAR_COLUMNS; ++col)
+    checksum.update(view.column<uint64_t>(col), view.size());
+  return checksum.digest() == view.header.checksum;
+}
+
+void copy_columns(const QBarView &view, BarSeries &series) {
+  BarSeries loaded;
+  loaded.resize(view.size());
+  const size_t column_bytes = view.size() * sizeof(uint64_t);
+  std::memcpy(loaded.mutable_timestamps().data(), view.column(0),
+              column_bytes);
+  std::memcpy(loaded.mutable_open().data(), view.column(1), column_bytes);
+  std::memcpy(loaded.mutable_high().data(), view.column(2), column_bytes);
+  std::memcpy(loaded.mutable_low().data(), view.column(3), column_bytes);
+  std::memcpy(loaded.mutable_close().data(), view.column(4), column_bytes);
+  std::memcpy(loaded.mutable_volume().data(), view.column(5), column_bytes);
+  series = std::move(loaded);
+}
+
+} // namespace
+
+std::string qbar_path_for(const std::string &csv_path) {
+  return csv_path + ".qbar";
+}
+
+bool qbar_is_fresh(const std::string &cache_path,
+                   const std::string &source_path) {
+  std::error_code ec;
+  auto cache_time = std::filesystem::last_write_time(cache_path, ec);
+  if (ec)
+    return false;
+  auto source_time = std::filesystem::last_write_time(source_path, ec);
+  if (ec)
+    return false;
+  return cache_time >= source_time;
+}
+
+bool write_qbar(const std::string &cache_path, const BarSeries &series,
+                int64_t utc_offset, uint64_t source_size) {
+  const std::string tmp_path = unique_tmp_path(cache_path);
+  std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open())
+    return false;
+
+  const size_t n = series.size();
+  QBarHeader header{};
+  header.magic = QBAR_MAGIC;
+  header.version = QBAR_VERSION;
+  header.bar_count = n;
+  header.utc_offset = utc_offset;
+  header.source_size = source_size;
+  header.column_stride = padded_column_bytes(n);
+
+  const uint64_t *columns[QBAR_COLUMNS] = {
+      as_words(series.timestamps()), as_words(series.open()),
+      as_words(series.high()),       as_words(series.low()),
+      as_words(series.close()),      as_words(series.volume())};
+
+  Checksum64 checksum;
+  for (const uint64_t *column : columns)
+    checksum.update(column, n);
+  header.checksum = checksum.digest();
+
+  const char zeros[QBAR_ALIGNMENT] = {};
+  const size_t column_bytes = n * sizeof(uint64_t);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (const uint64_t *column : columns) {
+    out.write(reinterpret_cast<const char *>(column),
+              static_cast<std::streamsize>(column_bytes));
+    out.write(zeros, static_cast<std::streamsize>(header.column_stride -
+                                                  column_bytes));
+  }
+  out.close();
+  if (!out) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, cache_path, ec);
+  if (ec) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool read_qbar(const std::string &cache_path, int64_t expected_utc_offset,
+               uint64_t expected_source_size, BarSeries &series) {
+  MappedFile file;
+  QBarView view;
+  if (!map_verified_qbar(cache_path, expected_utc_offset,
+                         expected_source_size, file, view))
+    return false;
+  copy_columns(view, series);
+  return true;
+}
+
+bool read_qbar(const std::string &cache_path, int64_t expected_utc_offset,
+               uint64_t expected_source_size, std::vector<Bar> &bars,
+               QBarHeader *header) {
+  MappedFile file;
+  QBarView view;
+  if (!map_verified_qbar(cache_path, expected_utc_offset,
+                         expected_source_size, file, view))
+    return false;
+
+  // One pass: each row gathers its six fields straight from the mapping
+  const size_t n = view.size();
+  const int64_t *timestamp = view.column<int64_t>(0);
+  const double *open = view.column(1), *high = view.column(2),
+               *low = view.column(3), *close = view.column(4),
+               *volume = view.column(5);
+  std::vector<Bar> loaded;
+  loaded.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+    loaded.emplace_back(timestamp[i], open[i], high[i], low[i], close[i],
+                        volume[i]);
+  bars = std::move(loaded);
+  if (header != nullptr)
+    *header = view.header;
+  return true;
+}
+
+bool reread_qbar(const std::string &cache_path, const QBarHeader &verified,
+                 BarSeries &series) {
+  MappedFile file;
+  QBarView view;
+  if (!map_qbar(cache_path, file, view) ||
+      std::memcmp(&view.header, &verified, sizeof(QBarHeader)) != 0)
+    return false;
+  copy_columns(view, series);
+  return true;
+}
+
+} // namespace quant
@@ -0,0 +1,132 @@
+#include "MappedFile.hpp"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace quant {
+
+MappedFile::MappedFile(MappedFile &&other) noexcept { *this = std::move(other); }
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    is_open_ = std::exchange(other.is_open_, false);
+#ifdef _WIN32
+    file_handle_ = std::exchange(other.file_handle_, nullptr);
+    mapping_handle_ = std::exchange(other.mapping_handle_, nullptr);
+#endif
+  }
+  return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &filepath) {
+  close();
+  HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    return false;
+  }
+
+  file_handle_ = file;
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  is_open_ = true;
+  if (size_ == 0)
+    return true; // Zero-length files cannot be mapped
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0,
+                                      nullptr);
+  if (mapping == nullptr) {
+    close();
+    return false;
+  }
+  mapping_handle_ = mapping;
+
+  void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr) {
+    close();
+    return false;
+  }
+  data_ = static_cast<const char *>(view);
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_ != nullptr)
+    UnmapViewOfFile(data_);
+  if (mapping_handle_ != nullptr)
+    CloseHandle(static_cast<HANDLE>(mapping_handle_));
+  if (file_handle_ != nullptr)
+    CloseHandle(static_cast<HANDLE>(file_handle_));
+  data_ = nullptr;
+  mapping_handle_ = nullptr;
+  file_handle_ = nullptr;
+  size_ = 0;
+  is_open_ = false;
+}
+
+#else
+
+bool MappedFile::open(const std::string &filepath) {
+  close();
+  int fd = ::open(filepath.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    return false;
+  }
+
+  size_ = static_cast<size_t>(st.st_size);
+  is_open_ = true;
+  if (size_ == 0) {
+    ::close(fd); // Zero-length files cannot be mapped
+    return true;
+  }
+
+  void *addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // The mapping keeps its own reference to the file
+  if (addr == MAP_FAILED) {
+    size_ = 0;
+    is_open_ = false;
+    return false;
+  }
+
+  // Loaders scan front to back once; let the kernel read ahead aggressively.
+  ::madvise(addr, size_, MADV_SEQUENTIAL);
+  data_ = static_cast<const char *>(addr);
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_ != nullptr)
+    ::munmap(const_cast<char *>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+  is_open_ = false;
+}
+
+#endif
+
+} // namespace quant
@@ -1,10 +1,17 @@
 #include "MarketDataManager.hpp"
+#include "BarCache.hpp"
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+#include "TimeUtils.hpp"
 #include <algorithm>
-#include <ctime>
-#include <fstream>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
 #include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <string_view>
 
 
 namespace quant {
@@ -13,112 +20,412 @@ MarketDataManager::MarketDataManager() {}
 
 MarketDataManager::~MarketDataManager() {}
 
-// Helper to parse timestamp strings like "2024-01-01 09:15:00" or simple Unix
-// ints
-int64_t parse_time(const std::string &time_str) {
-  // Try to parse as integer first (Unix timestamp)
-  try {
-    if (std::all_of(time_str.begin(), time_str.end(), ::isdigit)) {
-      return std::stoll(time_str);
+namespace {
+
+// Bytes a load actually read: the .qbar on a cache hit, else the CSV.
+uint64_t bytes_read(const std::string &filepath, bool from_cache,
+                    uint64_t source_size) {
+  if (!from_cache)
+    return source_size;
+  std::error_code ec;
+  const uint64_t size =
+      std::filesystem::file_size(qbar_path_for(filepath), ec);
+  return ec ? 0 : size;
+}
+
+// Trim spaces/tabs (and the '\r' of CRLF files) from both ends of a field.
+std::string_view trim_field(std::string_view field) {
+  while (!field.empty() && (field.front() == ' ' || field.front() == '\t'))
+    field.remove_prefix(1);
+  while (!field.empty() && (field.back() == ' ' || field.back() == '\t' ||
+                            field.back() == '\r'))
+    field.remove_suffix(1);
+  return field;
+}
+
+bool parse_double(std::string_view field, double &out) {
+  field = trim_field(field);
+  if (!field.empty() && field.front() == '+') // from_chars rejects '+'
+    field.remove_prefix(1);
+  if (field.empty())
+    return false;
+  auto [ptr, ec] =
+      std::from_chars(field.data(), field.data() + field.size(), out);
+  return ec == std::errc() && ptr == field.data() + field.size();
+}
+
+// Parse one CSV row in place. Columns: Date, Open, High, Low, Close, Volume;
+// any extra columns are ignored. Returns false for short or malformed rows.
+bool parse_row(std::string_view line, int64_t utc_offset, Bar &bar) {
+  std::string_view fields[6];
+  size_t n_fields = 0;
+  size_t pos = 0;
+  while (n_fields < 6) {
+    size_t comma = line.find(',', pos);
+    if (comma == std::string_view::npos) {
+      fields[n_fields++] = line.substr(pos);
+      break;
     }
-  } catch (...) {
+    fields[n_fields++] = line.substr(pos, comma - pos);
+    pos = comma + 1;
   }
+  if (n_fields < 6)
+    return false;
+
+  return parse_timestamp(trim_field(fields[0]), utc_offset, bar.timestamp) &&
+         parse_double(fields[1], bar.open) &&
+         parse_double(fields[2], bar.high) &&
+         parse_double(fields[3], bar.low) &&
+         parse_double(fields[4], bar.close) &&
+         parse_double(fields[5], bar.volume);
+}
+
+// Scan a mapped CSV into bars. Rows that fail to parse are skipped.
+void parse_csv(const MappedFile &file, int64_t utc_offset,
+               std::vector<Bar> &bars) {
+  const char *cursor = file.data();
+  const char *const end = file.data() + file.size();
+
+  // Returns the next line (without '\n') and advances the cursor past it.
+  auto next_line = [&cursor, end]() {
+    const char *nl = static_cast<const char *>(
+        std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+    const char *line_end = nl ? nl : end;
+    std::string_view line(cursor, static_cast<size_t>(line_end - cursor));
+    cursor = nl ? nl + 1 : end;
+    return line;
+  };
 
-  // Fallback: Parse "YYYY-MM-DD HH:MM:SS"
-  // Note: This is a basic implementation. For high speed, use strptime or
-  // custom parser.
-  std::tm tm = {};
-  std::istringstream ss(time_str);
-  ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-  if (ss.fail()) {
-    // Try just date
-    ss.clear();
-    ss.str(time_str);
-    ss >> std::get_time(&tm, "%Y-%m-%d");
+  // Skip header
+  if (cursor < end) {
+    const char *first_line_start = cursor;
+    std::string_view line = next_line();
+    // Simple check if it's a header
+    if (line.find("timestamp") == std::string_view::npos &&
+        line.find("Date") == std::string_view::npos &&
+        !(line.empty() || std::isalpha(static_cast<unsigned char>(line[0])))) {
+      // No header? Reset to beginning
+      cursor = first_line_start;
+    } else if (cursor < end) {
+      // Size the vector from the first data row so the parse loop never
+      // reallocates on well-formed files.
+      const char *probe = static_cast<const char *>(
+          std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+      size_t row_bytes =
+          probe ? static_cast<size_t>(probe - cursor) + 1 : file.size();
+      bars.reserve(static_cast<size_t>(end - cursor) / row_bytes + 16);
+    }
   }
+  if (bars.capacity() == 0)
+    bars.reserve(100000); // Reserve generic size to minimize realloc
 
-  // std::mktime assumes local time, strictly speaking we want UTC, but for
-  // relative backtests it's fine. Ideally use _mkgmtime (Windows) or timegm
-  // (Linux)
-  return std::mktime(&tm);
+  while (cursor < end) {
+    std::string_view line = next_line();
+    if (line.empty() || line == "\r")
+      continue;
+
+    Bar bar;
+    if (parse_row(line, utc_offset, bar)) {
+      bars.push_back(bar);
+    }
+    // else: Data parse error, skip the row
+  }
+}
+
+} // namespace
+
+SymbolId MarketDataManager::intern(const std::string &symbol) {
+  auto [it, added] =
+      ids_.try_emplace(symbol, static_cast<SymbolId>(store_.size()));
+  if (added)
+    store_.emplace_back().symbol = symbol;
+  return it->second;
+}
+
+SymbolId MarketDataManager::symbol_id(const std::string &symbol) const {
+  auto it = ids_.find(symbol);
+  return it != ids_.end() ? it->second : NO_SYMBOL;
+}
+
+void MarketDataManager::set_utc_offset(const std::string &symbol,
+                                       int64_t offset_seconds) {
+  store_[intern(symbol)].utc_offset = offset_seconds;
+}
+
+int64_t MarketDataManager::utc_offset_seconds(const std::string &symbol) const {
+  SymbolId id = symbol_id(symbol);
+  return id != NO_SYMBOL ? store_[id].utc_offset : 0;
+}
+
+void MarketDataManager::add_bars(const std::string &symbol,
+                                 std::vector<Bar> bars) {
+  SymbolSlot &slot = store_[intern(symbol)];
+  SymbolData data;
+  data.sessions = SessionIndex::from_bars(bars, slot.utc_offset);
+  data.bars = std::move(bars);
+  store_data(slot, std::move(data));
+}
+
+void MarketDataManager::store_data(SymbolSlot &slot, SymbolData data) {
+  static_cast<SymbolData &>(slot) = std::move(data);
+  std::lock_guard<std::mutex> lock(slot.series_mutex);
+  slot.series.reset();
 }
 
 const std::vector<Bar> &
 MarketDataManager::get_bars(const std::string &symbol) const {
   static const std::vector<Bar> empty;
-  auto it = data_store_.find(symbol);
-  if (it != data_store_.end()) {
-    return it->second;
+  SymbolId id = symbol_id(symbol);
+  return id != NO_SYMBOL ? store_[id].bars : empty;
+}
+
+const SessionIndex &
+MarketDataManager::get_sessions(const std::string &symbol) const {
+  static const SessionIndex empty;
+  SymbolId id = symbol_id(symbol);
+  return id != NO_SYMBOL ? store_[id].sessions : empty;
+}
+
+const BarSeries &
+MarketDataManager::get_series(const std::string &symbol) const {
+  static const BarSeries empty;
+  SymbolId id = symbol_id(symbol);
+  return id != NO_SYMBOL ? get_series(id) : empty;
+}
+
+const BarSeries &MarketDataManager::get_series(SymbolId id) const {
+  const SymbolSlot &slot = store_[id];
+  std::lock_guard<std::mutex> lock(slot.series_mutex);
+  if (!slot.series) {
+    // Straight from the mapped cache when the rows came from one (and it
+    // is still that file), else a gather from the rows
+    BarSeries series;
+    if (slot.cache_path.empty() ||
+        !reread_qbar(slot.cache_path, slot.cache_header, series))
+      series = BarSeries::from_bars(slot.bars);
+    slot.series = std::make_unique<const BarSeries>(std::move(series));
   }
-  return empty;
+  return *slot.series;
 }
 
-bool MarketDataManager::load_csv(const std::string &symbol,
-                                 const std::string &filepath) {
-  std::ifstream file(filepath);
-  if (!file.is_open()) {
-    std::cerr << "❌ Error: Could not open file " << filepath << std::endl;
+bool MarketDataManager::read_symbol_file(const std::string &symbol,
+                                         const std::string &filepath,
+                                         int64_t utc_offset, SymbolData &data,
+                                         uint64_t &source_size,
+                                         bool &from_cache,
+                                         std::string &error) const {
+  std::error_code ec;
+  source_size = std::filesystem::file_size(filepath, ec);
+  if (ec) {
+    error = "❌ Error: Could not open file " + filepath;
     return false;
   }
 
-  std::vector<Bar> bars;
-  bars.reserve(100000); // Reserve generic size to minimize realloc
+  const std::string cache_path = qbar_path_for(filepath);
+  std::vector<Bar> &bars = data.bars;
 
-  std::string line;
-  // Skip header
-  if (std::getline(file, line)) {
-    // Simple check if it's a header
-    if (line.find("timestamp") == std::string::npos &&
-        line.find("Date") == std::string::npos && !std::isalpha(line[0])) {
-      // No header? Reset to beginning
-      file.clear();
-      file.seekg(0);
+  // Reuse the binary cache when it was built from this exact source; the
+  // CSV itself is then never touched. The rows are filled straight from
+  // the mapped columns.
+  from_cache = cache_enabled_ && qbar_is_fresh(cache_path, filepath) &&
+               read_qbar(cache_path, utc_offset, source_size, bars,
+                         &data.cache_header);
+  if (from_cache) {
+    data.cache_path = cache_path;
+  } else {
+    MappedFile file(filepath);
+    if (!file.is_open()) {
+      error = "❌ Error: Could not open file " + filepath;
+      return false;
     }
+    parse_csv(file, utc_offset, bars);
   }
 
-  while (std::getline(file, line)) {
-    if (line.empty())
-      continue;
+  if (bars.empty()) {
+    error = " Warning: No bars loaded for " + symbol;
+    return false;
+  }
+  data.sessions = SessionIndex::from_bars(bars, utc_offset);
+  return true;
+}
 
-    std::stringstream ss(line);
-    std::string segment;
-    std::vector<std::string> row;
+bool MarketDataManager::write_symbol_cache(const std::string &filepath,
+                                           const SymbolData &data,
+                                           int64_t utc_offset,
+                                           uint64_t source_size,
+                                           std::string &warning) {
+  const std::string cache_path = qbar_path_for(filepath);
+  if (write_qbar(cache_path, BarSeries::from_bars(data.bars), utc_offset,
+                 source_size))
+    return true;
+  warning = " Warning: Could not write bar cache " + cache_path;
+  return false;
+}
 
-    while (std::getline(ss, segment, ',')) {
-      row.push_back(segment);
-    }
+bool MarketDataManager::load_csv(const std::string &symbol,
+                                 const std::string &filepath) {
+  auto start_time = std::chrono::high_resolution_clock::now();
 
-    if (row.size() < 6)
-      continue;
+  SymbolData data;
+  uint64_t source_size = 0;
+  bool from_cache = false;
+  std::string error;
+  const int64_t utc_offset = utc_offset_seconds(symbol);
+  if (!read_symbol_file(symbol, filepath, utc_offset, data, source_size,
+                        from_cache, error)) {
+    std::cerr << error << std::endl;
+    return false;
+  }
+  if (!from_cache && cache_enabled_ &&
+      !write_symbol_cache(filepath, data, utc_offset, source_size, error))
+    std::cerr << error << std::endl;
 
-    try {
-      Bar bar;
-      // Assumption: Columns are Date, Open, High, Low, Close, Volume
-      // Adjust based on your specific CSV format if needed
-      bar.timestamp = parse_time(row[0]);
-      bar.open = std::stod(row[1]);
-      bar.high = std::stod(row[2]);
-      bar.low = std::stod(row[3]);
-      bar.close = std::stod(row[4]);
-      bar.volume = std::stod(row[5]);
+  auto end_time = std::chrono::high_resolution_clock::now();
+  double duration_ms =
+      std::chrono::duration_cast<std::chrono::microseconds>(end_time -
+                                                            start_time)
+          .count() /
+      1000.0;
+  double size_mb = source_size / (1024.0 * 1024.0);
+  double read_mb = bytes_read(filepath, from_cache, source_size) /
+                   (1024.0 * 1024.0);
+  double mb_per_sec = duration_ms > 0 ? read_mb / duration_ms * 1000.0 : 0.0;
 
-      bars.push_back(bar);
-    } catch (const std::exception &e) {
-      // std::cerr << "Data parse error: " << e.what() << " on line: " << line
-      // << std::endl;
-      continue;
+  SymbolSlot &slot = store_[intern(symbol)];
+  store_data(slot, std::move(data));
+  std::cout << " Loaded " << slot.bars.size() << " bars for " << symbol
+            << (from_cache ? " (cache)" : "") << std::endl;
+
+  std::ios state(nullptr);
+  state.copyfmt(std::cout);
+  // MB/s is over the bytes read: the cache's on a hit, not the CSV's
+  std::cout << "[BENCHMARK] " << std::fixed << std::setprecision(1);
+  if (from_cache)
+    std::cout << "Mapped " << read_mb << " MB .qbar (" << size_mb
+              << " MB CSV)";
+  else
+    std::cout << "Parsed " << size_mb << " MB";
+  std::cout << " in " << std::setprecision(3) << duration_ms << " ms ("
+            << std::setprecision(1) << mb_per_sec << " MB/s)\n";
+  std::cout.copyfmt(state);
+  return true;
+}
+
+LoadReport MarketDataManager::load_files(
+    const std::vector<std::pair<std::string, std::string>> &files,
+    unsigned num_threads) {
+  auto start_time = std::chrono::high_resolution_clock::now();
+
+  LoadReport report;
+  report.files = files.size();
+  report.threads = std::max(
+      1u, num_threads ? num_threads : ThreadPool::default_threads());
+
+  // Intern on this thread first: workers then only write their own slot,
+  // and the store never grows while they run.
+  struct Job {
+    SymbolId id;
+    bool duplicate;
+    bool ok = false;
+    bool from_cache = false;
+    uint64_t bytes = 0;
+    uint64_t read_bytes = 0;
+    std::string error;
+  };
+  std::vector<Job> jobs;
+  jobs.reserve(files.size());
+  std::vector<bool> claimed;
+  for (const auto &[symbol, path] : files) {
+    SymbolId id = intern(symbol);
+    if (claimed.size() <= id)
+      claimed.resize(id + 1, false);
+    jobs.push_back({id, claimed[id], false, false, 0, 0, {}});
+    claimed[id] = true;
+  }
+
+  {
+    ThreadPool pool(std::min<size_t>(report.threads,
+                                     std::max<size_t>(1, files.size())));
+    pool.parallel_for(jobs.size(), [&](size_t i) {
+      Job &job = jobs[i];
+      if (job.duplicate) {
+        job.error = " Warning: Duplicate symbol " + files[i].first +
+                    ", skipped " + files[i].second;
+        return;
+      }
+      SymbolSlot &slot = store_[job.id];
+      SymbolData data;
+      job.ok = read_symbol_file(files[i].first, files[i].second,
+                                slot.utc_offset, data, job.bytes,
+                                job.from_cache, job.error);
+      if (!job.ok)
+        return;
+      job.read_bytes = bytes_read(files[i].second, job.from_cache, job.bytes);
+      // A failed cache write is only a warning; job.error carries it
+      if (!job.from_cache && cache_enabled_)
+        write_symbol_cache(files[i].second, data, slot.utc_offset, job.bytes,
+                           job.error);
+      store_data(slot, std::move(data));
+    });
+  }
+
+  // Messages are printed here, in file order, never from the workers
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    const Job &job = jobs[i];
+    if (job.ok) {
+      ++report.loaded;
+      report.from_cache += job.from_cache;
+      report.bytes += job.bytes;
+      report.read_bytes += job.read_bytes;
+    } else {
+      report.failed.push_back(files[i].first);
     }
+    if (!job.error.empty())
+      std::cerr << job.error << std::endl;
   }
 
-  if (bars.empty()) {
-    std::cerr << " Warning: No bars loaded for " << symbol << std::endl;
-    return false;
+  auto end_time = std::chrono::high_resolution_clock::now();
+  report.wall_ms = std::chrono::duration_cast<std::chrono::microseconds>(
+                       end_time - start_time)
+                       .count() /
+                   1000.0;
+  double size_mb = report.bytes / (1024.0 * 1024.0);
+  double read_mb = report.read_bytes / (1024.0 * 1024.0);
+  if (report.wall_ms > 0)
+    report.mb_per_sec = read_mb / report.wall_ms * 1000.0;
+
+  std::ios state(nullptr);
+  state.copyfmt(std::cout);
+  std::cout << "[BENCHMARK] Loaded " << report.loaded << "/" << report.files
+            << " files (" << report.from_cache << " cached), " << std::fixed
+            << std::setprecision(1) << size_mb << " MB (" << read_mb
+            << " MB read) on " << report.threads
+            << " threads in " << std::setprecision(3) << report.wall_ms
+            << " ms (" << std::setprecision(1) << report.mb_per_sec
+            << " MB/s)\n";
+  std::cout.copyfmt(state);
+  return report;
+}
+
+std::vector<std::pair<std::string, std::string>>
+MarketDataManager::list_csv_files(const std::string &directory) {
+  std::vector<std::pair<std::string, std::string>> files;
+  std::error_code ec;
+  for (const auto &entry :
+       std::filesystem::directory_iterator(directory, ec)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".csv")
+      files.emplace_back(entry.path().stem().string(), entry.path().string());
   }
+  if (ec)
+    std::cerr << "❌ Error: Could not read directory " << directory
+              << std::endl;
+  std::sort(files.begin(), files.end());
+  return files;
+}
 
-  data_store_[symbol] = std::move(bars);
-  std::cout << " Loaded " << data_store_[symbol].size() << " bars for "
-            << symbol << std::endl;
-  return true;
+LoadReport MarketDataManager::load_directory(const std::string &directory,
+                                             unsigned num_threads) {
+  return load_files(list_csv_files(directory), num_threads);
 }
 
 } // namespace quant
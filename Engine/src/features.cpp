@@ -1,36 +1,43 @@
 #include "features.hpp"
+#include "FeatureKernels.hpp"
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <stdexcept>
 
 namespace quant {
 
-std::vector<double> sma(const std::vector<double>& prices, int period) {
-    std::vector<double> result(prices.size(), std::nan(""));
-    
-    if (prices.size() < static_cast<size_t>(period)) {
-        return result;
-    }
-    
-    double sum = 0.0;
-    for (int i = 0; i < period; ++i) {
-        sum += prices[i];
-    }
-    result[period - 1] = sum / period;
+namespace {
+
+void fill_nan(std::span<double> out) {
+    std::fill(out.begin(), out.end(), std::nan(""));
+}
+
+} // namespace
+
+void sma(std::span<const double> prices, int period, std::span<double> out) {
+    fill_nan(out);
     
-    for (size_t i = period; i < prices.size(); ++i) {
-        sum = sum - prices[i - period] + prices[i];
-        result[i] = sum / period;
+    if (period <= 0 || out.size() != prices.size() ||
+        prices.size() < static_cast<size_t>(period)) {
+        return;
     }
     
+    kernels::rolling_mean(prices.data(), prices.size(), period, out.data());
+}
+
+std::vector<double> sma(std::span<const double> prices, int period) {
+    std::vector<double> result(prices.size());
+    sma(prices, period, result);
     return result;
 }
 
-std::vector<double> ema(const std::vector<double>& prices, int period) {
-    std::vector<double> result(prices.size(), std::nan(""));
+void ema(std::span<const double> prices, int period, std::span<double> out) {
+    fill_nan(out);
     
-    if (prices.size() < static_cast<size_t>(period)) {
-        return result;
+    if (period <= 0 || out.size() != prices.size() ||
+        prices.size() < static_cast<size_t>(period)) {
+        return;
     }
     
     double alpha = 2.0 / (period + 1.0);
@@ -39,169 +46,469 @@ std::vector<double> ema(const std::vector<double>& prices, int period) {
     for (size_t i = 1; i < prices.size(); ++i) {
         ema_value = alpha * prices[i] + (1 - alpha) * ema_value;
         if (i >= static_cast<size_t>(period - 1)) {
-            result[i] = ema_value;
+            out[i] = ema_value;
         }
     }
-    
+}
+
+std::vector<double> ema(std::span<const double> prices, int period) {
+    std::vector<double> result(prices.size());
+    ema(prices, period, result);
     return result;
 }
 
-std::vector<double> rsi(const std::vector<double>& prices, int period) {
-    std::vector<double> result(prices.size(), std::nan(""));
-    
-    if (prices.size() < static_cast<size_t>(period + 1)) {
-        return result;
+namespace {
+
+// rsi/atr feed their element-wise step (gain/loss split, true range) through
+// the SIMD kernels one cache-sized chunk at a time instead of materializing
+// n-sized temporaries; the Wilder recursion then runs scalar over the chunk.
+constexpr size_t KERNEL_CHUNK = 2048;
+
+double rsi_value(double avg_gain, double avg_loss) {
+    if (avg_loss == 0.0) {
+        return 100.0;
     }
+    double rs = avg_gain / avg_loss;
+    return 100.0 - (100.0 / (1.0 + rs));
+}
+
+} // namespace
+
+void rsi(std::span<const double> prices, int period, std::span<double> out) {
+    fill_nan(out);
     
-    std::vector<double> gains, losses;
-    for (size_t i = 1; i < prices.size(); ++i) {
-        double change = prices[i] - prices[i - 1];
-        gains.push_back(change > 0 ? change : 0.0);
-        losses.push_back(change < 0 ? -change : 0.0);
+    if (period <= 0 || out.size() != prices.size() ||
+        prices.size() < static_cast<size_t>(period + 1)) {
+        return;
     }
     
+    const size_t p = static_cast<size_t>(period);
+    const double alpha = 1.0 / period;
     double avg_gain = 0.0, avg_loss = 0.0;
-    for (int i = 0; i < period; ++i) {
-        avg_gain += gains[i];
-        avg_loss += losses[i];
-    }
-    avg_gain /= period;
-    avg_loss /= period;
+    double gains[KERNEL_CHUNK], losses[KERNEL_CHUNK];
     
-    if (avg_loss == 0.0) {
-        result[period] = 100.0;
-    } else {
-        double rs = avg_gain / avg_loss;
-        result[period] = 100.0 - (100.0 / (1.0 + rs));
-    }
-    
-    // Wilder's smoothing
-    double alpha = 1.0 / period;
-    for (size_t i = period + 1; i < prices.size(); ++i) {
-        avg_gain = alpha * gains[i - 1] + (1 - alpha) * avg_gain;
-        avg_loss = alpha * losses[i - 1] + (1 - alpha) * avg_loss;
+    // Change i = prices[i] - prices[i - 1], for i in [1, n)
+    for (size_t start = 1; start < prices.size(); start += KERNEL_CHUNK) {
+        size_t len = std::min(KERNEL_CHUNK, prices.size() - start);
+        kernels::gain_loss(prices.data() + start - 1, len + 1, gains, losses);
         
-        if (avg_loss == 0.0) {
-            result[i] = 100.0;
-        } else {
-            double rs = avg_gain / avg_loss;
-            result[i] = 100.0 - (100.0 / (1.0 + rs));
+        for (size_t j = 0; j < len; ++j) {
+            size_t i = start + j;
+            if (i <= p) {
+                // Seed: simple average of the first `period` changes
+                avg_gain += gains[j];
+                avg_loss += losses[j];
+                if (i == p) {
+                    avg_gain /= period;
+                    avg_loss /= period;
+                    out[p] = rsi_value(avg_gain, avg_loss);
+                }
+            } else {
+                // Wilder's smoothing
+                avg_gain = alpha * gains[j] + (1 - alpha) * avg_gain;
+                avg_loss = alpha * losses[j] + (1 - alpha) * avg_loss;
+                out[i] = rsi_value(avg_gain, avg_loss);
+            }
         }
     }
-    
+}
+
+std::vector<double> rsi(std::span<const double> prices, int period) {
+    std::vector<double> result(prices.size());
+    rsi(prices, period, result);
     return result;
 }
 
-std::vector<double> atr(
-    const std::vector<double>& high,
-    const std::vector<double>& low,
-    const std::vector<double>& close,
-    int period) {
+void atr(
+    std::span<const double> high,
+    std::span<const double> low,
+    std::span<const double> close,
+    int period,
+    std::span<double> out) {
     
-    std::vector<double> result(close.size(), std::nan(""));
+    fill_nan(out);
     
-    if (high.size() != low.size() || high.size() != close.size() ||
+    if (period <= 0 || high.size() != low.size() ||
+        high.size() != close.size() || out.size() != close.size() ||
         high.size() < static_cast<size_t>(period + 1)) {
-        return result;
+        return;
     }
     
-    std::vector<double> true_ranges;
-    for (size_t i = 1; i < high.size(); ++i) {
-        double tr1 = high[i] - low[i];
-        double tr2 = std::abs(high[i] - close[i - 1]);
-        double tr3 = std::abs(low[i] - close[i - 1]);
-        true_ranges.push_back(std::max({tr1, tr2, tr3}));
-    }
-    
-    // Calculate initial ATR
+    const size_t p = static_cast<size_t>(period);
+    const double alpha = 1.0 / period;
     double atr_value = 0.0;
-    for (int i = 0; i < period; ++i) {
-        atr_value += true_ranges[i];
-    }
-    atr_value /= period;
-    result[period] = atr_value;
+    double true_ranges[KERNEL_CHUNK];
     
-    // Wilder's smoothing
-    double alpha = 1.0 / period;
-    for (size_t i = period; i < true_ranges.size(); ++i) {
-        atr_value = alpha * true_ranges[i] + (1 - alpha) * atr_value;
-        result[i + 1] = atr_value;
+    // True range of bar i uses close[i - 1], for i in [1, n)
+    for (size_t start = 1; start < high.size(); start += KERNEL_CHUNK) {
+        size_t len = std::min(KERNEL_CHUNK, high.size() - start);
+        kernels::true_range(high.data() + start - 1, low.data() + start - 1,
+                            close.data() + start - 1, len + 1, true_ranges);
+        
+        for (size_t j = 0; j < len; ++j) {
+            size_t i = start + j;
+            if (i <= p) {
+                // Initial ATR: simple average of the first `period` ranges
+                atr_value += true_ranges[j];
+                if (i == p) {
+                    atr_value /= period;
+                    out[p] = atr_value;
+                }
+            } else {
+                // Wilder's smoothing
+                atr_value = alpha * true_ranges[j] + (1 - alpha) * atr_value;
+                out[i] = atr_value;
+            }
+        }
     }
+}
+
+std::vector<double> atr(
+    std::span<const double> high,
+    std::span<const double> low,
+    std::span<const double> close,
+    int period) {
     
+    std::vector<double> result(close.size());
+    atr(high, low, close, period, result);
     return result;
 }
 
-std::vector<double> momentum(const std::vector<double>& prices, int period) {
-    std::vector<double> result(prices.size(), std::nan(""));
+std::vector<double> atr(const BarSeries& bars, int period) {
+    return atr(bars.high(), bars.low(), bars.close(), period);
+}
+
+void momentum(std::span<const double> prices, int period, std::span<double> out) {
+    fill_nan(out);
     
-    if (prices.size() < static_cast<size_t>(period + 1)) {
-        return result;
+    if (period <= 0 || out.size() != prices.size() ||
+        prices.size() < static_cast<size_t>(period + 1)) {
+        return;
     }
     
-    for (size_t i = period; i < prices.size(); ++i) {
-        if (prices[i - period] != 0.0) {
-            result[i] = (prices[i] - prices[i - period]) / prices[i - period];
-        }
+    kernels::momentum(prices.data(), prices.size(), period, out.data());
+}
+
+std::vector<double> momentum(std::span<const double> prices, int period) {
+    std::vector<double> result(prices.size());
+    momentum(prices, period, result);
+    return result;
+}
+
+void rolling_std(std::span<const double> values, int period, std::span<double> out) {
+    fill_nan(out);
+    
+    if (period <= 0 || out.size() != values.size() ||
+        values.size() < static_cast<size_t>(period)) {
+        return;
     }
     
+    kernels::rolling_mean_std(values.data(), values.size(), period, nullptr,
+                              out.data());
+}
+
+std::vector<double> rolling_std(std::span<const double> values, int period) {
+    std::vector<double> result(values.size());
+    rolling_std(values, period, result);
     return result;
 }
 
-std::vector<double> rolling_std(const std::vector<double>& values, int period) {
-    std::vector<double> result(values.size(), std::nan(""));
+void zscore(std::span<const double> values, int period, std::span<double> out) {
+    fill_nan(out);
     
-    if (values.size() < static_cast<size_t>(period)) {
-        return result;
+    if (period <= 0 || out.size() != values.size() ||
+        values.size() < static_cast<size_t>(period)) {
+        return;
     }
     
-    for (size_t i = period - 1; i < values.size(); ++i) {
-        double sum = 0.0;
-        double sum_sq = 0.0;
-        
-        for (int j = 0; j < period; ++j) {
-            double val = values[i - j];
-            sum += val;
-            sum_sq += val * val;
+    kernels::rolling_zscore(values.data(), values.size(), period, out.data());
+}
+
+std::vector<double> zscore(
+    std::span<const double> values,
+    int period) {
+    
+    std::vector<double> result(values.size());
+    zscore(values, period, result);
+    return result;
+}
+
+// ---------------------------------------------------------
+// FeatureFrame
+// ---------------------------------------------------------
+
+FeatureFrame::FeatureFrame(size_t rows, std::vector<std::string> names)
+    : rows_(rows), stride_((rows + 7) / 8 * 8), names_(std::move(names)),
+      data_(stride_ * names_.size(), std::nan("")) {
+    for (size_t i = 0; i < names_.size(); ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            if (names_[i] == names_[j]) {
+                throw std::invalid_argument("Duplicate feature column: " + names_[i]);
+            }
         }
-        
-        double mean = sum / period;
-        double variance = (sum_sq / period) - (mean * mean);
-        result[i] = std::sqrt(variance);
     }
+}
+
+size_t FeatureFrame::index_of(std::string_view name) const {
+    for (size_t i = 0; i < names_.size(); ++i) {
+        if (names_[i] == name) return i;
+    }
+    throw std::out_of_range("Unknown feature column: " + std::string(name));
+}
+
+std::span<double> FeatureFrame::column(std::string_view name) {
+    return column(index_of(name));
+}
+
+std::span<const double> FeatureFrame::column(std::string_view name) const {
+    return column(index_of(name));
+}
+
+// ---------------------------------------------------------
+// compute_features (pandas semantics, see features.hpp)
+// ---------------------------------------------------------
+
+namespace {
+
+// pandas ewm(alpha=..., adjust=False).mean() over finite x, including its
+// normalisation step; entries before min_periods observations are NaN.
+void ewm(const double* x, size_t n, double alpha, size_t min_periods, double* out) {
+    const double old_wt = 1.0 - alpha;
+    double weighted = x[0];
+    for (size_t i = 0; i < n; ++i) {
+        if (i > 0 && weighted != x[i]) {
+            weighted = (old_wt * weighted + alpha * x[i]) / (old_wt + alpha);
+        }
+        out[i] = i + 1 >= min_periods ? weighted : std::nan("");
+    }
+}
+
+// rolling(period).mean() / .std() (ddof = 1) of x[first, n); entries before
+// the first full window stay NaN. mean_out may be null.
+void rolling_sample_moments(const double* x, size_t n, size_t first, size_t period,
+                            double* mean_out, double* std_out) {
+    if (n < first || n - first < period) return;
+    kernels::rolling_mean_std(x + first, n - first, period,
+                              mean_out ? mean_out + first : nullptr, std_out + first);
     
-    return result;
+    const double to_sample = period > 1 ? std::sqrt(period / (period - 1.0))
+                                        : std::nan("");
+    for (size_t i = first + period - 1; i < n; ++i) {
+        std_out[i] *= to_sample;
+    }
 }
 
-std::vector<double> zscore(
-    const std::vector<double>& values,
-    int period) {
+void rolling_mean_from(const double* x, size_t n, size_t first, size_t period,
+                       double* out) {
+    if (n < first || n - first < period) return;
+    kernels::rolling_mean(x + first, n - first, period, out + first);
+}
+
+// .replace([inf, -inf], nan).ffill()
+void clean_ffill(std::span<double> x, bool zero_is_missing = false) {
+    for (size_t i = 0; i < x.size(); ++i) {
+        bool missing = std::isnan(x[i]) || std::isinf(x[i]) ||
+                       (zero_is_missing && x[i] == 0.0);
+        if (missing) {
+            x[i] = i > 0 ? x[i - 1] : std::nan("");
+        }
+    }
+}
+
+size_t checked_period(int period, const char* name) {
+    if (period <= 0) {
+        throw std::invalid_argument(std::string("FeatureConfig.") + name +
+                                    " must be positive");
+    }
+    return static_cast<size_t>(period);
+}
+
+} // namespace
+
+FeatureFrame compute_features(
+    std::span<const double> open,
+    std::span<const double> high,
+    std::span<const double> low,
+    std::span<const double> close,
+    std::span<const double> volume,
+    const FeatureConfig& config) {
+    
+    const size_t n = close.size();
+    if (open.size() != n || high.size() != n || low.size() != n || volume.size() != n) {
+        throw std::invalid_argument("compute_features: columns differ in length");
+    }
     
-    std::vector<double> result(values.size(), std::nan(""));
+    const size_t vol_short = checked_period(config.vol_short, "vol_short");
+    const size_t vol_long = checked_period(config.vol_long, "vol_long");
+    const size_t sma_short = checked_period(config.sma_short, "sma_short");
+    const size_t sma_long = checked_period(config.sma_long, "sma_long");
+    const size_t rsi_period = checked_period(config.rsi_period, "rsi_period");
+    checked_period(config.macd_fast, "macd_fast");
+    checked_period(config.macd_slow, "macd_slow");
+    checked_period(config.macd_signal, "macd_signal");
+    const size_t bb_period = checked_period(config.bb_period, "bb_period");
+    const size_t atr_period = checked_period(config.atr_period, "atr_period");
+    const size_t zscore_period = checked_period(config.zscore_period, "zscore_period");
+    for (int p : config.ema_periods) checked_period(p, "ema_periods");
+    for (int p : config.momentum_periods) checked_period(p, "momentum_periods");
     
-    if (values.size() < static_cast<size_t>(period)) {
-        return result;
+    // Column order = order features.py adds them
+    auto ema_name = [](int p) { return "ema_" + std::to_string(p); };
+    std::vector<std::string> names = {
+        "log_return",
+        "vol_" + std::to_string(vol_short),
+        "vol_" + std::to_string(vol_long),
+        "sma_" + std::to_string(sma_short),
+        "sma_" + std::to_string(sma_long),
+    };
+    for (int p : config.ema_periods) names.push_back(ema_name(p));
+    names.push_back("rsi_" + std::to_string(rsi_period));
+    names.insert(names.end(), {"macd_line", "macd_signal", "macd_histogram"});
+    for (int p : config.momentum_periods) {
+        names.push_back("momentum_" + std::to_string(p));
+        names.push_back("momentum_zscore_" + std::to_string(p));
     }
+    names.insert(names.end(), {"bb_middle", "bb_upper", "bb_lower", "bb_width",
+                               "bb_position"});
+    names.push_back("atr_" + std::to_string(atr_period));
+    names.push_back("zscore_" + std::to_string(zscore_period));
     
-    for (size_t i = period - 1; i < values.size(); ++i) {
-        double sum = 0.0;
-        double sum_sq = 0.0;
-        
-        for (int j = 0; j < period; ++j) {
-            double val = values[i - j];
-            sum += val;
-            sum_sq += val * val;
+    FeatureFrame frame(n, std::move(names));
+    if (n == 0) return frame;
+    const double* c = close.data();
+    
+    // 1. Log returns and rolling volatility (sample std, zeros forward-filled)
+    std::span<double> log_return = frame.column("log_return");
+    for (size_t i = 1; i < n; ++i) {
+        log_return[i] = std::log(c[i] / c[i - 1]);
+    }
+    std::span<double> vol_s = frame.column(size_t{1});
+    std::span<double> vol_l = frame.column(size_t{2});
+    rolling_sample_moments(log_return.data(), n, 1, vol_short, nullptr, vol_s.data());
+    rolling_sample_moments(log_return.data(), n, 1, vol_long, nullptr, vol_l.data());
+    clean_ffill(vol_s, true);
+    clean_ffill(vol_l, true);
+    
+    // 2. Trends & averages
+    rolling_mean_from(c, n, 0, sma_short, frame.column(size_t{3}).data());
+    rolling_mean_from(c, n, 0, sma_long, frame.column(size_t{4}).data());
+    for (int p : config.ema_periods) {
+        ewm(c, n, 2.0 / (p + 1.0), 0, frame.column(ema_name(p)).data());
+    }
+    
+    // 3. RSI: EWM of gains / losses (delta[0] counts as 0)
+    {
+        std::span<double> out = frame.column("rsi_" + std::to_string(rsi_period));
+        const double alpha = 1.0 / rsi_period;
+        const double old_wt = 1.0 - alpha;
+        double avg_gain = 0.0, avg_loss = 0.0;
+        for (size_t i = 1; i < n; ++i) {
+            double delta = c[i] - c[i - 1];
+            double gain = delta > 0 ? delta : 0.0;
+            double loss = delta < 0 ? -delta : 0.0;
+            if (avg_gain != gain) avg_gain = (old_wt * avg_gain + alpha * gain) / (old_wt + alpha);
+            if (avg_loss != loss) avg_loss = (old_wt * avg_loss + alpha * loss) / (old_wt + alpha);
+            if (i + 1 >= rsi_period) {
+                out[i] = 100.0 - (100.0 / (1.0 + avg_gain / avg_loss));
+            }
         }
-        
-        double mean = sum / period;
-        double variance = (sum_sq / period) - (mean * mean);
-        double std_dev = std::sqrt(variance);
-        
-        if (std_dev > 0.0) {
-            result[i] = (values[i] - mean) / std_dev;
+        clean_ffill(out);
+    }
+    
+    // MACD, reusing EMA columns of the same span
+    {
+        std::vector<double> scratch;
+        auto ema_of = [&](int p) -> const double* {
+            for (int q : config.ema_periods) {
+                if (q == p) return frame.column(ema_name(p)).data();
+            }
+            scratch.resize(2 * n);
+            double* out = scratch.data() + (p == config.macd_fast ? 0 : n);
+            ewm(c, n, 2.0 / (p + 1.0), 0, out);
+            return out;
+        };
+        scratch.reserve(2 * n);
+        const double* fast = ema_of(config.macd_fast);
+        const double* slow = ema_of(config.macd_slow);
+        std::span<double> line = frame.column("macd_line");
+        std::span<double> signal = frame.column("macd_signal");
+        std::span<double> hist = frame.column("macd_histogram");
+        for (size_t i = 0; i < n; ++i) {
+            line[i] = fast[i] - slow[i];
+        }
+        ewm(line.data(), n, 2.0 / (config.macd_signal + 1.0), 0, signal.data());
+        for (size_t i = 0; i < n; ++i) {
+            hist[i] = line[i] - signal[i];
         }
     }
     
-    return result;
+    // Momentum (pct_change) and its rolling z-score
+    {
+        std::vector<double> mean(n), std_dev(n);
+        for (int period : config.momentum_periods) {
+            const size_t p = static_cast<size_t>(period);
+            std::span<double> mom = frame.column("momentum_" + std::to_string(p));
+            std::span<double> z = frame.column("momentum_zscore_" + std::to_string(p));
+            for (size_t i = p; i < n; ++i) {
+                mom[i] = c[i] / c[i - p] - 1.0;
+            }
+            rolling_sample_moments(mom.data(), n, p, p, mean.data(), std_dev.data());
+            for (size_t i = 2 * p - 1; i < n; ++i) {
+                z[i] = (mom[i] - mean[i]) / std_dev[i];
+            }
+            clean_ffill(z);
+        }
+    }
+    
+    // 4. Bollinger bands (sample std) and ATR
+    {
+        std::span<double> middle = frame.column("bb_middle");
+        std::span<double> upper = frame.column("bb_upper");
+        std::span<double> lower = frame.column("bb_lower");
+        std::span<double> width = frame.column("bb_width");
+        std::span<double> position = frame.column("bb_position");
+        // bb_upper holds the std until the bands are formed
+        rolling_sample_moments(c, n, 0, bb_period, middle.data(), upper.data());
+        const double k = config.bb_num_std;
+        for (size_t i = bb_period - 1; i < n; ++i) {
+            double band = k * upper[i];
+            upper[i] = middle[i] + band;
+            lower[i] = middle[i] - band;
+            width[i] = (upper[i] - lower[i]) / middle[i];
+            position[i] = (c[i] - middle[i]) / band;
+        }
+    }
+    {
+        std::span<double> out = frame.column("atr_" + std::to_string(atr_period));
+        const double alpha = 1.0 / atr_period;
+        const double old_wt = 1.0 - alpha;
+        double value = high[0] - low[0];
+        for (size_t i = 0; i < n; ++i) {
+            if (i > 0) {
+                double tr = std::max({high[i] - low[i], std::abs(high[i] - c[i - 1]),
+                                      std::abs(low[i] - c[i - 1])});
+                if (value != tr) value = (old_wt * value + alpha * tr) / (old_wt + alpha);
+            }
+            if (i + 1 >= atr_period) out[i] = value;
+        }
+    }
+    
+    // 5. Return z-score: (r - mean(r)) / vol_short
+    {
+        std::span<double> out = frame.column("zscore_" + std::to_string(zscore_period));
+        rolling_mean_from(log_return.data(), n, 1, zscore_period, out.data());
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = (log_return[i] - out[i]) / vol_s[i];
+        }
+        clean_ffill(out);
+    }
+    
+    return frame;
+}
+
+FeatureFrame compute_features(const BarSeries& bars, const FeatureConfig& config) {
+    return compute_features(bars.open(), bars.high(), bars.low(), bars.close(),
+                            bars.volume(), config);
 }
 
 } // namespace quant
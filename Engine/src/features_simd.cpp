@@ -0,0 +1,318 @@
+#include "FeatureKernels.hpp"
+#include "RollingMoments.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <span>
+
+// Per-function target pragmas need GCC or Clang on x86-64; everything else
+// builds the scalar kernels only.
+#if (defined(__GNUC__) || defined(__clang__)) &&                               \
+    (defined(__x86_64__) || defined(__i386__))
+#define QUANT_X86_DISPATCH 1
+#include <immintrin.h>
+#else
+#define QUANT_X86_DISPATCH 0
+#endif
+
+namespace quant {
+
+// ---------------------------------------------------------
+// Scalar kernels (reference / fallback)
+// ---------------------------------------------------------
+namespace scalar {
+
+void true_range(const double* high, const double* low, const double* close,
+                size_t n, double* out) {
+    for (size_t i = 1; i < n; ++i) {
+        double tr1 = high[i] - low[i];
+        double tr2 = std::abs(high[i] - close[i - 1]);
+        double tr3 = std::abs(low[i] - close[i - 1]);
+        out[i - 1] = std::max({tr1, tr2, tr3});
+    }
+}
+
+void gain_loss(const double* prices, size_t n, double* gains, double* losses) {
+    for (size_t i = 1; i < n; ++i) {
+        double change = prices[i] - prices[i - 1];
+        gains[i - 1] = change > 0 ? change : 0.0;
+        losses[i - 1] = change < 0 ? -change : 0.0;
+    }
+}
+
+void momentum(const double* prices, size_t n, size_t period, double* out) {
+    for (size_t i = period; i < n; ++i) {
+        if (prices[i - period] != 0.0) {
+            out[i] = (prices[i] - prices[i - period]) / prices[i - period];
+        }
+    }
+}
+
+void rolling_mean(const double* x, size_t n, size_t period, double* out) {
+    double sum = 0.0;
+    for (size_t i = 0; i < period; ++i) {
+        sum += x[i];
+    }
+    out[period - 1] = sum / period;
+
+    for (size_t i = period; i < n; ++i) {
+        sum = sum - x[i - period] + x[i];
+        out[i] = sum / period;
+    }
+}
+
+// rolling_mean_std, or with z_out set the z-score (x - mean) / std dev
+// (NaN for a zero std dev) in its place.
+void rolling_moments(const double* x, size_t n, size_t period,
+                     double* mean_out, double* std_out, double* z_out) {
+    std::span<const double> values(x, n);
+    RollingMoments moments;
+    for (size_t i = 0; i < period; ++i) {
+        moments.add(x[i]);
+    }
+    auto emit = [&](size_t i) {
+        if (z_out) {
+            double sd = moments.std_dev();
+            z_out[i] = sd > 0.0 ? (x[i] - moments.mean()) / sd : std::nan("");
+            return;
+        }
+        if (mean_out) mean_out[i] = moments.mean();
+        std_out[i] = moments.std_dev();
+    };
+    emit(period - 1);
+
+    for (size_t i = period; i < n; ++i) {
+        moments.replace(x[i - period], x[i]);
+        if (moments.due_for_reanchor()) {
+            moments.reanchor(values.subspan(i + 1 - period, period));
+        }
+        emit(i);
+    }
+}
+
+void rolling_mean_std(const double* x, size_t n, size_t period,
+                      double* mean_out, double* std_out) {
+    rolling_moments(x, n, period, mean_out, std_out, nullptr);
+}
+
+void rolling_zscore(const double* x, size_t n, size_t period, double* out) {
+    rolling_moments(x, n, period, nullptr, nullptr, out);
+}
+
+} // namespace scalar
+
+#if QUANT_X86_DISPATCH
+
+// ---------------------------------------------------------
+// AVX2 (4 x double)
+// ---------------------------------------------------------
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))),            \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+namespace avx2 {
+
+struct S {
+    using V = __m256d;
+    static constexpr size_t W = 4;
+
+    static V load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, V v) { _mm256_storeu_pd(p, v); }
+    static V set1(double x) { return _mm256_set1_pd(x); }
+    static V zero() { return _mm256_setzero_pd(); }
+    static V add(V a, V b) { return _mm256_add_pd(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    static V div(V a, V b) { return _mm256_div_pd(a, b); }
+    static V max(V a, V b) { return _mm256_max_pd(a, b); }
+    static V sqrt(V a) { return _mm256_sqrt_pd(a); }
+    static V abs(V a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+
+    // Lanes where `test` == 0 take `fallback`, others `value`
+    static V unless_zero(V test, V value, V fallback) {
+        V is_zero = _mm256_cmp_pd(test, zero(), _CMP_EQ_OQ);
+        return _mm256_blendv_pd(value, fallback, is_zero);
+    }
+
+    // Inclusive prefix sum: [a, b, c, d] -> [a, a+b, a+b+c, a+b+c+d]
+    static V scan(V x) {
+        V t = _mm256_blend_pd(_mm256_permute4x64_pd(x, _MM_SHUFFLE(2, 1, 0, 0)),
+                              zero(), 0x1);
+        x = add(x, t);
+        return add(x, _mm256_permute2f128_pd(x, x, 0x08));
+    }
+    static V broadcast_last(V x) {
+        return _mm256_permute4x64_pd(x, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    static double first(V x) { return _mm256_cvtsd_f64(x); }
+};
+
+#include "features_simd_body.inc"
+
+} // namespace avx2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+// ---------------------------------------------------------
+// AVX-512F (8 x double)
+// ---------------------------------------------------------
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))),             \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+// GCC 12's avx512fintrin.h trips this on its own _mm512_undefined_pd()
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace avx512 {
+
+struct S {
+    using V = __m512d;
+    static constexpr size_t W = 8;
+
+    static V load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, V v) { _mm512_storeu_pd(p, v); }
+    static V set1(double x) { return _mm512_set1_pd(x); }
+    static V zero() { return _mm512_setzero_pd(); }
+    static V add(V a, V b) { return _mm512_add_pd(a, b); }
+    static V sub(V a, V b) { return _mm512_sub_pd(a, b); }
+    static V mul(V a, V b) { return _mm512_mul_pd(a, b); }
+    static V div(V a, V b) { return _mm512_div_pd(a, b); }
+    static V max(V a, V b) { return _mm512_max_pd(a, b); }
+    static V sqrt(V a) { return _mm512_sqrt_pd(a); }
+    static V abs(V a) { return _mm512_abs_pd(a); }
+
+    static V unless_zero(V test, V value, V fallback) {
+        __mmask8 is_zero = _mm512_cmp_pd_mask(test, zero(), _CMP_EQ_OQ);
+        return _mm512_mask_blend_pd(is_zero, value, fallback);
+    }
+
+    // Shift lanes up by K (lane 0..K-1 <- 0), then add: log2(8) steps
+    template <int K> static V shift_up(V x) {
+        return _mm512_castsi512_pd(_mm512_alignr_epi64(
+            _mm512_castpd_si512(x), _mm512_setzero_si512(), 8 - K));
+    }
+    static V scan(V x) {
+        x = add(x, shift_up<1>(x));
+        x = add(x, shift_up<2>(x));
+        return add(x, shift_up<4>(x));
+    }
+    static V broadcast_last(V x) {
+        return _mm512_permutexvar_pd(_mm512_set1_epi64(7), x);
+    }
+    static double first(V x) { return _mm512_cvtsd_f64(x); }
+};
+
+#include "features_simd_body.inc"
+
+} // namespace avx512
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+
+#endif // QUANT_X86_DISPATCH
+
+// ---------------------------------------------------------
+// Runtime dispatch
+// ---------------------------------------------------------
+namespace {
+
+SimdLevel detect_simd_level() {
+#if QUANT_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return SimdLevel::AVX2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+std::atomic<SimdLevel>& active_level() {
+    static std::atomic<SimdLevel> level{detected_simd_level()};
+    return level;
+}
+
+} // namespace
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX512: return "avx512";
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::Scalar:
+    default: return "scalar";
+    }
+}
+
+SimdLevel detected_simd_level() {
+    static const SimdLevel level = detect_simd_level();
+    return level;
+}
+
+SimdLevel simd_level() {
+    return active_level().load(std::memory_order_relaxed);
+}
+
+void set_simd_level(SimdLevel level) {
+    active_level().store(std::min(level, detected_simd_level()),
+                         std::memory_order_relaxed);
+}
+
+#if QUANT_X86_DISPATCH
+#define QUANT_DISPATCH(fn, ...)                                                \
+    switch (simd_level()) {                                                    \
+    case SimdLevel::AVX512: return avx512::fn(__VA_ARGS__);                    \
+    case SimdLevel::AVX2: return avx2::fn(__VA_ARGS__);                        \
+    default: return scalar::fn(__VA_ARGS__);                                   \
+    }
+#else
+#define QUANT_DISPATCH(fn, ...) return scalar::fn(__VA_ARGS__);
+#endif
+
+namespace kernels {
+
+void true_range(const double* high, const double* low, const double* close,
+                size_t n, double* out) {
+    QUANT_DISPATCH(true_range, high, low, close, n, out)
+}
+
+void gain_loss(const double* prices, size_t n, double* gains, double* losses) {
+    QUANT_DISPATCH(gain_loss, prices, n, gains, losses)
+}
+
+void momentum(const double* prices, size_t n, size_t period, double* out) {
+    QUANT_DISPATCH(momentum, prices, n, period, out)
+}
+
+void rolling_mean(const double* x, size_t n, size_t period, double* out) {
+    QUANT_DISPATCH(rolling_mean, x, n, period, out)
+}
+
+void rolling_mean_std(const double* x, size_t n, size_t period,
+                      double* mean_out, double* std_out) {
+    QUANT_DISPATCH(rolling_mean_std, x, n, period, mean_out, std_out)
+}
+
+void rolling_zscore(const double* x, size_t n, size_t period, double* out) {
+    QUANT_DISPATCH(rolling_zscore, x, n, period, out)
+}
+
+} // namespace kernels
+
+#undef QUANT_DISPATCH
+
+} // namespace quant
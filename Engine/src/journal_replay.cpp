@@ -0,0 +1,131 @@
+#include "EventJournal.hpp"
+#include "Regime.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// Inspect an event journal written by Engine::set_journal
+// (QuantEngineApp --journal run.qj data.csv).
+//
+// Usage:
+//   JournalReplay run.qj            summary and final state
+//   JournalReplay run.qj BAR        state at the end of bar BAR
+//   JournalReplay run.qj FROM TO    every event of bars FROM..TO
+namespace {
+
+void print_state(const quant::JournalState &s) {
+  std::cout << std::fixed << std::setprecision(2)
+            << "Bar:            " << s.bar << " (ts " << s.timestamp << ")\n"
+            << "Signal:         " << s.signal << "\n"
+            << "Regime:         "
+            << quant::regime_name(static_cast<quant::Regime>(s.regime)) << "\n"
+            << "Close:          " << s.close << "\n"
+            << "Equity:         " << s.equity << "\n"
+            << "Cash:           " << s.cash << "\n"
+            << "Position:       " << std::setprecision(4) << s.position
+            << std::setprecision(2) << "\n";
+  if (s.position != 0)
+    std::cout << "Entry Price:    " << s.entry_price << "\n"
+              << "Stop:           " << s.stop << " (initial "
+              << s.initial_stop << ")\n";
+  std::cout << "Working Qty:    " << std::setprecision(4)
+            << s.working_quantity << "\n"
+            << "Orders / Fills: " << s.orders << " / " << s.fills << "\n"
+            << "Trades / Exits: " << s.trades << " / " << s.exits << "\n";
+}
+
+void print_event(const quant::JournalRecord &r) {
+  using quant::JournalEvent;
+  std::cout << std::setw(8) << r.bar << "  " << r.timestamp << "  "
+            << std::left << std::setw(8) << quant::journal_event_name(r.type)
+            << std::right << std::fixed << std::setprecision(4);
+  switch (r.type) {
+  case JournalEvent::Bar:
+    std::cout << " signal " << int(r.side) << "  "
+              << quant::regime_name(static_cast<quant::Regime>(r.flags))
+              << "  close " << r.a << "  equity " << std::setprecision(2)
+              << r.b << "  position " << std::setprecision(4) << r.c;
+    break;
+  case JournalEvent::Order:
+    std::cout << (r.side > 0 ? " BUY " : " SELL ") << r.a;
+    if (static_cast<quant::OrderType>(r.flags) == quant::OrderType::Market)
+      std::cout << " market";
+    else
+      std::cout << (static_cast<quant::OrderType>(r.flags) ==
+                            quant::OrderType::Limit
+                        ? " limit "
+                        : " stop ")
+                << r.b;
+    break;
+  case JournalEvent::Cancel:
+    std::cout << " " << r.a;
+    break;
+  case JournalEvent::Fill:
+    std::cout << (r.side > 0 ? " BUY " : " SELL ") << r.a << " @ " << r.b
+              << "  fee " << r.c;
+    break;
+  case JournalEvent::Stop:
+    std::cout << " " << r.a << " (initial " << r.b << ")";
+    break;
+  case JournalEvent::Exit:
+    std::cout << (r.side > 0 ? " long " : " short ")
+              << quant::exit_reason_name(
+                     static_cast<quant::ExitReason>(r.flags));
+    break;
+  case JournalEvent::Snapshot:
+    break;
+  }
+  std::cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 4) {
+    std::cerr << "Usage: JournalReplay run.qj [bar | from to]" << std::endl;
+    return 1;
+  }
+
+  try {
+    quant::JournalReader reader(argv[1]);
+    if (reader.bars() == 0) {
+      std::cerr << argv[1] << ": no bars" << std::endl;
+      return 1;
+    }
+
+    if (argc == 2) {
+      std::cout << argv[1] << ": " << reader.bars() << " bars, "
+                << reader.records() << " records, " << reader.snapshots()
+                << " snapshots (every " << reader.header().snapshot_every
+                << " bars)" << (reader.has_trailer() ? "" : ", no index")
+                << "\nInitial Capital: " << std::fixed << std::setprecision(2)
+                << reader.header().initial_capital << "\n\n";
+      print_state(*reader.state_at(reader.bars() - 1));
+      return 0;
+    }
+
+    const uint32_t from =
+        static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10));
+    if (argc == 3) {
+      auto state = reader.state_at(from);
+      if (!state) {
+        std::cerr << "Bar " << from << " out of range (0.."
+                  << reader.bars() - 1 << ")" << std::endl;
+        return 1;
+      }
+      print_state(*state);
+      return 0;
+    }
+
+    const uint32_t to =
+        static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10));
+    reader.events(from, to, print_event);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -1,22 +1,197 @@
 #include "Engine.hpp"
+#include "MonteCarlo.hpp"
+#include "MultiSymbolRunner.hpp"
+#include "ParameterSweep.hpp"
+#include "WalkForward.hpp"
+#include <algorithm>
+#include <filesystem>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
 
+// Usage:
+//   QuantEngineApp [data.csv]
+//   QuantEngineApp --trace stages.json data.csv  (QUANT_STAGE_TIMING builds)
+//   QuantEngineApp --journal run.qj data.csv     (event journal, JournalReplay)
+//   QuantEngineApp [--threads N] [--scaling] a.csv b.csv ...   (multi-symbol)
+//   QuantEngineApp [--threads N] data_dir/ ...    (every *.csv, multi-symbol)
+//   QuantEngineApp [--threads N] --batched a.csv b.csv ...  (SoA indicators)
+//   QuantEngineApp [--threads N] --portfolio a.csv b.csv ... (shared capital)
+//   QuantEngineApp [--threads N] --sweep data.csv        (parameter grid)
+//   QuantEngineApp [--threads N] --walk-forward data.csv (train/test windows)
+//   QuantEngineApp [--threads N] --monte-carlo data.csv  (resampled paths)
 int main(int argc, char *argv[]) {
   std::cout << "🚀 QuantEngine C++ Init..." << std::endl;
 
-  quant::Engine engine;
+  std::vector<std::string> data_paths;
+  unsigned threads = quant::ThreadPool::default_threads();
+  bool scaling = false;
+  bool sweep = false;
+  bool walk_forward = false;
+  bool monte_carlo = false;
+  bool batched = false;
+  bool portfolio = false;
+  std::string trace_path;
+  std::string journal_path;
 
-  // Default Data Path (Adjust as needed)
-  std::string data_path = "../../Research/Data/ICICIBANK_5minute.csv";
-  if (argc > 1) {
-    data_path = argv[1];
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      threads = static_cast<unsigned>(std::stoul(argv[++i]));
+    } else if (arg == "--scaling") {
+      scaling = true;
+    } else if (arg == "--sweep") {
+      sweep = true;
+    } else if (arg == "--walk-forward") {
+      walk_forward = true;
+    } else if (arg == "--monte-carlo") {
+      monte_carlo = true;
+    } else if (arg == "--batched") {
+      batched = true;
+    } else if (arg == "--portfolio") {
+      portfolio = true;
+    } else if (arg == "--trace" && i + 1 < argc) {
+      trace_path = argv[++i];
+    } else if (arg == "--journal" && i + 1 < argc) {
+      journal_path = argv[++i];
+    } else if (std::filesystem::is_directory(arg)) {
+      for (const auto &[symbol, path] :
+           quant::MarketDataManager::list_csv_files(arg))
+        data_paths.push_back(path);
+    } else {
+      data_paths.push_back(arg);
+    }
   }
 
-  std::cout << "📂 Loading Data: " << data_path << std::endl;
-  engine.load_data("ICICIBANK", data_path);
+  if (sweep) {
+    if (data_paths.empty()) {
+      std::cerr << "--sweep needs a data file" << std::endl;
+      return 1;
+    }
+    quant::MarketDataManager market_data;
+    std::cout << "📂 Loading Data: " << data_paths[0] << std::endl;
+    if (!market_data.load_csv("SWEEP", data_paths[0]))
+      return 1;
 
-  engine.run();
+    quant::ParameterGrid grid;
+    grid.add("bb_period", {50, 100, 150})
+        .add("mr_bb_threshold", {0.6, 0.8, 1.0})
+        .add("momentum_entry_threshold", {1.0, 1.5, 2.0})
+        .add("trend_threshold", {0.003, 0.005});
+
+    quant::ParameterSweep sweeper(market_data.get_bars("SWEEP"));
+    quant::SweepReport report = sweeper.run(grid, threads);
+    quant::ParameterSweep::print(report, grid);
+    return 0;
+  }
+
+  if (walk_forward) {
+    if (data_paths.empty()) {
+      std::cerr << "--walk-forward needs a data file" << std::endl;
+      return 1;
+    }
+    quant::MarketDataManager market_data;
+    std::cout << "📂 Loading Data: " << data_paths[0] << std::endl;
+    if (!market_data.load_csv("WALK", data_paths[0]))
+      return 1;
+
+    // ~80 sessions of 1-min bars to train, ~40 to test, rolling
+    quant::WalkForwardConfig config;
+    config.train_bars = 30000;
+    config.test_bars = 15000;
+
+    quant::WalkForward walk(market_data.get_bars("WALK"), config);
+    quant::WalkForward::print(walk.run({}, threads));
+    return 0;
+  }
+
+  if (monte_carlo) {
+    if (data_paths.empty()) {
+      std::cerr << "--monte-carlo needs a data file" << std::endl;
+      return 1;
+    }
+    quant::Engine engine;
+    std::cout << "📂 Loading Data: " << data_paths[0] << std::endl;
+    engine.load_data("MC", data_paths[0]);
+    engine.set_record_equity(true);
+    quant::BacktestResult run = engine.run_backtest("MC");
+    if (run.bars_processed == 0)
+      return 1;
+    quant::print_report(run.report);
+
+    const std::vector<double> pnl = quant::trade_pnls(run.trades);
+    const std::vector<double> returns =
+        quant::bar_returns(run.equity_curve.equity());
+    quant::MonteCarloConfig config;
+    quant::MonteCarlo trades(config);
+    config.block_length = 375; // One NSE session of 1-min bars
+    quant::MonteCarlo bars(config);
+    const double capital = engine.initial_capital();
+    quant::MonteCarlo::print(
+        trades.run(quant::Resampling::TradeShuffle, pnl, capital, threads));
+    quant::MonteCarlo::print(
+        trades.run(quant::Resampling::TradeBootstrap, pnl, capital, threads));
+    quant::MonteCarlo::print(bars.run(quant::Resampling::ReturnBootstrap,
+                                      returns, capital, threads));
+    return 0;
+  }
+
+  if (data_paths.size() <= 1 && !scaling && !batched && !portfolio) {
+    quant::Engine engine;
+
+    // Default Data Path (Adjust as needed)
+    std::string data_path = "../../Research/Data/ICICIBANK_5minute.csv";
+    if (!data_paths.empty()) {
+      data_path = data_paths[0];
+    }
+
+    std::cout << "📂 Loading Data: " << data_path << std::endl;
+    engine.load_data("ICICIBANK", data_path);
+
+    if (!trace_path.empty()) {
+      if (quant::STAGE_TIMING)
+        engine.set_stage_trace(trace_path);
+      else
+        std::cerr << "--trace needs a -DQUANT_STAGE_TIMING=ON build"
+                  << std::endl;
+    }
+    if (!journal_path.empty())
+      engine.set_journal(journal_path);
+    engine.run();
+    return 0;
+  }
+
+  // Multi-symbol mode: one shared data store (files parsed in parallel),
+  // one Engine per symbol/task.
+  auto market_data = std::make_shared<quant::MarketDataManager>();
+  std::vector<std::pair<std::string, std::string>> files;
+  for (const auto &path : data_paths) {
+    std::cout << "📂 Loading Data: " << path << std::endl;
+    files.emplace_back(std::filesystem::path(path).stem().string(), path);
+  }
+  market_data->load_files(files, threads);
+  std::vector<std::string> symbols;
+  for (const auto &[symbol, path] : files) {
+    if (!market_data->get_bars(symbol).empty() &&
+        std::find(symbols.begin(), symbols.end(), symbol) == symbols.end())
+      symbols.push_back(symbol);
+  }
+  if (symbols.empty()) {
+    std::cerr << "No data loaded!" << std::endl;
+    return 1;
+  }
+
+  quant::MultiSymbolRunner runner(market_data, symbols);
+  quant::MultiSymbolResult result =
+      portfolio ? runner.run_portfolio(quant::PortfolioConfig{}, threads)
+      : batched ? runner.run_batched(threads)
+                : runner.run(threads);
+  quant::MultiSymbolRunner::print_summary(result, symbols);
+
+  if (scaling) {
+    quant::MultiSymbolRunner::print_scaling(runner.scaling_report(threads));
+  }
 
   return 0;
 }